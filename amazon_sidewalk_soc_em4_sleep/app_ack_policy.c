@@ -0,0 +1,295 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_ack_policy.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include "app_ack_policy.h"
+#include "app_retained.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Retained word per link: the outcomes, newest in bit 0 and a failure set,
+// how many of them are known, the health of the link and the uplinks sent
+// without ack since the last probe
+#define STATE_WINDOW_MASK       ((1UL << APP_ACK_POLICY_WINDOW) - 1UL)
+#define STATE_COUNT_SHIFT       (16U)
+#define STATE_COUNT_MASK        (0x1FUL)
+#define STATE_HEALTHY           (1UL << 21)
+#define STATE_PROBE_SHIFT       (22U)
+#define STATE_PROBE_MASK        (0xFUL)
+
+_Static_assert(APP_ACK_POLICY_WINDOW <= STATE_COUNT_SHIFT, "window does not fit the retained word");
+_Static_assert(APP_ACK_POLICY_HEALTHY_RUN <= APP_ACK_POLICY_WINDOW, "healthy run longer than the window");
+_Static_assert(APP_ACK_POLICY_PROBE_EVERY >= 1U && APP_ACK_POLICY_PROBE_EVERY <= STATE_PROBE_MASK + 1U, "probe period does not fit the retained word");
+
+typedef enum {
+  ACK_POLICY_LINK_BLE = 0,
+  ACK_POLICY_LINK_FSK,
+  ACK_POLICY_LINK_CSS,
+  ACK_POLICY_LINK_COUNT
+} ack_policy_link_t;
+
+_Static_assert(APP_RETAINED_SLOT_ACK_POLICY_LAST - APP_RETAINED_SLOT_ACK_POLICY + 1 == ACK_POLICY_LINK_COUNT, "one retained word per link");
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to get the history index of a link
+ *
+ * @param[in] link Link type
+ * @param[out] index History index
+ *
+ * @returns #false for an unknown link
+ ******************************************************************************/
+static bool link_index(uint32_t link, ack_policy_link_t *index);
+
+/*******************************************************************************
+ * Function to get the retained word of a link
+ *
+ * @param[in] index History index
+ *
+ * @returns State word
+ ******************************************************************************/
+static uint32_t get_state(ack_policy_link_t index);
+
+/*******************************************************************************
+ * Function to store the retained word of a link
+ *
+ * @param[in] index History index
+ * @param[in] state State word
+ ******************************************************************************/
+static void set_state(ack_policy_link_t index, uint32_t state);
+
+/*******************************************************************************
+ * Function to add an outcome to the history of a link
+ *
+ * @param[in] state State word
+ * @param[in] failed #true for a failure
+ *
+ * @returns New state word
+ ******************************************************************************/
+static uint32_t add_outcome(uint32_t state, bool failed);
+
+// -----------------------------------------------------------------------------
+//                                Global Variables
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+static app_ack_policy_stats_t stats[ACK_POLICY_LINK_COUNT];
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+void app_ack_policy_init(void)
+{
+  for (uint32_t i = 0; i < ACK_POLICY_LINK_COUNT; i++) {
+    uint32_t state = get_state((ack_policy_link_t)i);
+    if (((state >> STATE_COUNT_SHIFT) & STATE_COUNT_MASK) > APP_ACK_POLICY_WINDOW) {
+      // Window changed by a firmware update
+      set_state((ack_policy_link_t)i, 0U);
+    }
+    stats[i] = (app_ack_policy_stats_t){ 0 };
+  }
+}
+
+app_ack_policy_mode_t app_ack_policy_apply(uint32_t link, bool critical, struct sid_msg_desc *desc)
+{
+  ack_policy_link_t index;
+  app_ack_policy_mode_t mode = APP_ACK_POLICY_ACKED;
+
+  if (link_index(link, &index) && !critical) {
+    uint32_t state = get_state(index);
+    if ((state & STATE_HEALTHY) != 0) {
+      uint32_t since_probe = ((state >> STATE_PROBE_SHIFT) & STATE_PROBE_MASK) + 1U;
+      if (since_probe >= APP_ACK_POLICY_PROBE_EVERY) {
+        mode = APP_ACK_POLICY_PROBE;
+        since_probe = 0U;
+      } else {
+        mode = APP_ACK_POLICY_NONE;
+      }
+      state &= ~(STATE_PROBE_MASK << STATE_PROBE_SHIFT);
+      set_state(index, state | (since_probe << STATE_PROBE_SHIFT));
+    }
+  }
+
+  switch (mode) {
+    case APP_ACK_POLICY_NONE:
+      desc->msg_desc_attr.tx_attr.request_ack = false;
+      desc->msg_desc_attr.tx_attr.num_retries = 0U;
+      break;
+    case APP_ACK_POLICY_PROBE:
+      desc->msg_desc_attr.tx_attr.request_ack = true;
+      desc->msg_desc_attr.tx_attr.num_retries = APP_ACK_POLICY_PROBE_RETRIES;
+      break;
+    default:
+      desc->msg_desc_attr.tx_attr.request_ack = true;
+      desc->msg_desc_attr.tx_attr.num_retries = APP_ACK_POLICY_RETRIES;
+      break;
+  }
+
+  if (link_index(link, &index)) {
+    if (mode == APP_ACK_POLICY_NONE) {
+      stats[index].unacked++;
+    } else if (mode == APP_ACK_POLICY_PROBE) {
+      stats[index].probes++;
+    } else {
+      stats[index].acked++;
+    }
+  }
+  return mode;
+}
+
+bool app_ack_policy_on_msg_sent(const struct sid_msg_desc *desc)
+{
+  ack_policy_link_t index;
+
+  // Without ack the stack only knows the uplink went on air
+  if (!link_index((uint32_t)desc->link_type, &index) || !desc->msg_desc_attr.tx_attr.request_ack) {
+    return false;
+  }
+  stats[index].delivered++;
+
+  uint32_t state = add_outcome(get_state(index), false);
+  uint32_t run_mask = (1UL << APP_ACK_POLICY_HEALTHY_RUN) - 1UL;
+  // Retries hide the loss of a degraded link, the failures seen before the
+  // switch have to leave the window too
+  bool recovered = (state & STATE_HEALTHY) == 0
+                   && ((state >> STATE_COUNT_SHIFT) & STATE_COUNT_MASK) >= APP_ACK_POLICY_HEALTHY_RUN
+                   && (state & run_mask) == 0
+                   && (uint32_t)__builtin_popcount(state & STATE_WINDOW_MASK) < APP_ACK_POLICY_DEGRADED_FAILS;
+  if (recovered) {
+    state |= STATE_HEALTHY;
+    state &= ~(STATE_PROBE_MASK << STATE_PROBE_SHIFT);
+    stats[index].recovered++;
+  }
+  set_state(index, state);
+  return recovered;
+}
+
+bool app_ack_policy_on_send_error(const struct sid_msg_desc *desc)
+{
+  ack_policy_link_t index;
+
+  if (!link_index((uint32_t)desc->link_type, &index)) {
+    return false;
+  }
+  stats[index].failed++;
+
+  uint32_t state = add_outcome(get_state(index), true);
+  bool degraded = (state & STATE_HEALTHY) != 0
+                  && (uint32_t)__builtin_popcount(state & STATE_WINDOW_MASK) >= APP_ACK_POLICY_DEGRADED_FAILS;
+  if (degraded) {
+    state &= ~STATE_HEALTHY;
+    stats[index].degraded++;
+  }
+  set_state(index, state);
+  return degraded;
+}
+
+bool app_ack_policy_is_degraded(uint32_t link)
+{
+  ack_policy_link_t index;
+
+  return !link_index(link, &index) || (get_state(index) & STATE_HEALTHY) == 0;
+}
+
+uint32_t app_ack_policy_get_failures(uint32_t link, uint32_t *outcomes)
+{
+  ack_policy_link_t index;
+
+  *outcomes = 0U;
+  if (!link_index(link, &index)) {
+    return 0U;
+  }
+  uint32_t state = get_state(index);
+  *outcomes = (state >> STATE_COUNT_SHIFT) & STATE_COUNT_MASK;
+  return (uint32_t)__builtin_popcount(state & STATE_WINDOW_MASK);
+}
+
+const app_ack_policy_stats_t *app_ack_policy_get_stats(uint32_t link)
+{
+  static const app_ack_policy_stats_t none = { 0 };
+  ack_policy_link_t index;
+
+  if (!link_index(link, &index)) {
+    return &none;
+  }
+  return &stats[index];
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+static bool link_index(uint32_t link, ack_policy_link_t *index)
+{
+  switch (link) {
+    case SID_LINK_TYPE_1:
+      *index = ACK_POLICY_LINK_BLE;
+      return true;
+    case SID_LINK_TYPE_2:
+      *index = ACK_POLICY_LINK_FSK;
+      return true;
+    case SID_LINK_TYPE_3:
+      *index = ACK_POLICY_LINK_CSS;
+      return true;
+    default:
+      return false;
+  }
+}
+
+static uint32_t get_state(ack_policy_link_t index)
+{
+  return app_retained_get((app_retained_slot_t)(APP_RETAINED_SLOT_ACK_POLICY + index));
+}
+
+static void set_state(ack_policy_link_t index, uint32_t state)
+{
+  app_retained_set((app_retained_slot_t)(APP_RETAINED_SLOT_ACK_POLICY + index), state);
+}
+
+static uint32_t add_outcome(uint32_t state, bool failed)
+{
+  uint32_t window = ((state << 1) | (failed ? 1UL : 0UL)) & STATE_WINDOW_MASK;
+  uint32_t count = (state >> STATE_COUNT_SHIFT) & STATE_COUNT_MASK;
+
+  if (count < APP_ACK_POLICY_WINDOW) {
+    count++;
+  }
+  state &= ~(STATE_WINDOW_MASK | (STATE_COUNT_MASK << STATE_COUNT_SHIFT));
+  return state | window | (count << STATE_COUNT_SHIFT);
+}
@@ -0,0 +1,161 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_ack_policy.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+#ifndef APP_ACK_POLICY_H
+#define APP_ACK_POLICY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sid_api.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Delivery outcomes remembered per link
+#define APP_ACK_POLICY_WINDOW           (16U)
+// Acks are requested once this many of the remembered uplinks failed...
+#ifndef APP_ACK_POLICY_DEGRADED_FAILS
+#define APP_ACK_POLICY_DEGRADED_FAILS   (2U)
+#endif
+// ...and dropped again after this many acked uplinks in a row got through,
+// with fewer failures than that left in the window
+#ifndef APP_ACK_POLICY_HEALTHY_RUN
+#define APP_ACK_POLICY_HEALTHY_RUN      (8U)
+#endif
+// A healthy link still gets one acked uplink in this many to keep measuring it
+#ifndef APP_ACK_POLICY_PROBE_EVERY
+#define APP_ACK_POLICY_PROBE_EVERY      (4U)
+#endif
+// Retries of an acked uplink by the stack on a degraded link. Probes are not
+// retried, each one samples the loss of the link.
+#define APP_ACK_POLICY_RETRIES          (3U)
+#define APP_ACK_POLICY_PROBE_RETRIES    (0U)
+
+typedef enum {
+  APP_ACK_POLICY_NONE = 0,      // No ack, sent only means transmitted
+  APP_ACK_POLICY_PROBE,         // Acked to measure a healthy link
+  APP_ACK_POLICY_ACKED,         // Acked with retries, degraded link or alarm
+} app_ack_policy_mode_t;
+
+typedef struct {
+  uint32_t unacked;           // Uplinks sent without ack since boot
+  uint32_t probes;            // Acked uplinks on a healthy link
+  uint32_t acked;             // Acked uplinks on a degraded link or alarms
+  uint32_t delivered;         // Acked uplinks confirmed by the network
+  uint32_t failed;            // Send errors
+  uint32_t degraded;          // Switches to acked uplinks
+  uint32_t recovered;         // Switches back to uplinks without ack
+} app_ack_policy_stats_t;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to restore the delivery history of each link
+ *
+ * The history is kept in retained memory to hold across EM4, must be called
+ * after app_retained_init(). Links start degraded after a power-on, with
+ * acks, until they prove healthy.
+ ******************************************************************************/
+void app_ack_policy_init(void);
+
+/*******************************************************************************
+ * Function to set the ack and retry attributes of an uplink
+ *
+ * @param[in] link Link the uplink goes out on
+ * @param[in] critical #true to always request an ack with retries
+ * @param[in,out] desc Message descriptor, tx_attr.request_ack and
+ *                     tx_attr.num_retries are set
+ *
+ * @returns Mode picked for the uplink
+ ******************************************************************************/
+app_ack_policy_mode_t app_ack_policy_apply(uint32_t link, bool critical, struct sid_msg_desc *desc);
+
+/*******************************************************************************
+ * Function to count a sent uplink, an acked one is a confirmed delivery
+ *
+ * @param[in] desc Message descriptor of the sent callback
+ *
+ * @returns #true if the link turned healthy
+ ******************************************************************************/
+bool app_ack_policy_on_msg_sent(const struct sid_msg_desc *desc);
+
+/*******************************************************************************
+ * Function to count a failed uplink
+ *
+ * @param[in] desc Message descriptor of the send error callback
+ *
+ * @returns #true if the link turned degraded
+ ******************************************************************************/
+bool app_ack_policy_on_send_error(const struct sid_msg_desc *desc);
+
+/*******************************************************************************
+ * Function to check if a link gets acked uplinks
+ *
+ * @param[in] link Link type
+ *
+ * @returns #true while the link is degraded
+ ******************************************************************************/
+bool app_ack_policy_is_degraded(uint32_t link);
+
+/*******************************************************************************
+ * Function to get the failures among the remembered outcomes of a link
+ *
+ * @param[in] link Link type
+ * @param[out] outcomes Outcomes remembered, up to APP_ACK_POLICY_WINDOW
+ *
+ * @returns Failures
+ ******************************************************************************/
+uint32_t app_ack_policy_get_failures(uint32_t link, uint32_t *outcomes);
+
+/*******************************************************************************
+ * Function to get the counters of a link since boot
+ *
+ * @param[in] link Link type
+ *
+ * @returns Counters, zeroed for an unknown link
+ ******************************************************************************/
+const app_ack_policy_stats_t *app_ack_policy_get_stats(uint32_t link);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_ACK_POLICY_H
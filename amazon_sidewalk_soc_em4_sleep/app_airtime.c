@@ -0,0 +1,262 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_airtime.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include "sid_api.h"
+#include "app_airtime.h"
+#include "app_retained.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+#define AIRTIME_HOUR_MS         (3600000UL)
+#define AIRTIME_BUDGET_US       (APP_AIRTIME_BUDGET_MS_PER_HOUR * 1000UL)
+
+// Sub-GHz links with a budget
+typedef enum {
+  AIRTIME_BUCKET_FSK = 0,
+  AIRTIME_BUCKET_CSS,
+  AIRTIME_BUCKET_COUNT
+} airtime_bucket_t;
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to get the retained word holding the airtime used on a link
+ *
+ * @param[in] link Link type
+ * @param[out] slot Retained word
+ *
+ * @returns #false if the link has no budget
+ ******************************************************************************/
+static bool bucket_slot(uint32_t link, app_retained_slot_t *slot);
+
+/*******************************************************************************
+ * Function to give back the budget earned since the last update
+ ******************************************************************************/
+static void refill(void);
+
+/*******************************************************************************
+ * Function to estimate the airtime of a single frame
+ *
+ * @param[in] link Link type
+ * @param[in] size Frame payload size
+ *
+ * @returns Airtime in us
+ ******************************************************************************/
+static uint32_t frame_airtime_us(uint32_t link, size_t size);
+
+// -----------------------------------------------------------------------------
+//                                Global Variables
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+static app_airtime_stats_t stats_ble;
+static app_airtime_stats_t stats_fsk;
+static app_airtime_stats_t stats_css;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+void app_airtime_init(void)
+{
+  // Zeroed retained words after a power-on mean a full budget
+  if (app_retained_get(APP_RETAINED_SLOT_AIRTIME_TIME_MS) == 0) {
+    app_retained_set(APP_RETAINED_SLOT_AIRTIME_TIME_MS, app_retained_now_ms());
+  }
+  refill();
+}
+
+uint32_t app_airtime_estimate_us(uint32_t link, size_t size, size_t mtu)
+{
+  if (mtu <= 1U || size <= mtu) {
+    return frame_airtime_us(link, size);
+  }
+
+  // Segments carry a one byte header, see app_segment.c
+  size_t chunk = mtu - 1U;
+  size_t full_frames = (size - 1U) / chunk;
+  size_t last = size - (full_frames * chunk);
+
+  return ((uint32_t)full_frames * frame_airtime_us(link, mtu)) + frame_airtime_us(link, last + 1U);
+}
+
+uint32_t app_airtime_wait_ms(uint32_t link, uint32_t airtime_us)
+{
+  app_retained_slot_t slot;
+
+  if (!bucket_slot(link, &slot)) {
+    return 0;
+  }
+  refill();
+
+  uint32_t used = app_retained_get(slot);
+  if (airtime_us > AIRTIME_BUDGET_US) {
+    // Never fits, let it go once the bucket is full
+    airtime_us = AIRTIME_BUDGET_US;
+  }
+  if (used + airtime_us <= AIRTIME_BUDGET_US) {
+    return 0;
+  }
+
+  uint64_t missing_us = (uint64_t)used + airtime_us - AIRTIME_BUDGET_US;
+  return (uint32_t)(((missing_us * AIRTIME_HOUR_MS) + AIRTIME_BUDGET_US - 1U) / AIRTIME_BUDGET_US);
+}
+
+void app_airtime_charge(uint32_t link, uint32_t airtime_us)
+{
+  app_retained_slot_t slot;
+  app_airtime_stats_t *stats = (app_airtime_stats_t *)app_airtime_get_stats(link);
+
+  if (stats != NULL) {
+    stats->sent++;
+    stats->airtime_ms += (airtime_us + 500U) / 1000U;
+  }
+  if (bucket_slot(link, &slot)) {
+    refill();
+    uint32_t used = app_retained_get(slot) + airtime_us;
+    app_retained_set(slot, (used > AIRTIME_BUDGET_US) ? AIRTIME_BUDGET_US : used);
+  }
+}
+
+void app_airtime_count_deferral(uint32_t link, bool merged)
+{
+  app_airtime_stats_t *stats = (app_airtime_stats_t *)app_airtime_get_stats(link);
+
+  if (stats == NULL) {
+    return;
+  }
+  if (merged) {
+    stats->merged++;
+  } else {
+    stats->deferred++;
+  }
+}
+
+const app_airtime_stats_t *app_airtime_get_stats(uint32_t link)
+{
+  switch (link) {
+    case SID_LINK_TYPE_1:
+      return &stats_ble;
+    case SID_LINK_TYPE_2:
+      return &stats_fsk;
+    case SID_LINK_TYPE_3:
+      return &stats_css;
+    default:
+      return NULL;
+  }
+}
+
+uint32_t app_airtime_get_left_ms(uint32_t link)
+{
+  app_retained_slot_t slot;
+
+  if (!bucket_slot(link, &slot)) {
+    return UINT32_MAX;
+  }
+  refill();
+  return (AIRTIME_BUDGET_US - app_retained_get(slot)) / 1000U;
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+static bool bucket_slot(uint32_t link, app_retained_slot_t *slot)
+{
+  switch (link) {
+    case SID_LINK_TYPE_2:
+      *slot = APP_RETAINED_SLOT_AIRTIME_FSK_US;
+      return true;
+    case SID_LINK_TYPE_3:
+      *slot = APP_RETAINED_SLOT_AIRTIME_CSS_US;
+      return true;
+    default:
+      return false;
+  }
+}
+
+static void refill(void)
+{
+  uint32_t now_ms = app_retained_now_ms();
+  uint32_t elapsed_ms = now_ms - app_retained_get(APP_RETAINED_SLOT_AIRTIME_TIME_MS);
+  uint64_t earned_us = ((uint64_t)elapsed_ms * AIRTIME_BUDGET_US) / AIRTIME_HOUR_MS;
+
+  if (earned_us == 0) {
+    // Keep the elapsed time for the next call
+    return;
+  }
+  app_retained_set(APP_RETAINED_SLOT_AIRTIME_TIME_MS, now_ms);
+
+  const app_retained_slot_t slots[AIRTIME_BUCKET_COUNT] = {
+    [AIRTIME_BUCKET_FSK] = APP_RETAINED_SLOT_AIRTIME_FSK_US,
+    [AIRTIME_BUCKET_CSS] = APP_RETAINED_SLOT_AIRTIME_CSS_US,
+  };
+  for (uint32_t i = 0; i < AIRTIME_BUCKET_COUNT; i++) {
+    uint32_t used = app_retained_get(slots[i]);
+    app_retained_set(slots[i], (earned_us >= used) ? 0U : (used - (uint32_t)earned_us));
+  }
+}
+
+static uint32_t frame_airtime_us(uint32_t link, size_t size)
+{
+  switch (link) {
+    case SID_LINK_TYPE_2:
+      return (uint32_t)((((uint64_t)size + APP_AIRTIME_FSK_OVERHEAD_BYTES) * 8U * 1000000U)
+                        / APP_AIRTIME_FSK_BITRATE);
+
+    case SID_LINK_TYPE_3:
+    {
+      // LoRa time on air, low data rate optimization off at this symbol time
+      const uint32_t symbol_us = (uint32_t)(((1ULL << APP_AIRTIME_CSS_SF) * 1000000U) / APP_AIRTIME_CSS_BW_HZ);
+      int32_t bits = (int32_t)(8U * (size + APP_AIRTIME_CSS_OVERHEAD_BYTES))
+                     - (int32_t)(4U * APP_AIRTIME_CSS_SF) + 28 + 16;
+      uint32_t payload_symbols = 8U;
+      if (bits > 0) {
+        uint32_t blocks = ((uint32_t)bits + (4U * APP_AIRTIME_CSS_SF) - 1U) / (4U * APP_AIRTIME_CSS_SF);
+        payload_symbols += blocks * (APP_AIRTIME_CSS_CR + 4U);
+      }
+      // Preamble is followed by 4.25 symbols of sync
+      return ((((4U * APP_AIRTIME_CSS_PREAMBLE_SYMB) + 17U) * symbol_us) / 4U)
+             + (payload_symbols * symbol_us);
+    }
+
+    default:
+      return (uint32_t)((((uint64_t)size + APP_AIRTIME_BLE_OVERHEAD_BYTES) * 8U * 1000000U)
+                        / APP_AIRTIME_BLE_BITRATE);
+  }
+}
@@ -0,0 +1,146 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_airtime.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef APP_AIRTIME_H
+#define APP_AIRTIME_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Airtime allowed per hour on each sub-GHz link, 36 s is a 1 % duty cycle.
+// The bucket holds one hour of budget, so a burst may use it all at once.
+#ifndef APP_AIRTIME_BUDGET_MS_PER_HOUR
+#define APP_AIRTIME_BUDGET_MS_PER_HOUR  (36000UL)
+#endif
+
+// FSK frame: 50 kbps, preamble, sync word, PHR, Sidewalk header, MIC and CRC
+#define APP_AIRTIME_FSK_BITRATE         (50000UL)
+#define APP_AIRTIME_FSK_OVERHEAD_BYTES  (44UL)
+// CSS frame: LoRa SF11, 500 kHz, coding rate 4/5, explicit header, CRC on
+#define APP_AIRTIME_CSS_SF              (11UL)
+#define APP_AIRTIME_CSS_BW_HZ           (500000UL)
+#define APP_AIRTIME_CSS_CR              (1UL)
+#define APP_AIRTIME_CSS_PREAMBLE_SYMB   (8UL)
+#define APP_AIRTIME_CSS_OVERHEAD_BYTES  (24UL)
+// BLE frame: 1 Mbps, not budgeted
+#define APP_AIRTIME_BLE_BITRATE         (1000000UL)
+#define APP_AIRTIME_BLE_OVERHEAD_BYTES  (30UL)
+
+typedef struct {
+  uint32_t sent;              // Uplinks charged to the link
+  uint32_t airtime_ms;        // Airtime charged to the link
+  uint32_t deferred;          // Uplinks delayed because the budget was used up
+  uint32_t merged;            // Uplinks folded into an already deferred one
+} app_airtime_stats_t;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to restore the budget of the sub-GHz links
+ *
+ * The budget is kept in retained memory to hold across EM4, must be called
+ * after app_retained_init().
+ ******************************************************************************/
+void app_airtime_init(void);
+
+/*******************************************************************************
+ * Function to estimate the airtime of an uplink
+ *
+ * @param[in] link Link type, SID_LINK_TYPE_x
+ * @param[in] size Payload size
+ * @param[in] mtu MTU of the link, payloads above it are sent as segments
+ *
+ * @returns Airtime in us
+ ******************************************************************************/
+uint32_t app_airtime_estimate_us(uint32_t link, size_t size, size_t mtu);
+
+/*******************************************************************************
+ * Function to check an uplink against the budget of its link
+ *
+ * @param[in] link Link type, SID_LINK_TYPE_x
+ * @param[in] airtime_us Airtime of the uplink
+ *
+ * @returns 0 if the uplink may be sent now, otherwise the delay in ms after
+ *          which the budget allows it
+ ******************************************************************************/
+uint32_t app_airtime_wait_ms(uint32_t link, uint32_t airtime_us);
+
+/*******************************************************************************
+ * Function to charge a queued uplink to its link
+ *
+ * @param[in] link Link type, SID_LINK_TYPE_x
+ * @param[in] airtime_us Airtime of the uplink
+ ******************************************************************************/
+void app_airtime_charge(uint32_t link, uint32_t airtime_us);
+
+/*******************************************************************************
+ * Function to count an uplink held back by the budget
+ *
+ * @param[in] link Link type, SID_LINK_TYPE_x
+ * @param[in] merged #true if an uplink was already waiting for the budget
+ ******************************************************************************/
+void app_airtime_count_deferral(uint32_t link, bool merged);
+
+/*******************************************************************************
+ * Function to get the airtime counters of a link
+ *
+ * @param[in] link Link type, SID_LINK_TYPE_x
+ *
+ * @returns Counters since boot, NULL for an unknown link
+ ******************************************************************************/
+const app_airtime_stats_t *app_airtime_get_stats(uint32_t link);
+
+/*******************************************************************************
+ * Function to get the budget left on a link
+ *
+ * @param[in] link Link type, SID_LINK_TYPE_x
+ *
+ * @returns Airtime left in ms, UINT32_MAX for a link without budget
+ ******************************************************************************/
+uint32_t app_airtime_get_left_ms(uint32_t link);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_AIRTIME_H
@@ -0,0 +1,171 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_battery.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include "app_battery.h"
+#include "app_retained.h"
+#include "em4_mode.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Retained word: tier and the lowest supply since power-on, 0 for unset
+#define STATE_TIER_MASK         (0xFFUL)
+#define STATE_LOWEST_SHIFT      (16U)
+#define STATE_LOWEST_MASK       (0xFFFFUL)
+
+_Static_assert(APP_BATTERY_SAVING_MV > APP_BATTERY_LOW_MV + APP_BATTERY_HYSTERESIS_MV
+               && APP_BATTERY_LOW_MV > APP_BATTERY_CRITICAL_MV + APP_BATTERY_HYSTERESIS_MV,
+               "tier thresholds must be further apart than the hysteresis");
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to get the tier of a supply voltage
+ *
+ * @param[in] supply_mv Supply voltage in mV
+ * @param[in] current Tier of the last wake-up
+ *
+ * @returns Tier
+ ******************************************************************************/
+static app_battery_tier_t tier_of(uint16_t supply_mv, app_battery_tier_t current);
+
+// -----------------------------------------------------------------------------
+//                                Global Variables
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+static const uint16_t tier_threshold_mv[APP_BATTERY_TIER_COUNT] = {
+  [APP_BATTERY_TIER_SAVING] = APP_BATTERY_SAVING_MV,
+  [APP_BATTERY_TIER_LOW] = APP_BATTERY_LOW_MV,
+  [APP_BATTERY_TIER_CRITICAL] = APP_BATTERY_CRITICAL_MV,
+};
+
+// Each tier wakes up less often, goes back to EM4 sooner and spends less on
+// each uplink. The scheduled uplinks keep their slot, the tier only skips
+// periods.
+static const app_battery_mode_t modes[APP_BATTERY_TIER_COUNT] = {
+  [APP_BATTERY_TIER_NORMAL] = {
+    .name = "normal",
+    .wakeup_interval_ms = WAKEUP_INTERVAL_MS,
+    .awake_ms = WAKEUP_INTERVAL_MS,
+    .schedule_stride = 1U,
+    .cheapest_link = false,
+    .trace_persist = true,
+  },
+  [APP_BATTERY_TIER_SAVING] = {
+    .name = "saving",
+    .wakeup_interval_ms = 2U * WAKEUP_INTERVAL_MS,
+    .awake_ms = 20000U,
+    .schedule_stride = 2U,
+    .cheapest_link = false,
+    .trace_persist = true,
+  },
+  [APP_BATTERY_TIER_LOW] = {
+    .name = "low",
+    .wakeup_interval_ms = 4U * WAKEUP_INTERVAL_MS,
+    .awake_ms = 15000U,
+    .schedule_stride = 4U,
+    .cheapest_link = true,
+    .trace_persist = false,
+  },
+  [APP_BATTERY_TIER_CRITICAL] = {
+    .name = "critical",
+    .wakeup_interval_ms = 10U * WAKEUP_INTERVAL_MS,
+    .awake_ms = 10000U,
+    .schedule_stride = 8U,
+    .cheapest_link = true,
+    .trace_persist = false,
+  },
+};
+
+static app_battery_tier_t tier;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+bool app_battery_init(uint16_t supply_mv)
+{
+  uint32_t state = app_retained_get(APP_RETAINED_SLOT_BATTERY);
+  app_battery_tier_t last = (app_battery_tier_t)(state & STATE_TIER_MASK);
+  uint32_t lowest_mv = (state >> STATE_LOWEST_SHIFT) & STATE_LOWEST_MASK;
+
+  if (last >= APP_BATTERY_TIER_COUNT) {
+    last = APP_BATTERY_TIER_NORMAL;
+  }
+  tier = tier_of(supply_mv, last);
+  if (lowest_mv == 0 || supply_mv < lowest_mv) {
+    lowest_mv = supply_mv;
+  }
+  app_retained_set(APP_RETAINED_SLOT_BATTERY, ((lowest_mv & STATE_LOWEST_MASK) << STATE_LOWEST_SHIFT) | (uint32_t)tier);
+
+  return tier != last;
+}
+
+app_battery_tier_t app_battery_get_tier(void)
+{
+  return tier;
+}
+
+const app_battery_mode_t *app_battery_get_mode(void)
+{
+  return &modes[tier];
+}
+
+uint16_t app_battery_get_lowest_mv(void)
+{
+  return (uint16_t)((app_retained_get(APP_RETAINED_SLOT_BATTERY) >> STATE_LOWEST_SHIFT) & STATE_LOWEST_MASK);
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+static app_battery_tier_t tier_of(uint16_t supply_mv, app_battery_tier_t current)
+{
+  app_battery_tier_t result = APP_BATTERY_TIER_NORMAL;
+
+  for (uint32_t t = APP_BATTERY_TIER_NORMAL + 1U; t < APP_BATTERY_TIER_COUNT; t++) {
+    // Leaving a tier upwards takes the hysteresis on top of its threshold
+    uint32_t threshold_mv = tier_threshold_mv[t] + ((t <= (uint32_t)current) ? APP_BATTERY_HYSTERESIS_MV : 0U);
+    if (supply_mv < threshold_mv) {
+      result = (app_battery_tier_t)t;
+    }
+  }
+
+  return result;
+}
@@ -0,0 +1,119 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_battery.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef APP_BATTERY_H
+#define APP_BATTERY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Supply below which each tier is entered, measured at each wake-up. A tier is
+// left upwards once the supply is back the hysteresis above its threshold.
+#ifndef APP_BATTERY_SAVING_MV
+#define APP_BATTERY_SAVING_MV       (2700U)
+#endif
+#ifndef APP_BATTERY_LOW_MV
+#define APP_BATTERY_LOW_MV          (2500U)
+#endif
+#ifndef APP_BATTERY_CRITICAL_MV
+#define APP_BATTERY_CRITICAL_MV     (2300U)
+#endif
+#define APP_BATTERY_HYSTERESIS_MV   (100U)
+
+typedef enum {
+  APP_BATTERY_TIER_NORMAL = 0,
+  APP_BATTERY_TIER_SAVING,
+  APP_BATTERY_TIER_LOW,
+  APP_BATTERY_TIER_CRITICAL,
+  APP_BATTERY_TIER_COUNT
+} app_battery_tier_t;
+
+// Operating mode of a tier
+typedef struct {
+  const char *name;
+  uint32_t wakeup_interval_ms;  // EM4 sleep between two wake-ups
+  uint32_t awake_ms;            // Inactivity before EM4
+  uint32_t schedule_stride;     // Scheduled uplink sent every stride periods
+  bool cheapest_link;           // Normal uplinks on the cheapest link rather than the preferred one
+  bool trace_persist;           // Trace written to NVM3 on each EM4 entry
+} app_battery_mode_t;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to pick the tier from the supply measured at this wake-up
+ *
+ * The tier is kept in retained memory for the hysteresis to hold across EM4,
+ * must be called after app_retained_init().
+ *
+ * @param[in] supply_mv Supply voltage in mV, see app_supply_measure_mv()
+ *
+ * @returns #true if the tier changed since the last wake-up
+ ******************************************************************************/
+bool app_battery_init(uint16_t supply_mv);
+
+/*******************************************************************************
+ * Function to get the tier of this wake-up
+ *
+ * @returns Tier
+ ******************************************************************************/
+app_battery_tier_t app_battery_get_tier(void);
+
+/*******************************************************************************
+ * Function to get the operating mode of this wake-up
+ *
+ * @returns Mode of the current tier
+ ******************************************************************************/
+const app_battery_mode_t *app_battery_get_mode(void);
+
+/*******************************************************************************
+ * Function to get the lowest supply measured since power-on
+ *
+ * @returns Supply voltage in mV
+ ******************************************************************************/
+uint16_t app_battery_get_lowest_mv(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_BATTERY_H
@@ -0,0 +1,300 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_bench.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "app_bench.h"
+#include "app_link_router.h"
+#include "sl_sidewalk_log_app.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+typedef struct {
+  uint16_t id;
+  uint32_t put_ms;
+} bench_in_flight_t;
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to get the time used for latencies
+ *
+ * @returns Time in ms
+ ******************************************************************************/
+static uint32_t now_ms(void);
+
+/*******************************************************************************
+ * Function to release an in flight message
+ *
+ * @param[in] id Message id
+ * @param[out] put_ms Time the message was put
+ *
+ * @returns #true if the id belonged to a bench message
+ ******************************************************************************/
+static bool release(uint16_t id, uint32_t *put_ms);
+
+/*******************************************************************************
+ * Function to stop once every message is accounted for
+ ******************************************************************************/
+static void check_done(void);
+
+// -----------------------------------------------------------------------------
+//                                Global Variables
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+// Written by the CLI task, read by the main task after the start event
+static app_bench_config_t requested;
+static app_bench_config_t config;
+static app_bench_stats_t stats;
+static bench_in_flight_t in_flight[APP_BENCH_MAX_IN_FLIGHT];
+static uint8_t in_flight_count;
+static uint16_t next_index;
+static bool running;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+void app_bench_request(const app_bench_config_t *bench_config)
+{
+  requested = *bench_config;
+}
+
+bool app_bench_start(struct sid_handle *handle)
+{
+  if (running) {
+    SL_SID_LOG_APP_ERROR("bench already running");
+    return false;
+  }
+
+  if ((app_link_router_get_started_mask() & requested.link) == 0) {
+    SL_SID_LOG_APP_ERROR("bench link %s not started", app_link_router_link_name(requested.link));
+    return false;
+  }
+  size_t mtu = app_link_router_get_mtu(handle, requested.link);
+  if (requested.count == 0 || requested.size < APP_BENCH_MIN_SIZE) {
+    SL_SID_LOG_APP_ERROR("bench needs at least one message of %u bytes", APP_BENCH_MIN_SIZE);
+    return false;
+  }
+  if (requested.size > mtu || requested.size > APP_BENCH_MAX_SIZE) {
+    SL_SID_LOG_APP_ERROR("bench size %u over %s MTU %u",
+                         requested.size,
+                         app_link_router_link_name(requested.link),
+                         (unsigned int)mtu);
+    return false;
+  }
+
+  config = requested;
+  memset(&stats, 0, sizeof(stats));
+  stats.latency_min_ms = UINT32_MAX;
+  stats.start_ms = now_ms();
+  in_flight_count = 0;
+  next_index = 0;
+  running = true;
+
+  SL_SID_LOG_APP_INFO("bench started, count: %u, size: %u, ack: %d, link: %s",
+                      config.count,
+                      config.size,
+                      config.ack,
+                      app_link_router_link_name(config.link));
+  app_bench_pump(handle);
+  return true;
+}
+
+void app_bench_pump(struct sid_handle *handle)
+{
+  uint8_t payload[APP_BENCH_MAX_SIZE];
+
+  while (running && next_index < config.count && in_flight_count < APP_BENCH_MAX_IN_FLIGHT) {
+    // The marker keeps bit 7 of the first byte clear, it marks a segment otherwise
+    memset(payload, 0xA5, config.size);
+    payload[0] = APP_BENCH_MARKER;
+    payload[1] = (uint8_t)(next_index >> 8);
+    payload[2] = (uint8_t)next_index;
+
+    struct sid_msg msg = {
+      .data = payload,
+      .size = config.size,
+    };
+    struct sid_msg_desc desc = {
+      .type = SID_MSG_TYPE_NOTIFY,
+      .link_type = (enum sid_link_type)config.link,
+      .msg_desc_attr.tx_attr.request_ack = config.ack,
+    };
+
+    sid_error_t ret = sid_put_msg(handle, &msg, &desc);
+    if (ret == SID_ERROR_OUT_OF_RESOURCES || ret == SID_ERROR_TRY_AGAIN || ret == SID_ERROR_BUSY) {
+      // Stack queue full, retried after the next sid_process()
+      break;
+    } else if (ret != SID_ERROR_NONE) {
+      stats.put_errors++;
+      next_index++;
+      SL_SID_LOG_APP_ERROR("bench put failed, error: %d", (int)ret);
+      continue;
+    }
+
+    in_flight[in_flight_count].id = desc.id;
+    in_flight[in_flight_count].put_ms = now_ms();
+    in_flight_count++;
+    next_index++;
+    stats.put++;
+  }
+
+  check_done();
+}
+
+bool app_bench_on_msg_sent(const struct sid_msg_desc *msg_desc)
+{
+  uint32_t put_ms;
+
+  if (!release(msg_desc->id, &put_ms)) {
+    return false;
+  }
+
+  uint32_t latency_ms = now_ms() - put_ms;
+  stats.sent++;
+  stats.latency_sum_ms += latency_ms;
+  if (latency_ms < stats.latency_min_ms) {
+    stats.latency_min_ms = latency_ms;
+  }
+  if (latency_ms > stats.latency_max_ms) {
+    stats.latency_max_ms = latency_ms;
+  }
+  check_done();
+  return true;
+}
+
+bool app_bench_on_send_error(sid_error_t error, const struct sid_msg_desc *msg_desc)
+{
+  uint32_t put_ms;
+
+  if (!release(msg_desc->id, &put_ms)) {
+    return false;
+  }
+
+  stats.errors++;
+  SL_SID_LOG_APP_WARNING("bench message %u failed, error: %d", msg_desc->id, (int)error);
+  check_done();
+  return true;
+}
+
+void app_bench_stop(void)
+{
+  if (!running) {
+    return;
+  }
+  running = false;
+  stats.end_ms = now_ms();
+
+  uint32_t duration_ms = stats.end_ms - stats.start_ms;
+  uint32_t lost = stats.put_errors + stats.errors + in_flight_count;
+  uint32_t attempted = stats.put + stats.put_errors;
+
+  SL_SID_LOG_APP_INFO("bench done, link: %s, size: %u, ack: %d, duration: %lu ms",
+                      app_link_router_link_name(config.link),
+                      config.size,
+                      config.ack,
+                      (unsigned long)duration_ms);
+  SL_SID_LOG_APP_INFO("bench put: %lu, put errors: %lu, %s: %lu, errors: %lu, pending: %u",
+                      (unsigned long)stats.put,
+                      (unsigned long)stats.put_errors,
+                      config.ack ? "acked" : "sent",
+                      (unsigned long)stats.sent,
+                      (unsigned long)stats.errors,
+                      in_flight_count);
+  SL_SID_LOG_APP_INFO("bench throughput: %lu B/s, %lu msg/min, loss: %lu.%lu %%",
+                      (unsigned long)((duration_ms == 0) ? 0U : ((uint64_t)stats.sent * config.size * 1000U) / duration_ms),
+                      (unsigned long)((duration_ms == 0) ? 0U : ((uint64_t)stats.sent * 60000U) / duration_ms),
+                      (unsigned long)((attempted == 0) ? 0U : (lost * 100U) / attempted),
+                      (unsigned long)((attempted == 0) ? 0U : ((lost * 1000U) / attempted) % 10U));
+  if (stats.sent != 0) {
+    SL_SID_LOG_APP_INFO("bench latency min: %lu ms, avg: %lu ms, max: %lu ms",
+                        (unsigned long)stats.latency_min_ms,
+                        (unsigned long)(stats.latency_sum_ms / stats.sent),
+                        (unsigned long)stats.latency_max_ms);
+  }
+
+  // Late callbacks of pending messages are not accounted anymore
+  in_flight_count = 0;
+}
+
+bool app_bench_is_running(void)
+{
+  return running;
+}
+
+const app_bench_stats_t *app_bench_get_stats(void)
+{
+  return &stats;
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+static uint32_t now_ms(void)
+{
+  return (uint32_t)xTaskGetTickCount() * portTICK_PERIOD_MS;
+}
+
+static bool release(uint16_t id, uint32_t *put_ms)
+{
+  if (!running) {
+    return false;
+  }
+
+  for (uint8_t i = 0; i < in_flight_count; i++) {
+    if (in_flight[i].id == id) {
+      *put_ms = in_flight[i].put_ms;
+      in_flight[i] = in_flight[--in_flight_count];
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static void check_done(void)
+{
+  if (running && next_index >= config.count && in_flight_count == 0) {
+    app_bench_stop();
+  }
+}
@@ -0,0 +1,150 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_bench.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef APP_BENCH_H
+#define APP_BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "sid_api.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Bench messages handed to the stack at the same time
+#define APP_BENCH_MAX_IN_FLIGHT     (4U)
+// Largest bench message, also bounded by the MTU of the link
+#define APP_BENCH_MAX_SIZE          (255U)
+// Bench message: the marker, then the message index (2 bytes, big endian)
+#define APP_BENCH_MARKER            (0x03U)
+#define APP_BENCH_MIN_SIZE          (3U)
+
+typedef struct {
+  uint16_t count;             // Messages to send
+  uint16_t size;              // Payload size of each message
+  bool ack;                   // Request an ack for each message
+  uint32_t link;              // Link (SID_LINK_TYPE_x)
+} app_bench_config_t;
+
+typedef struct {
+  uint32_t put;               // Messages accepted by sid_put_msg()
+  uint32_t put_errors;        // Messages refused by sid_put_msg()
+  uint32_t sent;              // Messages reported sent (acked when acks are requested)
+  uint32_t errors;            // Messages reported failed
+  uint32_t latency_min_ms;    // Put to sent latency
+  uint32_t latency_max_ms;
+  uint64_t latency_sum_ms;
+  uint32_t start_ms;
+  uint32_t end_ms;
+} app_bench_stats_t;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to request a bench run, it starts with app_bench_start()
+ *
+ * May be called from any task.
+ *
+ * @param[in] config Bench parameters
+ ******************************************************************************/
+void app_bench_request(const app_bench_config_t *config);
+
+/*******************************************************************************
+ * Function to start the requested bench run
+ *
+ * @param[in] handle Sidewalk handle
+ *
+ * @returns #true if the run started
+ ******************************************************************************/
+bool app_bench_start(struct sid_handle *handle);
+
+/*******************************************************************************
+ * Function to put bench messages until the window is full
+ *
+ * Called after every sid_process(), the stack may have released messages.
+ *
+ * @param[in] handle Sidewalk handle
+ ******************************************************************************/
+void app_bench_pump(struct sid_handle *handle);
+
+/*******************************************************************************
+ * Function to account a sent message
+ *
+ * @param[in] msg_desc Message descriptor
+ *
+ * @returns #true if the message belongs to the bench run
+ ******************************************************************************/
+bool app_bench_on_msg_sent(const struct sid_msg_desc *msg_desc);
+
+/*******************************************************************************
+ * Function to account a failed message
+ *
+ * @param[in] error The error type
+ * @param[in] msg_desc Message descriptor
+ *
+ * @returns #true if the message belongs to the bench run
+ ******************************************************************************/
+bool app_bench_on_send_error(sid_error_t error, const struct sid_msg_desc *msg_desc);
+
+/*******************************************************************************
+ * Function to stop the bench run and print its summary
+ ******************************************************************************/
+void app_bench_stop(void);
+
+/*******************************************************************************
+ * Function to check if a bench run is ongoing
+ *
+ * @returns #true while messages are pending
+ ******************************************************************************/
+bool app_bench_is_running(void);
+
+/*******************************************************************************
+ * Function to get the counters of the current or last bench run
+ *
+ * @returns Bench counters
+ ******************************************************************************/
+const app_bench_stats_t *app_bench_get_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_BENCH_H
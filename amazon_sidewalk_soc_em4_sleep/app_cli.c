@@ -31,8 +31,13 @@
 // -----------------------------------------------------------------------------
 //                                   Includes
 // -----------------------------------------------------------------------------
+#include <string.h>
+
 #include "sl_cli.h"
 #include "app_process.h"
+#include "app_link_router.h"
+#include "app_payload.h"
+#include "sl_sidewalk_log_app.h"
 
 // -----------------------------------------------------------------------------
 //                              Macros and Typedefs
@@ -42,6 +47,26 @@
 //                          Static Function Declarations
 // -----------------------------------------------------------------------------
 
+/*******************************************************************************
+ * Function to decode a hex string
+ *
+ * @param[in] hex Hex digits, two per byte
+ * @param[out] out Decoded bytes
+ * @param[in] max Capacity of out
+ *
+ * @returns Number of bytes, 0 for an odd, empty, too long or invalid string
+ ******************************************************************************/
+static size_t hex_decode(const char *hex, uint8_t *out, size_t max);
+
+/*******************************************************************************
+ * Function to get the value of a hex digit
+ *
+ * @param[in] c Character
+ *
+ * @returns Value, -1 if not a hex digit
+ ******************************************************************************/
+static int hex_digit(char c);
+
 // -----------------------------------------------------------------------------
 //                                Global Variables
 // -----------------------------------------------------------------------------
@@ -55,14 +80,62 @@
 // -----------------------------------------------------------------------------
 void cli_link_switch(sl_cli_command_arg_t *arguments)
 {
-  (void)arguments;
-  app_trigger_link_switch();
+  uint32_t link = 0;
+
+  if (sl_cli_get_argument_count(arguments) > 0) {
+    link = app_link_router_link_from_name(sl_cli_get_argument_string(arguments, 0));
+    if (link == 0) {
+      SL_SID_LOG_APP_ERROR("unknown link, use ble, fsk or css");
+      return;
+    }
+  }
+  app_trigger_link_switch(link);
 }
 
 void cli_send(sl_cli_command_arg_t *arguments)
+{
+  if (sl_cli_get_argument_count(arguments) == 0) {
+    app_trigger_connect_and_send();
+    return;
+  }
+
+  // Decoded straight into the buffer the stack is handed
+  app_payload_handle_t payload = app_payload_claim();
+  if (payload == APP_PAYLOAD_NONE) {
+    SL_SID_LOG_APP_ERROR("no free payload buffer, %u in use", (unsigned int)app_payload_in_use());
+    return;
+  }
+  size_t size = hex_decode(sl_cli_get_argument_string(arguments, 0), app_payload_data(payload), APP_PAYLOAD_BUFFER_SIZE);
+  if (size == 0) {
+    SL_SID_LOG_APP_ERROR("invalid payload, use up to %u bytes as hex digits", (unsigned int)APP_PAYLOAD_BUFFER_SIZE);
+    app_payload_release(payload);
+    return;
+  }
+  app_payload_set_size(payload, size);
+  // Errors are logged, the buffer released
+  (void)app_trigger_send(payload);
+}
+
+void cli_bench(sl_cli_command_arg_t *arguments)
+{
+  app_bench_config_t config = {
+    .count = sl_cli_get_argument_uint16(arguments, 0),
+    .size = sl_cli_get_argument_uint16(arguments, 1),
+    .ack = sl_cli_get_argument_uint8(arguments, 2) != 0,
+    .link = app_link_router_link_from_name(sl_cli_get_argument_string(arguments, 3)),
+  };
+
+  if (config.link == 0) {
+    SL_SID_LOG_APP_ERROR("unknown link, use ble, fsk or css");
+    return;
+  }
+  app_trigger_bench(&config);
+}
+
+void cli_bench_stop(sl_cli_command_arg_t *arguments)
 {
   (void)arguments;
-  app_trigger_connect_and_send();
+  app_trigger_bench_stop();
 }
 
 void cli_reset(sl_cli_command_arg_t *arguments)
@@ -88,3 +161,78 @@ void cli_get_mtu(sl_cli_command_arg_t *arguments)
   (void)arguments;
   app_trigger_get_mtu();
 }
+
+void cli_report(sl_cli_command_arg_t *arguments)
+{
+  (void)arguments;
+  app_trigger_send_report();
+}
+
+void cli_trace(sl_cli_command_arg_t *arguments)
+{
+  (void)arguments;
+  app_trigger_trace_dump();
+}
+
+void cli_airtime(sl_cli_command_arg_t *arguments)
+{
+  (void)arguments;
+  app_trigger_airtime_stats();
+}
+
+void cli_lease(sl_cli_command_arg_t *arguments)
+{
+  app_trigger_awake_lease(sl_cli_get_argument_uint16(arguments, 0));
+}
+
+void cli_alarm(sl_cli_command_arg_t *arguments)
+{
+  app_trigger_alarm(sl_cli_get_argument_uint8(arguments, 0));
+}
+
+void cli_outbox(sl_cli_command_arg_t *arguments)
+{
+  (void)arguments;
+  app_trigger_outbox_stats();
+}
+
+void cli_restarts(sl_cli_command_arg_t *arguments)
+{
+  (void)arguments;
+  app_trigger_supervisor_stats();
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+static size_t hex_decode(const char *hex, uint8_t *out, size_t max)
+{
+  size_t length = strlen(hex);
+
+  if (length == 0 || (length % 2U) != 0 || (length / 2U) > max) {
+    return 0;
+  }
+  for (size_t i = 0; i < length / 2U; i++) {
+    int high = hex_digit(hex[2U * i]);
+    int low = hex_digit(hex[(2U * i) + 1U]);
+    if (high < 0 || low < 0) {
+      return 0;
+    }
+    out[i] = (uint8_t)((high << 4) | low);
+  }
+  return length / 2U;
+}
+
+static int hex_digit(char c)
+{
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
@@ -0,0 +1,122 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_connect.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include "app_connect.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Global Variables
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+static app_connect_stats_t stats = {
+  .latency_min_ms = UINT32_MAX,
+};
+static bool pending;
+// Attempt of the running connect-and-send and its start time
+static uint32_t attempt;
+static uint32_t attempt_start_ms;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+void app_connect_begin(uint32_t now_ms)
+{
+  pending = true;
+  attempt = 1;
+  attempt_start_ms = now_ms;
+  stats.attempts++;
+}
+
+bool app_connect_is_pending(void)
+{
+  return pending;
+}
+
+uint32_t app_connect_on_link_up(uint32_t now_ms)
+{
+  uint32_t latency_ms = now_ms - attempt_start_ms;
+
+  pending = false;
+  stats.connected++;
+  stats.latency_sum_ms += latency_ms;
+  if (latency_ms < stats.latency_min_ms) {
+    stats.latency_min_ms = latency_ms;
+  }
+  if (latency_ms > stats.latency_max_ms) {
+    stats.latency_max_ms = latency_ms;
+  }
+  return latency_ms;
+}
+
+app_connect_action_t app_connect_on_deadline(uint32_t now_ms, bool fallback_up)
+{
+  stats.timeouts++;
+
+  // Sending now beats another connection request
+  if (fallback_up) {
+    pending = false;
+    stats.fallbacks++;
+    return APP_CONNECT_ACTION_FALLBACK;
+  }
+  if (attempt < APP_CONNECT_MAX_ATTEMPTS) {
+    attempt++;
+    attempt_start_ms = now_ms;
+    stats.attempts++;
+    return APP_CONNECT_ACTION_RETRY;
+  }
+
+  pending = false;
+  stats.given_up++;
+  return APP_CONNECT_ACTION_GIVE_UP;
+}
+
+uint32_t app_connect_get_attempt(void)
+{
+  return attempt;
+}
+
+const app_connect_stats_t *app_connect_get_stats(void)
+{
+  return &stats;
+}
@@ -0,0 +1,128 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_connect.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef APP_CONNECT_H
+#define APP_CONNECT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Connection request to BLE link up, beyond that the attempt has failed
+#define APP_CONNECT_DEADLINE_MS     (10000U)
+// Connection requests before giving up when no other link is up
+#define APP_CONNECT_MAX_ATTEMPTS    (2U)
+
+// What to do once an attempt missed its deadline
+typedef enum {
+  APP_CONNECT_ACTION_RETRY = 0,   // Request the connection again
+  APP_CONNECT_ACTION_FALLBACK,    // Send over the sub-GHz link that is up
+  APP_CONNECT_ACTION_GIVE_UP,     // Drop the send
+} app_connect_action_t;
+
+typedef struct {
+  uint32_t attempts;          // Connection requests issued
+  uint32_t connected;         // Attempts that brought the link up in time
+  uint32_t timeouts;          // Attempts that missed the deadline
+  uint32_t fallbacks;         // Sends moved to a sub-GHz link
+  uint32_t given_up;          // Sends dropped
+  uint32_t latency_min_ms;    // Request to link up of the connected attempts
+  uint32_t latency_max_ms;
+  uint64_t latency_sum_ms;
+} app_connect_stats_t;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to start a connect-and-send, first attempt
+ *
+ * @param[in] now_ms Time of the connection request
+ ******************************************************************************/
+void app_connect_begin(uint32_t now_ms);
+
+/*******************************************************************************
+ * Function to check if a connect-and-send is waiting for its link
+ *
+ * @returns #true while an attempt runs
+ ******************************************************************************/
+bool app_connect_is_pending(void);
+
+/*******************************************************************************
+ * Function to end the connect-and-send, the link came up
+ *
+ * @param[in] now_ms Time the link came up
+ *
+ * @returns Latency of the attempt in ms
+ ******************************************************************************/
+uint32_t app_connect_on_link_up(uint32_t now_ms);
+
+/*******************************************************************************
+ * Function to handle a missed deadline
+ *
+ * A retry starts the next attempt at now_ms, the other actions end the
+ * connect-and-send.
+ *
+ * @param[in] now_ms Current time
+ * @param[in] fallback_up A sub-GHz link is up and ready to send
+ *
+ * @returns Action to take
+ ******************************************************************************/
+app_connect_action_t app_connect_on_deadline(uint32_t now_ms, bool fallback_up);
+
+/*******************************************************************************
+ * Function to get the attempt number of the running connect-and-send
+ *
+ * @returns Attempt number, starting at 1
+ ******************************************************************************/
+uint32_t app_connect_get_attempt(void);
+
+/*******************************************************************************
+ * Function to get the connect-and-send statistics of this boot
+ *
+ * @returns Statistics
+ ******************************************************************************/
+const app_connect_stats_t *app_connect_get_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_CONNECT_H
@@ -0,0 +1,193 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_diag.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdbool.h>
+#include "app_diag.h"
+#include "app_retained.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Score added to a changed value so that it goes out in the next uplink
+#define DIAG_CHANGED_BONUS          (100U)
+
+typedef struct {
+  uint32_t value;
+  uint16_t score;         // Grows by the priority on every uplink without the field
+  bool valid;
+  bool changed;
+} diag_entry_t;
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to pick the next field to report
+ *
+ * @param[in] space Space left
+ * @param[in] taken Fields already written, bit per field
+ *
+ * @returns Field or APP_DIAG_FIELD_COUNT when none fits
+ ******************************************************************************/
+static app_diag_field_t pick_field(size_t space, uint32_t taken);
+
+// -----------------------------------------------------------------------------
+//                                Global Variables
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+// Encoded value size, indexed by field
+static const uint8_t field_size[APP_DIAG_FIELD_COUNT] = {
+  [APP_DIAG_WAKE_COUNT] = 2U,
+  [APP_DIAG_RESET_CAUSE] = 4U,
+  [APP_DIAG_SUPPLY_MV] = 2U,
+  [APP_DIAG_LAST_ERROR] = 1U,
+  [APP_DIAG_LINK_STATUS] = 1U,
+  [APP_DIAG_RENDEZVOUS] = 4U,
+  [APP_DIAG_TX_POWER] = 1U,
+  [APP_DIAG_STACK_RESTARTS] = 2U,
+  [APP_DIAG_RECOVERY_S] = 2U,
+  [APP_DIAG_BATTERY_TIER] = 1U,
+};
+
+// Score added per uplink, the higher the more often the field is reported
+static const uint8_t field_priority[APP_DIAG_FIELD_COUNT] = {
+  [APP_DIAG_WAKE_COUNT] = 2U,
+  [APP_DIAG_RESET_CAUSE] = 1U,
+  [APP_DIAG_SUPPLY_MV] = 3U,
+  [APP_DIAG_LAST_ERROR] = 2U,
+  [APP_DIAG_LINK_STATUS] = 4U,
+  [APP_DIAG_RENDEZVOUS] = 8U,
+  [APP_DIAG_TX_POWER] = 2U,
+  [APP_DIAG_STACK_RESTARTS] = 2U,
+  [APP_DIAG_RECOVERY_S] = 2U,
+  [APP_DIAG_BATTERY_TIER] = 3U,
+};
+
+static diag_entry_t entries[APP_DIAG_FIELD_COUNT];
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+void app_diag_init(void)
+{
+  uint32_t wake_count = app_retained_get(APP_RETAINED_SLOT_WAKE_COUNT) + 1U;
+  app_retained_set(APP_RETAINED_SLOT_WAKE_COUNT, wake_count);
+
+  app_diag_set(APP_DIAG_WAKE_COUNT, wake_count);
+  app_diag_set(APP_DIAG_RESET_CAUSE, app_retained_get_reset_cause());
+  app_diag_set(APP_DIAG_LAST_ERROR, app_retained_get(APP_RETAINED_SLOT_LAST_ERROR));
+}
+
+void app_diag_set(app_diag_field_t field, uint32_t value)
+{
+  if (field == 0 || field >= APP_DIAG_FIELD_COUNT) {
+    return;
+  }
+  diag_entry_t *entry = &entries[field];
+  if (!entry->valid || entry->value != value) {
+    entry->changed = true;
+  }
+  entry->value = value;
+  entry->valid = true;
+}
+
+void app_diag_set_error(sid_error_t error)
+{
+  app_retained_set(APP_RETAINED_SLOT_LAST_ERROR, (uint32_t)error);
+  app_diag_set(APP_DIAG_LAST_ERROR, (uint32_t)error);
+}
+
+size_t app_diag_fill(uint8_t *out, size_t space)
+{
+  size_t written = 0;
+  uint32_t taken = 0;
+
+  for (uint32_t field = 1; field < APP_DIAG_FIELD_COUNT; field++) {
+    if (entries[field].valid && entries[field].score < (UINT16_MAX - DIAG_CHANGED_BONUS)) {
+      entries[field].score += field_priority[field];
+    }
+  }
+
+  while (1) {
+    // The marker is only written together with the first field
+    size_t overhead = (written == 0) ? 2U : 1U;
+    if (space - written < overhead) {
+      break;
+    }
+    app_diag_field_t field = pick_field(space - written - overhead, taken);
+    if (field == APP_DIAG_FIELD_COUNT) {
+      break;
+    }
+    if (written == 0) {
+      out[written++] = APP_DIAG_MARKER;
+    }
+    out[written++] = (uint8_t)field;
+    for (int32_t i = (int32_t)field_size[field] - 1; i >= 0; i--) {
+      out[written++] = (uint8_t)(entries[field].value >> (8 * i));
+    }
+    entries[field].score = 0;
+    entries[field].changed = false;
+    taken |= (1UL << field);
+  }
+
+  return written;
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+static app_diag_field_t pick_field(size_t space, uint32_t taken)
+{
+  app_diag_field_t best = APP_DIAG_FIELD_COUNT;
+  uint32_t best_score = 0;
+
+  for (uint32_t field = 1; field < APP_DIAG_FIELD_COUNT; field++) {
+    const diag_entry_t *entry = &entries[field];
+    if (!entry->valid || (taken & (1UL << field)) != 0 || field_size[field] > space) {
+      continue;
+    }
+    uint32_t score = (uint32_t)entry->score + (entry->changed ? DIAG_CHANGED_BONUS : 0U) + 1U;
+    if (score > best_score) {
+      best_score = score;
+      best = (app_diag_field_t)field;
+    }
+  }
+
+  return best;
+}
@@ -0,0 +1,114 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_diag.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef APP_DIAG_H
+#define APP_DIAG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stddef.h>
+#include "sid_error.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// First byte of the diagnostic block appended to an uplink payload
+#define APP_DIAG_MARKER             (0xDAU)
+
+// Diagnostic fields, each encoded as its id followed by a fixed size big
+// endian value
+typedef enum {
+  APP_DIAG_WAKE_COUNT = 1,    // 2 bytes, boots since power-on
+  APP_DIAG_RESET_CAUSE,       // 4 bytes, EMU_RSTCAUSE_x flags
+  APP_DIAG_SUPPLY_MV,         // 2 bytes, supply voltage in mV
+  APP_DIAG_LAST_ERROR,        // 1 byte, last sid_error_t seen
+  APP_DIAG_LINK_STATUS,       // 1 byte, link status mask | registered << 6 | time sync << 7
+  APP_DIAG_RENDEZVOUS,        // 4 bytes, s to the next receive window << 16 | window length in s
+  APP_DIAG_TX_POWER,          // 1 byte, TX power of the uplink in dBm
+  APP_DIAG_STACK_RESTARTS,    // 2 bytes, stack restarts since power-on
+  APP_DIAG_RECOVERY_S,        // 2 bytes, stack failure to ready of the last recovery in s
+  APP_DIAG_BATTERY_TIER,      // 1 byte, battery tier, see app_battery.h
+  APP_DIAG_FIELD_COUNT
+} app_diag_field_t;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to initialize the diagnostics collector
+ *
+ * Counts the boot and loads the values retained across EM4, must be called
+ * after app_retained_init().
+ ******************************************************************************/
+void app_diag_init(void);
+
+/*******************************************************************************
+ * Function to update a diagnostic field
+ *
+ * A field is only reported once it has a value, a changed value is reported
+ * with precedence.
+ *
+ * @param[in] field Diagnostic field
+ * @param[in] value New value
+ ******************************************************************************/
+void app_diag_set(app_diag_field_t field, uint32_t value);
+
+/*******************************************************************************
+ * Function to record a Sidewalk error
+ *
+ * @param[in] error Error returned or reported by the stack
+ ******************************************************************************/
+void app_diag_set_error(sid_error_t error);
+
+/*******************************************************************************
+ * Function to fill the space left in an uplink with diagnostic fields
+ *
+ * Fields are picked by priority and by how long they were not reported, so
+ * that every field is eventually reported even with little space.
+ *
+ * @param[out] out Buffer right after the application payload
+ * @param[in] space Space left up to the MTU
+ *
+ * @returns Bytes written, 0 when no field fits
+ ******************************************************************************/
+size_t app_diag_fill(uint8_t *out, size_t space);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_DIAG_H
@@ -50,6 +50,18 @@
 #include "sl_sidewalk_common_config.h"
 #include "sl_sidewalk_utils.h"
 #include "em4_mode.h"
+#include "app_retained.h"
+#include "app_diag.h"
+#include "app_supply.h"
+#include "app_airtime.h"
+#include "app_schedule.h"
+#include "app_rendezvous.h"
+#include "app_radio_sleep.h"
+#include "app_tx_power.h"
+#include "app_ack_policy.h"
+#include "app_supervisor.h"
+#include "app_battery.h"
+#include "app_trace.h"
 
 #if (defined(SL_FSK_SUPPORTED) || defined(SL_CSS_SUPPORTED))
 #include "app_subghz_config.h"
@@ -127,6 +139,29 @@ void app_init(void)
 
   init_peripheral_for_EM4();
 
+  // Restore the retained state and the device time across EM4
+  app_retained_init(em4_get_last_sleep_ms());
+  app_diag_init();
+  uint16_t supply_mv = app_supply_measure_mv();
+  app_diag_set(APP_DIAG_SUPPLY_MV, supply_mv);
+  if (app_battery_init(supply_mv)) {
+    SL_SID_LOG_APP_WARNING("battery tier changed: %s", app_battery_get_mode()->name);
+  }
+  SL_SID_LOG_APP_INFO("supply: %u mV, battery tier: %s", (unsigned int)supply_mv, app_battery_get_mode()->name);
+  app_diag_set(APP_DIAG_BATTERY_TIER, (uint32_t)app_battery_get_tier());
+  app_airtime_init();
+  // The SMSN spreads the scheduled uplinks of a fleet over the period
+  app_schedule_init(app_schedule_seed(smsn_str));
+  // Operating mode of the battery tier for this wake-up
+  app_schedule_set_stride(app_battery_get_mode()->schedule_stride);
+  app_trace_set_persist(app_battery_get_mode()->trace_persist);
+  set_em4_awake_timeout(app_battery_get_mode()->awake_ms);
+  app_rendezvous_init();
+  app_radio_sleep_init();
+  app_tx_power_init();
+  app_ack_policy_init();
+  app_supervisor_init();
+
   BaseType_t status = xTaskCreate(main_thread,
                                   "MAIN",
                                   MAIN_TASK_STACK_SIZE,
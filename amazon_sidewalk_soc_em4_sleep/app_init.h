@@ -43,6 +43,7 @@ extern "C" {
 
 #include "FreeRTOS.h"
 #include "queue.h"
+#include "app_payload.h"
 
 // -----------------------------------------------------------------------------
 //                              Macros and Typedefs
@@ -61,10 +62,38 @@ enum event_type{
   EVENT_TYPE_GET_TIME,
   EVENT_TYPE_GET_MTU,
   EVENT_TYPE_REGISTERED,
+  EVENT_TYPE_REGISTRATION_FALLBACK,
   EVENT_TYPE_SEND,
+  EVENT_TYPE_SEND_REPORT,
+  EVENT_TYPE_TRACE_DUMP,
+  EVENT_TYPE_AIRTIME_RETRY,
+  EVENT_TYPE_AIRTIME_STATS,
+  EVENT_TYPE_BENCH_START,
+  EVENT_TYPE_BENCH_STOP,
+  EVENT_TYPE_SAMPLES,
+  EVENT_TYPE_SCHEDULED_SEND,
+  EVENT_TYPE_AWAKE_LEASE,
+  EVENT_TYPE_ALARM,
+  EVENT_TYPE_OUTBOX,
+  EVENT_TYPE_OUTBOX_STATS,
+  EVENT_TYPE_STACK_RESTART,
+  EVENT_TYPE_SUPERVISOR_STATS,
+#if defined(SL_BLE_SUPPORTED)
+  EVENT_TYPE_CONNECT_DEADLINE,
+#endif
   EVENT_TYPE_INVALID
 };
 
+// Event record of the main task queue
+typedef struct {
+  enum event_type type;
+  // Buffer filled by the producer, APP_PAYLOAD_NONE for events without one.
+  // The main task owns it once the event is queued.
+  app_payload_handle_t payload;
+  // Event parameter, 0 if none, e.g. the target link of a link switch
+  uint32_t arg;
+} app_event_t;
+
 // Sidewalk States defined in application context
 enum app_state{
   STATE_INIT = 0,
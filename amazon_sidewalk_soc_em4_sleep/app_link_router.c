@@ -0,0 +1,305 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_link_router.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <ctype.h>
+
+#include "app_link_router.h"
+#include "sl_sidewalk_log_app.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+#define LINK_COUNT          (3U)
+#define SUBGHZ_LINK_MASK    (SID_LINK_TYPE_2 | SID_LINK_TYPE_3)
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to estimate the energy cost of an uplink on a link
+ *
+ * @param[in] link Link (SID_LINK_TYPE_x)
+ * @param[in] payload_size Size of the payload
+ *
+ * @returns Estimated cost in uJ
+ ******************************************************************************/
+static uint32_t link_energy_cost(uint32_t link, size_t payload_size);
+
+/*******************************************************************************
+ * Function to estimate the latency of an uplink on a link
+ *
+ * @param[in] link Link (SID_LINK_TYPE_x)
+ *
+ * @returns Estimated latency in ms
+ ******************************************************************************/
+static uint32_t link_latency(uint32_t link);
+
+// -----------------------------------------------------------------------------
+//                                Global Variables
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+static const uint32_t links[LINK_COUNT] = { SID_LINK_TYPE_1, SID_LINK_TYPE_2, SID_LINK_TYPE_3 };
+
+static uint32_t started_mask;
+static uint32_t preferred_link;
+static uint32_t link_status_mask;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+uint32_t app_link_router_supported_mask(uint32_t default_link)
+{
+  uint32_t mask = 0;
+
+#if defined(SL_BLE_SUPPORTED)
+  mask |= SID_LINK_TYPE_1;
+#endif
+
+  if (default_link & SUBGHZ_LINK_MASK) {
+    mask |= default_link & SUBGHZ_LINK_MASK;
+  } else {
+#if defined(SL_FSK_SUPPORTED)
+    mask |= SID_LINK_TYPE_2;
+#elif defined(SL_CSS_SUPPORTED)
+    mask |= SID_LINK_TYPE_3;
+#endif
+  }
+
+  return mask;
+}
+
+void app_link_router_init(uint32_t mask, uint32_t preferred)
+{
+  started_mask = mask;
+  link_status_mask = 0;
+  if (!app_link_router_set_preferred(preferred)) {
+    // Fall back on any started link, lowest link type first
+    for (uint32_t i = 0; i < LINK_COUNT; i++) {
+      if (started_mask & links[i]) {
+        preferred_link = links[i];
+        break;
+      }
+    }
+  }
+  SL_SID_LOG_APP_INFO("link router started, links: %x, preferred: %s",
+                      (int)started_mask,
+                      app_link_router_link_name(preferred_link));
+}
+
+void app_link_router_set_link_status(uint32_t status_mask)
+{
+  link_status_mask = status_mask;
+}
+
+bool app_link_router_set_preferred(uint32_t link)
+{
+  if ((started_mask & link) == 0) {
+    return false;
+  }
+  preferred_link = link;
+  return true;
+}
+
+uint32_t app_link_router_get_preferred(void)
+{
+  return preferred_link;
+}
+
+uint32_t app_link_router_get_started_mask(void)
+{
+  return started_mask;
+}
+
+bool app_link_router_is_up(uint32_t link)
+{
+  return (link_status_mask & link) != 0;
+}
+
+enum sid_link_type app_link_router_select(struct sid_handle *handle,
+                                          size_t payload_size,
+                                          app_link_urgency_t urgency)
+{
+  uint32_t best_link = 0;
+  uint32_t best_score = UINT32_MAX;
+  bool best_up = false;
+  uint32_t largest_link = 0;
+  size_t largest_mtu = 0;
+
+  for (uint32_t i = 0; i < LINK_COUNT; i++) {
+    uint32_t link = links[i];
+    if ((started_mask & link) == 0) {
+      continue;
+    }
+
+    size_t mtu = app_link_router_get_mtu(handle, link);
+    if (mtu > largest_mtu) {
+      largest_mtu = mtu;
+      largest_link = link;
+    }
+    if (mtu < payload_size) {
+      continue;
+    }
+
+    bool up = app_link_router_is_up(link);
+    uint32_t score;
+    if (urgency == APP_LINK_URGENCY_HIGH) {
+      score = link_latency(link);
+    } else if (urgency == APP_LINK_URGENCY_NORMAL && link == preferred_link && up) {
+      score = 0;
+    } else {
+      score = link_energy_cost(link, payload_size);
+    }
+
+    // A link that is up always wins over a link that still has to connect
+    if ((up && !best_up) || (up == best_up && score < best_score)) {
+      best_link = link;
+      best_score = score;
+      best_up = up;
+    }
+  }
+
+  if (best_link == 0) {
+    if (largest_link == 0) {
+      return SID_LINK_TYPE_ANY;
+    }
+    SL_SID_LOG_APP_WARNING("no link fits %u bytes, using %s (mtu: %u)",
+                           (unsigned int)payload_size,
+                           app_link_router_link_name(largest_link),
+                           (unsigned int)largest_mtu);
+    best_link = largest_link;
+  }
+
+  return (enum sid_link_type)best_link;
+}
+
+size_t app_link_router_get_mtu(struct sid_handle *handle, uint32_t link)
+{
+  size_t mtu = 0;
+
+  if (handle == NULL || sid_get_mtu(handle, (enum sid_link_type)link, &mtu) != SID_ERROR_NONE) {
+    return 0;
+  }
+
+  return mtu;
+}
+
+const char *app_link_router_link_name(uint32_t link)
+{
+  switch (link) {
+    case SID_LINK_TYPE_1:
+      return "BLE";
+    case SID_LINK_TYPE_2:
+      return "FSK";
+    case SID_LINK_TYPE_3:
+      return "CSS";
+    default:
+      return "ANY";
+  }
+}
+
+uint32_t app_link_router_link_from_name(const char *name)
+{
+  if (name == NULL) {
+    return 0;
+  }
+  for (uint32_t i = 0; i < LINK_COUNT; i++) {
+    const char *link_name = app_link_router_link_name(links[i]);
+    size_t n = 0;
+    while (link_name[n] != '\0' && toupper((unsigned char)name[n]) == link_name[n]) {
+      n++;
+    }
+    if (link_name[n] == '\0' && name[n] == '\0') {
+      return links[i];
+    }
+  }
+  return 0;
+}
+
+uint32_t app_link_router_next_link(uint32_t link_mask, uint32_t link)
+{
+  uint32_t i = 0;
+
+  if (link != 0) {
+    while (i < LINK_COUNT && links[i] != link) {
+      i++;
+    }
+    i++;
+  }
+  for (; i < LINK_COUNT; i++) {
+    if ((link_mask & links[i]) != 0) {
+      return links[i];
+    }
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+static uint32_t link_energy_cost(uint32_t link, size_t payload_size)
+{
+  uint32_t size = (uint32_t)payload_size;
+
+  switch (link) {
+    case SID_LINK_TYPE_1:
+      return APP_LINK_ROUTER_BLE_COST_FIXED_UJ
+             + (APP_LINK_ROUTER_BLE_COST_PER_BYTE_UJ * size)
+             + (app_link_router_is_up(link) ? 0U : APP_LINK_ROUTER_BLE_CONNECT_COST_UJ);
+    case SID_LINK_TYPE_2:
+      return APP_LINK_ROUTER_FSK_COST_FIXED_UJ + (APP_LINK_ROUTER_FSK_COST_PER_BYTE_UJ * size);
+    case SID_LINK_TYPE_3:
+      return APP_LINK_ROUTER_CSS_COST_FIXED_UJ + (APP_LINK_ROUTER_CSS_COST_PER_BYTE_UJ * size);
+    default:
+      return UINT32_MAX;
+  }
+}
+
+static uint32_t link_latency(uint32_t link)
+{
+  switch (link) {
+    case SID_LINK_TYPE_1:
+      return app_link_router_is_up(link) ? APP_LINK_ROUTER_BLE_LATENCY_MS : APP_LINK_ROUTER_BLE_CONNECT_LATENCY_MS;
+    case SID_LINK_TYPE_2:
+      return APP_LINK_ROUTER_FSK_LATENCY_MS;
+    case SID_LINK_TYPE_3:
+      return APP_LINK_ROUTER_CSS_LATENCY_MS;
+    default:
+      return UINT32_MAX;
+  }
+}
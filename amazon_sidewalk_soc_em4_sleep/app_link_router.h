@@ -0,0 +1,198 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_link_router.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef APP_LINK_ROUTER_H
+#define APP_LINK_ROUTER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "sid_api.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Relative energy cost of one uplink on each link, in uJ.
+// The fixed part covers wake-up, preamble and protocol overhead, the per byte
+// part the time on air of the payload at the link data rate.
+#define APP_LINK_ROUTER_BLE_COST_FIXED_UJ       (150U)
+#define APP_LINK_ROUTER_BLE_COST_PER_BYTE_UJ    (1U)
+// Cost of asking a gateway for a BLE connection when the link is down
+#define APP_LINK_ROUTER_BLE_CONNECT_COST_UJ     (20000U)
+#define APP_LINK_ROUTER_FSK_COST_FIXED_UJ       (700U)
+#define APP_LINK_ROUTER_FSK_COST_PER_BYTE_UJ    (55U)
+#define APP_LINK_ROUTER_CSS_COST_FIXED_UJ       (30000U)
+#define APP_LINK_ROUTER_CSS_COST_PER_BYTE_UJ    (1300U)
+
+// Typical uplink latency of each link, in ms
+#define APP_LINK_ROUTER_BLE_LATENCY_MS          (100U)
+#define APP_LINK_ROUTER_BLE_CONNECT_LATENCY_MS  (3000U)
+#define APP_LINK_ROUTER_FSK_LATENCY_MS          (500U)
+#define APP_LINK_ROUTER_CSS_LATENCY_MS          (2500U)
+
+// Urgency of an uplink, trades latency against energy
+typedef enum {
+  APP_LINK_URGENCY_LOW = 0,     // Cheapest link that fits the payload
+  APP_LINK_URGENCY_NORMAL,      // Preferred link if usable, cheapest otherwise
+  APP_LINK_URGENCY_HIGH,        // Fastest link that fits the payload
+} app_link_urgency_t;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to get the mask of all links that can run concurrently
+ *
+ * FSK and CSS share the sub-GHz radio, so at most one of them is part of the
+ * mask: the default link if it is a sub-GHz one, FSK otherwise.
+ *
+ * @param[in] default_link Default link (SID_LINK_TYPE_x)
+ *
+ * @returns Link mask to start the stack with
+ ******************************************************************************/
+uint32_t app_link_router_supported_mask(uint32_t default_link);
+
+/*******************************************************************************
+ * Function to (re)initialize the router after the stack was started
+ *
+ * @param[in] started_mask Link mask the stack was started with
+ * @param[in] preferred_link Link used for normal traffic when usable
+ ******************************************************************************/
+void app_link_router_init(uint32_t started_mask, uint32_t preferred_link);
+
+/*******************************************************************************
+ * Function to update the set of links reported up by the stack
+ *
+ * @param[in] link_status_mask Link status mask from the sidewalk status
+ ******************************************************************************/
+void app_link_router_set_link_status(uint32_t link_status_mask);
+
+/*******************************************************************************
+ * Function to change the link used for normal traffic
+ *
+ * @param[in] link Preferred link (SID_LINK_TYPE_x)
+ *
+ * @returns #true           if the link is started and can be routed to
+ * @returns #false          if the stack has to be restarted to use the link
+ ******************************************************************************/
+bool app_link_router_set_preferred(uint32_t link);
+
+/*******************************************************************************
+ * Function to get the link used for normal traffic
+ *
+ * @returns Preferred link (SID_LINK_TYPE_x)
+ ******************************************************************************/
+uint32_t app_link_router_get_preferred(void);
+
+/*******************************************************************************
+ * Function to get the link mask the stack was started with
+ *
+ * @returns Started link mask
+ ******************************************************************************/
+uint32_t app_link_router_get_started_mask(void);
+
+/*******************************************************************************
+ * Function to check if a link is currently reported up by the stack
+ *
+ * @param[in] link Link to check (SID_LINK_TYPE_x)
+ *
+ * @returns #true if the link is up
+ ******************************************************************************/
+bool app_link_router_is_up(uint32_t link);
+
+/*******************************************************************************
+ * Function to choose the link of an uplink
+ *
+ * Only started links whose MTU fits the payload are considered, links reported
+ * up are preferred over links that still have to connect. When no link fits,
+ * the link with the largest MTU is returned.
+ *
+ * @param[in] handle Sidewalk handle
+ * @param[in] payload_size Size of the payload to send
+ * @param[in] urgency Urgency of the message
+ *
+ * @returns Link to put in the message descriptor
+ ******************************************************************************/
+enum sid_link_type app_link_router_select(struct sid_handle *handle,
+                                          size_t payload_size,
+                                          app_link_urgency_t urgency);
+
+/*******************************************************************************
+ * Function to get the MTU of a link
+ *
+ * @param[in] handle Sidewalk handle
+ * @param[in] link Link (SID_LINK_TYPE_x)
+ *
+ * @returns MTU in bytes, 0 if the link is not available
+ ******************************************************************************/
+size_t app_link_router_get_mtu(struct sid_handle *handle, uint32_t link);
+
+/*******************************************************************************
+ * Function to get a printable name of a link
+ *
+ * @param[in] link Link (SID_LINK_TYPE_x)
+ *
+ * @returns Link name
+ ******************************************************************************/
+const char *app_link_router_link_name(uint32_t link);
+
+/*******************************************************************************
+ * Function to get a link from its name, case insensitive
+ *
+ * @param[in] name Link name, "ble", "fsk" or "css"
+ *
+ * @returns Link (SID_LINK_TYPE_x), 0 for an unknown name
+ ******************************************************************************/
+uint32_t app_link_router_link_from_name(const char *name);
+
+/*******************************************************************************
+ * Function to walk the links of a mask, BLE, FSK then CSS
+ *
+ * @param[in] link_mask Links to walk (SID_LINK_TYPE_x)
+ * @param[in] link Link returned by the previous call, 0 to start
+ *
+ * @returns Next link of the mask, 0 when there are no more
+ ******************************************************************************/
+uint32_t app_link_router_next_link(uint32_t link_mask, uint32_t link);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_LINK_ROUTER_H
@@ -0,0 +1,92 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_nvm.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include "app_nvm.h"
+#include "nvm3_default.h"
+#include "sl_sidewalk_log_app.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Global Variables
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+bool app_nvm_read(app_nvm_key_t key, void *data, size_t size)
+{
+  uint32_t type;
+  size_t len;
+
+  if (nvm3_getObjectInfo(nvm3_defaultHandle, key, &type, &len) != ECODE_NVM3_OK
+      || len != size) {
+    return false;
+  }
+
+  return nvm3_readData(nvm3_defaultHandle, key, data, size) == ECODE_NVM3_OK;
+}
+
+bool app_nvm_read_partial(app_nvm_key_t key, void *data, size_t size)
+{
+  uint32_t type;
+  size_t len;
+
+  if (nvm3_getObjectInfo(nvm3_defaultHandle, key, &type, &len) != ECODE_NVM3_OK
+      || len < size) {
+    return false;
+  }
+
+  return nvm3_readPartialData(nvm3_defaultHandle, key, data, 0, size) == ECODE_NVM3_OK;
+}
+
+bool app_nvm_write(app_nvm_key_t key, const void *data, size_t size)
+{
+  Ecode_t ret = nvm3_writeData(nvm3_defaultHandle, key, data, size);
+  if (ret != ECODE_NVM3_OK) {
+    SL_SID_LOG_APP_ERROR("nvm3 write failed, key: %x, error: %x", (unsigned int)key, (unsigned int)ret);
+    return false;
+  }
+
+  return true;
+}
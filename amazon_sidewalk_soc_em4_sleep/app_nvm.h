@@ -0,0 +1,100 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_nvm.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef APP_NVM_H
+#define APP_NVM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// First NVM3 key used by the application, away from the stack objects
+#define APP_NVM_KEY_BASE            (0x0E000U)
+
+// NVM3 objects owned by the application
+typedef enum {
+  APP_NVM_KEY_REGISTERED = APP_NVM_KEY_BASE,   // uint8_t, device registration outcome
+  APP_NVM_KEY_REPORT_BATCH,                    // Samples waiting for a report, see app_report.h
+  APP_NVM_KEY_OUTBOX,                          // Uplinks waiting in the outbox, see app_outbox.h
+  APP_NVM_KEY_TRACE_CHUNK_FIRST = APP_NVM_KEY_BASE + 0x100U, // Trace chunks, see app_trace.h
+} app_nvm_key_t;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to read an application object from NVM3
+ *
+ * @param[in] key Object key
+ * @param[out] data Object data
+ * @param[in] size Expected object size
+ *
+ * @returns #true if the object exists with the expected size
+ ******************************************************************************/
+bool app_nvm_read(app_nvm_key_t key, void *data, size_t size);
+
+/*******************************************************************************
+ * Function to write an application object to NVM3
+ *
+ * @param[in] key Object key
+ * @param[in] data Object data
+ * @param[in] size Object size
+ *
+ * @returns #true on success
+ ******************************************************************************/
+bool app_nvm_write(app_nvm_key_t key, const void *data, size_t size);
+
+/*******************************************************************************
+ * Function to read the beginning of an application object from NVM3
+ *
+ * @param[in] key Object key
+ * @param[out] data Object data
+ * @param[in] size Number of bytes to read
+ *
+ * @returns #true if the object exists and is at least size bytes long
+ ******************************************************************************/
+bool app_nvm_read_partial(app_nvm_key_t key, void *data, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_NVM_H
@@ -0,0 +1,407 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_outbox.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <string.h>
+
+#include "app_outbox.h"
+#include "app_payload.h"
+#include "app_nvm.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Uplinks of a class, oldest first
+typedef struct {
+  app_outbox_entry_t entries[APP_OUTBOX_CLASS_DEPTH];
+  size_t head;
+  size_t count;
+} outbox_queue_t;
+
+// Stored outbox: its size, then per uplink the class, the kind, the value and
+// the request time, little endian. A payload stores its size (1 byte) and its
+// bytes in place of the value.
+#define STORED_HEADER_BYTES         (1U)
+#define STORED_ENTRY_OVERHEAD       (2U + 4U)
+
+_Static_assert(APP_OUTBOX_STORED_BYTES <= UINT8_MAX, "stored outbox size is kept in one byte");
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to remove the oldest uplink of a class, releasing its payload
+ *
+ * @param[in] msg_class Class
+ ******************************************************************************/
+static void remove_oldest(app_outbox_class_t msg_class);
+
+/*******************************************************************************
+ * Function to remove the newest uplink of a class, releasing its payload
+ *
+ * @param[in] msg_class Class
+ ******************************************************************************/
+static void remove_newest(app_outbox_class_t msg_class);
+
+/*******************************************************************************
+ * Function to serialize an uplink for the stored outbox
+ *
+ * @param[out] out Serialized uplink
+ * @param[in] capacity Room left in out
+ * @param[in] msg_class Class of the uplink
+ * @param[in] entry Uplink
+ *
+ * @returns Serialized size, 0 if it does not fit
+ ******************************************************************************/
+static size_t store_entry(uint8_t *out, size_t capacity, app_outbox_class_t msg_class, const app_outbox_entry_t *entry);
+
+/*******************************************************************************
+ * Function to put back an uplink of the stored outbox
+ *
+ * @param[in] in Serialized uplinks
+ * @param[in] available Bytes left in the stored outbox
+ *
+ * @returns Serialized size, 0 if it is truncated or invalid
+ ******************************************************************************/
+static size_t restore_entry(const uint8_t *in, size_t available);
+
+// -----------------------------------------------------------------------------
+//                                Global Variables
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+static const uint32_t class_ttl_s[APP_OUTBOX_CLASS_COUNT] = {
+  [APP_OUTBOX_CLASS_ALARM] = APP_OUTBOX_TTL_ALARM_S,
+  [APP_OUTBOX_CLASS_NORMAL] = APP_OUTBOX_TTL_NORMAL_S,
+  [APP_OUTBOX_CLASS_BULK] = APP_OUTBOX_TTL_BULK_S,
+};
+
+static const char *const class_names[APP_OUTBOX_CLASS_COUNT] = {
+  [APP_OUTBOX_CLASS_ALARM] = "alarm",
+  [APP_OUTBOX_CLASS_NORMAL] = "normal",
+  [APP_OUTBOX_CLASS_BULK] = "bulk",
+};
+
+static outbox_queue_t queues[APP_OUTBOX_CLASS_COUNT];
+static app_outbox_stats_t stats[APP_OUTBOX_CLASS_COUNT];
+// Class of the uplink returned by the last peek
+static app_outbox_class_t peeked = APP_OUTBOX_CLASS_COUNT;
+
+// Stored outbox, its size in the first byte
+static uint8_t stored[APP_OUTBOX_STORED_BYTES];
+// Uplinks queued or removed since the outbox was restored or saved
+static bool changed;
+// The stored outbox holds uplinks
+static bool stored_entries;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+bool app_outbox_push(app_outbox_class_t msg_class, app_outbox_kind_t kind, int32_t value, uint32_t now_ms)
+{
+  outbox_queue_t *queue = &queues[msg_class];
+  bool room = true;
+
+  changed = true;
+  if (queue->count == APP_OUTBOX_CLASS_DEPTH) {
+    // The oldest is the most likely to be stale
+    remove_oldest(msg_class);
+    stats[msg_class].dropped++;
+    room = false;
+  }
+  queue->entries[(queue->head + queue->count) % APP_OUTBOX_CLASS_DEPTH] = (app_outbox_entry_t) {
+    .kind = kind,
+    .value = value,
+    .queued_ms = now_ms,
+  };
+  queue->count++;
+
+  stats[msg_class].queued++;
+  if (queue->count > stats[msg_class].depth_max) {
+    stats[msg_class].depth_max = (uint32_t)queue->count;
+  }
+  return room;
+}
+
+const app_outbox_entry_t *app_outbox_peek(uint32_t now_ms, app_outbox_class_t *msg_class)
+{
+  peeked = APP_OUTBOX_CLASS_COUNT;
+  for (uint32_t i = 0; i < APP_OUTBOX_CLASS_COUNT; i++) {
+    outbox_queue_t *queue = &queues[i];
+    while (queue->count != 0
+           && (now_ms - queue->entries[queue->head].queued_ms) >= class_ttl_s[i] * 1000U) {
+      remove_oldest((app_outbox_class_t)i);
+      stats[i].expired++;
+    }
+    if (queue->count != 0) {
+      peeked = (app_outbox_class_t)i;
+      *msg_class = peeked;
+      return &queue->entries[queue->head];
+    }
+  }
+  return NULL;
+}
+
+void app_outbox_pop(uint32_t now_ms, bool sent)
+{
+  if (peeked == APP_OUTBOX_CLASS_COUNT || queues[peeked].count == 0) {
+    return;
+  }
+
+  app_outbox_stats_t *class_stats = &stats[peeked];
+  if (sent) {
+    uint32_t wait_ms = now_ms - queues[peeked].entries[queues[peeked].head].queued_ms;
+    if (class_stats->sent == 0 || wait_ms < class_stats->wait_min_ms) {
+      class_stats->wait_min_ms = wait_ms;
+    }
+    if (wait_ms > class_stats->wait_max_ms) {
+      class_stats->wait_max_ms = wait_ms;
+    }
+    class_stats->wait_sum_ms += wait_ms;
+    class_stats->sent++;
+  } else {
+    class_stats->dropped++;
+  }
+  remove_oldest(peeked);
+  peeked = APP_OUTBOX_CLASS_COUNT;
+}
+
+uint32_t app_outbox_ttl_left_s(app_outbox_class_t msg_class, const app_outbox_entry_t *entry, uint32_t now_ms)
+{
+  uint32_t age_s = (now_ms - entry->queued_ms) / 1000U;
+
+  return (age_s < class_ttl_s[msg_class]) ? (class_ttl_s[msg_class] - age_s) : 1U;
+}
+
+uint32_t app_outbox_ttl_s(app_outbox_class_t msg_class)
+{
+  return class_ttl_s[msg_class];
+}
+
+size_t app_outbox_depth(app_outbox_class_t msg_class)
+{
+  return queues[msg_class].count;
+}
+
+size_t app_outbox_count(void)
+{
+  size_t count = 0;
+
+  for (uint32_t i = 0; i < APP_OUTBOX_CLASS_COUNT; i++) {
+    count += queues[i].count;
+  }
+  return count;
+}
+
+void app_outbox_restore(void)
+{
+  size_t offset = STORED_HEADER_BYTES;
+
+  if (!app_nvm_read_partial(APP_NVM_KEY_OUTBOX, stored, STORED_HEADER_BYTES)
+      || stored[0] < STORED_HEADER_BYTES
+      || stored[0] > APP_OUTBOX_STORED_BYTES
+      || !app_nvm_read_partial(APP_NVM_KEY_OUTBOX, stored, stored[0])) {
+    return;
+  }
+
+  stored_entries = (stored[0] > STORED_HEADER_BYTES);
+  while (offset < stored[0]) {
+    size_t size = restore_entry(&stored[offset], stored[0] - offset);
+    if (size == 0) {
+      break;
+    }
+    offset += size;
+  }
+  changed = false;
+}
+
+size_t app_outbox_save(void)
+{
+  size_t size = STORED_HEADER_BYTES;
+  size_t dropped = 0;
+
+  if (!changed || (app_outbox_count() == 0 && !stored_entries)) {
+    return 0;
+  }
+
+  for (uint32_t i = 0; i < APP_OUTBOX_CLASS_COUNT; i++) {
+    outbox_queue_t *queue = &queues[i];
+    size_t kept = 0;
+    for (; kept < queue->count; kept++) {
+      const app_outbox_entry_t *entry = &queue->entries[(queue->head + kept) % APP_OUTBOX_CLASS_DEPTH];
+      size_t entry_size = store_entry(&stored[size], APP_OUTBOX_STORED_BYTES - size, (app_outbox_class_t)i, entry);
+      if (entry_size == 0) {
+        break;
+      }
+      size += entry_size;
+    }
+    // The newer uplinks of the class did not fit
+    while (queue->count > kept) {
+      remove_newest((app_outbox_class_t)i);
+      stats[i].dropped++;
+      dropped++;
+    }
+  }
+  peeked = APP_OUTBOX_CLASS_COUNT;
+
+  stored[0] = (uint8_t)size;
+  // Lost on EM4 if the write failed, the next wake-up carries on without them
+  if (app_nvm_write(APP_NVM_KEY_OUTBOX, stored, size)) {
+    stored_entries = (size > STORED_HEADER_BYTES);
+    changed = false;
+  }
+  return dropped;
+}
+
+const app_outbox_stats_t *app_outbox_get_stats(app_outbox_class_t msg_class)
+{
+  return &stats[msg_class];
+}
+
+const char *app_outbox_class_name(app_outbox_class_t msg_class)
+{
+  return (msg_class < APP_OUTBOX_CLASS_COUNT) ? class_names[msg_class] : "invalid";
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+static void remove_oldest(app_outbox_class_t msg_class)
+{
+  outbox_queue_t *queue = &queues[msg_class];
+
+  if (queue->entries[queue->head].kind == APP_OUTBOX_KIND_PAYLOAD) {
+    app_payload_release((app_payload_handle_t)queue->entries[queue->head].value);
+  }
+  queue->head = (queue->head + 1U) % APP_OUTBOX_CLASS_DEPTH;
+  queue->count--;
+  changed = true;
+}
+
+static void remove_newest(app_outbox_class_t msg_class)
+{
+  outbox_queue_t *queue = &queues[msg_class];
+  app_outbox_entry_t *entry = &queue->entries[(queue->head + queue->count - 1U) % APP_OUTBOX_CLASS_DEPTH];
+
+  if (entry->kind == APP_OUTBOX_KIND_PAYLOAD) {
+    app_payload_release((app_payload_handle_t)entry->value);
+  }
+  queue->count--;
+  changed = true;
+}
+
+static size_t store_entry(uint8_t *out, size_t capacity, app_outbox_class_t msg_class, const app_outbox_entry_t *entry)
+{
+  const uint8_t *data = NULL;
+  size_t data_size = 4U;
+
+  if (entry->kind == APP_OUTBOX_KIND_PAYLOAD) {
+    data = app_payload_data((app_payload_handle_t)entry->value);
+    data_size = 1U + app_payload_get_size((app_payload_handle_t)entry->value);
+    if (data == NULL) {
+      return 0;
+    }
+  }
+  // Below APP_OUTBOX_STORED_BYTES, so the payload size fits its byte
+  if (STORED_ENTRY_OVERHEAD + data_size > capacity) {
+    return 0;
+  }
+
+  size_t size = 0;
+  out[size++] = (uint8_t)msg_class;
+  out[size++] = (uint8_t)entry->kind;
+  if (data != NULL) {
+    out[size++] = (uint8_t)(data_size - 1U);
+    memcpy(&out[size], data, data_size - 1U);
+    size += data_size - 1U;
+  } else {
+    for (uint32_t i = 0; i < 4U; i++) {
+      out[size++] = (uint8_t)((uint32_t)entry->value >> (8U * i));
+    }
+  }
+  for (uint32_t i = 0; i < 4U; i++) {
+    out[size++] = (uint8_t)(entry->queued_ms >> (8U * i));
+  }
+  return size;
+}
+
+static size_t restore_entry(const uint8_t *in, size_t available)
+{
+  if (available < STORED_ENTRY_OVERHEAD + 1U || in[0] >= APP_OUTBOX_CLASS_COUNT) {
+    return 0;
+  }
+
+  app_outbox_class_t msg_class = (app_outbox_class_t)in[0];
+  app_outbox_entry_t entry = { .kind = (app_outbox_kind_t)in[1] };
+  size_t size = 2U;
+
+  if (entry.kind == APP_OUTBOX_KIND_PAYLOAD) {
+    size_t data_size = in[size++];
+    if (STORED_ENTRY_OVERHEAD + 1U + data_size > available) {
+      return 0;
+    }
+    app_payload_handle_t handle = app_payload_claim();
+    if (handle == APP_PAYLOAD_NONE) {
+      stats[msg_class].dropped++;
+    } else {
+      memcpy(app_payload_data(handle), &in[size], data_size);
+      app_payload_set_size(handle, data_size);
+    }
+    entry.value = (int32_t)handle;
+    size += data_size;
+  } else {
+    if (STORED_ENTRY_OVERHEAD + 4U > available) {
+      return 0;
+    }
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < 4U; i++) {
+      value |= (uint32_t)in[size++] << (8U * i);
+    }
+    entry.value = (int32_t)value;
+  }
+  for (uint32_t i = 0; i < 4U; i++) {
+    entry.queued_ms |= (uint32_t)in[size++] << (8U * i);
+  }
+
+  outbox_queue_t *queue = &queues[msg_class];
+  if ((entry.kind != APP_OUTBOX_KIND_PAYLOAD || entry.value != APP_PAYLOAD_NONE)
+      && queue->count < APP_OUTBOX_CLASS_DEPTH) {
+    queue->entries[(queue->head + queue->count) % APP_OUTBOX_CLASS_DEPTH] = entry;
+    queue->count++;
+  }
+  return size;
+}
@@ -0,0 +1,221 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_outbox.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef APP_OUTBOX_H
+#define APP_OUTBOX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Time an uplink may wait in the outbox before it is dropped as stale
+#ifndef APP_OUTBOX_TTL_ALARM_S
+#define APP_OUTBOX_TTL_ALARM_S      (300U)
+#endif
+#ifndef APP_OUTBOX_TTL_NORMAL_S
+#define APP_OUTBOX_TTL_NORMAL_S     (1800U)
+#endif
+#ifndef APP_OUTBOX_TTL_BULK_S
+#define APP_OUTBOX_TTL_BULK_S       (6U * 3600U)
+#endif
+
+// Uplinks waiting per class, the oldest is dropped beyond that
+#define APP_OUTBOX_CLASS_DEPTH      (4U)
+
+// Waiting uplinks kept in NVM3 across EM4, with the bytes of their payloads.
+// The object stays below the 254 bytes NVM3 accepts by default.
+#define APP_OUTBOX_STORED_BYTES     (240U)
+
+// First byte of an alarm uplink, followed by the alarm code and the age of the
+// alarm in s, 2 bytes big endian. Below 0x80 so that it is never taken for a
+// fragment header by the segmentation layer.
+#define APP_OUTBOX_ALARM_MARKER     (0x02U)
+#define APP_OUTBOX_ALARM_SIZE       (4U)
+// Alarm codes, one bit each while waiting for the main task
+#define APP_OUTBOX_ALARM_CODES      (32U)
+
+// Message classes, sent in this order
+typedef enum {
+  APP_OUTBOX_CLASS_ALARM = 0,   // Own uplink, fastest link, brings a link up
+  APP_OUTBOX_CLASS_NORMAL,      // Counter updates
+  APP_OUTBOX_CLASS_BULK,        // Batched reports, cheapest link
+  APP_OUTBOX_CLASS_COUNT
+} app_outbox_class_t;
+
+// What to build when the uplink goes out
+typedef enum {
+  APP_OUTBOX_KIND_ALARM = 0,    // value: alarm code
+  APP_OUTBOX_KIND_COUNTER,      // Counter, taken when the uplink goes out
+  APP_OUTBOX_KIND_REPORT,       // Pending samples, built at send time
+  APP_OUTBOX_KIND_PAYLOAD,      // value: payload handle, released when removed
+} app_outbox_kind_t;
+
+typedef struct {
+  app_outbox_kind_t kind;
+  int32_t value;
+  uint32_t queued_ms;         // Device time the uplink was requested
+} app_outbox_entry_t;
+
+typedef struct {
+  uint32_t queued;            // Uplinks requested
+  uint32_t sent;              // Uplinks handed to the stack
+  uint32_t expired;           // Uplinks dropped after their TTL
+  uint32_t dropped;           // Uplinks dropped on a full class or not stored on EM4 entry
+  uint32_t depth_max;         // Most uplinks waiting at once
+  uint32_t wait_min_ms;       // Request to hand-over of the sent uplinks
+  uint32_t wait_max_ms;
+  uint64_t wait_sum_ms;
+} app_outbox_stats_t;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to queue an uplink, main task only
+ *
+ * @param[in] msg_class Class of the uplink
+ * @param[in] kind What to build when it goes out
+ * @param[in] value Value of the uplink, see app_outbox_kind_t
+ * @param[in] now_ms Device time
+ *
+ * @returns #false if the class was full and its oldest uplink was dropped
+ ******************************************************************************/
+bool app_outbox_push(app_outbox_class_t msg_class, app_outbox_kind_t kind, int32_t value, uint32_t now_ms);
+
+/*******************************************************************************
+ * Function to get the next uplink to send
+ *
+ * Uplinks past their TTL are dropped first. The oldest uplink of the highest
+ * class goes first.
+ *
+ * @param[in] now_ms Device time
+ * @param[out] msg_class Class of the uplink
+ *
+ * @returns Next uplink, NULL if none is waiting
+ ******************************************************************************/
+const app_outbox_entry_t *app_outbox_peek(uint32_t now_ms, app_outbox_class_t *msg_class);
+
+/*******************************************************************************
+ * Function to remove the uplink returned by app_outbox_peek()
+ *
+ * @param[in] now_ms Device time
+ * @param[in] sent #true if it was handed to the stack, #false if dropped
+ ******************************************************************************/
+void app_outbox_pop(uint32_t now_ms, bool sent);
+
+/*******************************************************************************
+ * Function to get the TTL left to an uplink
+ *
+ * @param[in] msg_class Class of the uplink
+ * @param[in] entry Uplink
+ * @param[in] now_ms Device time
+ *
+ * @returns TTL left in s, at least 1
+ ******************************************************************************/
+uint32_t app_outbox_ttl_left_s(app_outbox_class_t msg_class, const app_outbox_entry_t *entry, uint32_t now_ms);
+
+/*******************************************************************************
+ * Function to get the TTL of a class
+ *
+ * @param[in] msg_class Class
+ *
+ * @returns TTL in s
+ ******************************************************************************/
+uint32_t app_outbox_ttl_s(app_outbox_class_t msg_class);
+
+/*******************************************************************************
+ * Function to get the uplinks waiting in a class
+ *
+ * @param[in] msg_class Class
+ *
+ * @returns Queue depth
+ ******************************************************************************/
+size_t app_outbox_depth(app_outbox_class_t msg_class);
+
+/*******************************************************************************
+ * Function to get the uplinks waiting in every class
+ *
+ * @returns Number of uplinks
+ ******************************************************************************/
+size_t app_outbox_count(void);
+
+/*******************************************************************************
+ * Function to load the uplinks kept in NVM3 by the last app_outbox_save()
+ *
+ * The uplinks keep the time they were requested, so their TTL runs on
+ * across EM4.
+ ******************************************************************************/
+void app_outbox_restore(void);
+
+/*******************************************************************************
+ * Function to keep the waiting uplinks in NVM3, before EM4
+ *
+ * The outbox is written only when it changed since the last restore or
+ * save. The newest uplinks of the lowest classes are dropped if they do not
+ * fit APP_OUTBOX_STORED_BYTES.
+ *
+ * @returns Number of uplinks dropped
+ ******************************************************************************/
+size_t app_outbox_save(void);
+
+/*******************************************************************************
+ * Function to get the counters of a class since boot
+ *
+ * @param[in] msg_class Class
+ *
+ * @returns Counters
+ ******************************************************************************/
+const app_outbox_stats_t *app_outbox_get_stats(app_outbox_class_t msg_class);
+
+/*******************************************************************************
+ * Function to get the name of a class
+ *
+ * @param[in] msg_class Class
+ *
+ * @returns Name
+ ******************************************************************************/
+const char *app_outbox_class_name(app_outbox_class_t msg_class);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_OUTBOX_H
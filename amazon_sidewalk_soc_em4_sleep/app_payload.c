@@ -0,0 +1,134 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_payload.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdatomic.h>
+
+#include "app_payload.h"
+#include "app_segment.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+_Static_assert(APP_PAYLOAD_POOL_SIZE <= 32U, "too many buffers for the in use mask");
+_Static_assert(APP_PAYLOAD_BUFFER_SIZE >= APP_SEGMENT_MAX_PAYLOAD, "buffer smaller than a segmented uplink");
+
+typedef struct {
+  uint8_t data[APP_PAYLOAD_BUFFER_SIZE];
+  size_t size;
+} payload_buffer_t;
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Global Variables
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+static payload_buffer_t pool[APP_PAYLOAD_POOL_SIZE];
+// Bit per buffer, set while claimed
+static atomic_uint in_use;
+static atomic_uint exhausted;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+app_payload_handle_t app_payload_claim(void)
+{
+  unsigned int mask = atomic_load_explicit(&in_use, memory_order_relaxed);
+
+  for (;;) {
+    uint32_t handle = 0;
+    while (handle < APP_PAYLOAD_POOL_SIZE && (mask & (1U << handle)) != 0) {
+      handle++;
+    }
+    if (handle == APP_PAYLOAD_POOL_SIZE) {
+      (void)atomic_fetch_add_explicit(&exhausted, 1U, memory_order_relaxed);
+      return APP_PAYLOAD_NONE;
+    }
+    // Acquire: the previous owner is done with the buffer. A failed exchange
+    // reloads the mask, another context claimed or released a buffer.
+    if (atomic_compare_exchange_weak_explicit(&in_use, &mask, mask | (1U << handle),
+                                              memory_order_acquire, memory_order_relaxed)) {
+      pool[handle].size = 0;
+      return (app_payload_handle_t)handle;
+    }
+  }
+}
+
+void app_payload_release(app_payload_handle_t handle)
+{
+  if (handle >= APP_PAYLOAD_POOL_SIZE) {
+    return;
+  }
+  // Release: the buffer is no longer touched once the next owner sees it free
+  (void)atomic_fetch_and_explicit(&in_use, ~(1U << handle), memory_order_release);
+}
+
+uint8_t *app_payload_data(app_payload_handle_t handle)
+{
+  return (handle < APP_PAYLOAD_POOL_SIZE) ? pool[handle].data : NULL;
+}
+
+void app_payload_set_size(app_payload_handle_t handle, size_t size)
+{
+  if (handle < APP_PAYLOAD_POOL_SIZE) {
+    pool[handle].size = (size > APP_PAYLOAD_BUFFER_SIZE) ? APP_PAYLOAD_BUFFER_SIZE : size;
+  }
+}
+
+size_t app_payload_get_size(app_payload_handle_t handle)
+{
+  return (handle < APP_PAYLOAD_POOL_SIZE) ? pool[handle].size : 0U;
+}
+
+size_t app_payload_in_use(void)
+{
+  unsigned int mask = atomic_load_explicit(&in_use, memory_order_relaxed);
+  size_t count = 0;
+
+  for (; mask != 0U; mask &= mask - 1U) {
+    count++;
+  }
+  return count;
+}
+
+uint32_t app_payload_get_exhausted(void)
+{
+  return (uint32_t)atomic_load_explicit(&exhausted, memory_order_relaxed);
+}
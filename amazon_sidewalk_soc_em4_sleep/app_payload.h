@@ -0,0 +1,124 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_payload.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+#ifndef APP_PAYLOAD_H
+#define APP_PAYLOAD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Preallocated uplink payload buffers, at most 32
+#define APP_PAYLOAD_POOL_SIZE       (4U)
+// Size of a buffer, a full segmented uplink with its diagnostics
+#define APP_PAYLOAD_BUFFER_SIZE     (256U)
+// No buffer
+#define APP_PAYLOAD_NONE            (0xFFU)
+
+// Handle of a buffer of the pool
+typedef uint8_t app_payload_handle_t;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to claim a free buffer
+ *
+ * Lock free, callable from any task or ISR. The producer fills the buffer and
+ * hands its handle over with the event, the main task releases it.
+ *
+ * @returns Handle, APP_PAYLOAD_NONE if every buffer is in use
+ ******************************************************************************/
+app_payload_handle_t app_payload_claim(void);
+
+/*******************************************************************************
+ * Function to return a buffer to the pool, callable from any task or ISR
+ *
+ * @param[in] handle Handle, APP_PAYLOAD_NONE is ignored
+ ******************************************************************************/
+void app_payload_release(app_payload_handle_t handle);
+
+/*******************************************************************************
+ * Function to get the data of a claimed buffer
+ *
+ * @param[in] handle Handle
+ *
+ * @returns APP_PAYLOAD_BUFFER_SIZE bytes, NULL for an invalid handle
+ ******************************************************************************/
+uint8_t *app_payload_data(app_payload_handle_t handle);
+
+/*******************************************************************************
+ * Function to set the number of bytes used in a claimed buffer
+ *
+ * @param[in] handle Handle
+ * @param[in] size Size, capped to APP_PAYLOAD_BUFFER_SIZE
+ ******************************************************************************/
+void app_payload_set_size(app_payload_handle_t handle, size_t size);
+
+/*******************************************************************************
+ * Function to get the number of bytes used in a claimed buffer
+ *
+ * @param[in] handle Handle
+ *
+ * @returns Size, 0 for an invalid handle
+ ******************************************************************************/
+size_t app_payload_get_size(app_payload_handle_t handle);
+
+/*******************************************************************************
+ * Function to get the number of buffers in use
+ *
+ * @returns Number of buffers
+ ******************************************************************************/
+size_t app_payload_in_use(void);
+
+/*******************************************************************************
+ * Function to get the number of claims that found no free buffer
+ *
+ * @returns Number of failed claims since boot
+ ******************************************************************************/
+uint32_t app_payload_get_exhausted(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_PAYLOAD_H
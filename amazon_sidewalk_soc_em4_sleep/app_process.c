@@ -33,6 +33,7 @@
 // -----------------------------------------------------------------------------
 #include <stdio.h>
 #include <string.h>
+#include <stdatomic.h>
 
 #include "sl_component_catalog.h"
 #if defined(SL_CATALOG_APP_BUTTON_PRESS_PRESENT) || defined(SL_CATALOG_SIMPLE_BUTTON_PRESENT)
@@ -47,6 +48,27 @@
 #include "sl_sidewalk_common_config.h"
 
 #include "em4_mode.h"
+#include "app_link_router.h"
+#include "app_segment.h"
+#include "app_report.h"
+#include "app_nvm.h"
+#include "app_trace.h"
+#include "app_retained.h"
+#include "app_diag.h"
+#include "app_airtime.h"
+#include "app_bench.h"
+#include "app_sample_ring.h"
+#include "app_schedule.h"
+#include "app_rendezvous.h"
+#include "app_radio_sleep.h"
+#include "app_tx_power.h"
+#include "app_outbox.h"
+#include "app_ack_policy.h"
+#include "app_supervisor.h"
+#include "app_battery.h"
+#include "em4_hooks.h"
+#include "app_connect.h"
+#include "timers.h"
 
 #if defined(SL_BOARD_SUPPORT)
 #include "sl_sidewalk_board_support.h"
@@ -54,6 +76,7 @@
 
 #if (defined(SL_FSK_SUPPORTED) || defined(SL_CSS_SUPPORTED))
 #include "app_subghz_config.h"
+#include "sid_pal_radio_ifc.h"
 #endif
 
 #if defined(SL_BLE_SUPPORTED)
@@ -71,7 +94,23 @@
 // Maximum number Queue elements
 #define MSG_QUEUE_LEN       (10U)
 
+// Samples moved from the ring per event, sid_process() runs in between
+#define SAMPLE_DRAIN_BATCH  (16U)
+
 #define UNUSED(x) (void)(x)
+
+// Outcome of an uplink taken from the outbox
+typedef enum {
+  OUTBOX_SENT = 0,    // Handed to the stack
+  OUTBOX_HELD,        // Held back by the airtime budget, stays first in line
+  OUTBOX_DROPPED,     // Failed or nothing to send
+} outbox_result_t;
+
+#if defined(SL_RADIO_EXTERNAL)
+// SX126x cold start sleep, see the readme. The radio sleeps warm if the PAL
+// does not provide it.
+extern int32_t sid_pal_radio_sleep_cold(uint32_t sleep_ms) __attribute__((weak));
+#endif
 // -----------------------------------------------------------------------------
 //                          Static Function Declarations
 // -----------------------------------------------------------------------------
@@ -85,11 +124,113 @@
 static void queue_event(QueueHandle_t queue, enum event_type event);
 
 /*******************************************************************************
- * Function to send updated counter
+ * Function to queue an event record with its payload or parameter
+ *
+ * @param[in] queue Event queue
+ * @param[in] event Event, copied
+ *
+ * @returns #false if the queue is full, the caller keeps the payload
+ ******************************************************************************/
+static bool post_event(QueueHandle_t queue, const app_event_t *event);
+
+/*******************************************************************************
+ * Function to send updated counter, the counter moves on once it is sent
+ *
+ * @param[in] app_context The context which is applicable for the current application
+ * @param[in] ttl_s TTL left to the uplink
+ *
+ * @returns Outcome of the uplink
+ ******************************************************************************/
+static outbox_result_t send_counter_update(app_context_t *app_context, uint32_t ttl_s);
+
+/*******************************************************************************
+ * Function to send the pending samples as a compressed report
+ *
+ * @param[in] app_context The context which is applicable for the current application
+ * @param[in] ttl_s TTL left to the uplink
+ *
+ * @returns Outcome of the uplink
+ ******************************************************************************/
+static outbox_result_t send_report(app_context_t *app_context, uint32_t ttl_s);
+
+/*******************************************************************************
+ * Function to send an alarm on the fastest link
+ *
+ * @param[in] app_context The context which is applicable for the current application
+ * @param[in] entry Outbox entry holding the alarm code
+ * @param[in] ttl_s TTL left to the uplink
+ *
+ * @returns Outcome of the uplink
+ ******************************************************************************/
+static outbox_result_t send_alarm(app_context_t *app_context, const app_outbox_entry_t *entry, uint32_t ttl_s);
+
+/*******************************************************************************
+ * Function to send a payload filled by a producer, from its pool buffer
+ *
+ * @param[in] app_context The context which is applicable for the current application
+ * @param[in] entry Outbox entry holding the payload handle
+ * @param[in] ttl_s TTL left to the uplink
+ *
+ * @returns Outcome of the uplink
+ ******************************************************************************/
+static outbox_result_t send_payload(app_context_t *app_context, const app_outbox_entry_t *entry, uint32_t ttl_s);
+
+/*******************************************************************************
+ * Function to fill the diagnostics in and hand an uplink to the stack
+ *
+ * @param[in] app_context The context which is applicable for the current application
+ * @param[in] link Link picked for the uplink
+ * @param[in] mtu MTU of the link, the diagnostics fill the frame up to it
+ * @param[in,out] payload Uplink, room for mtu bytes
+ * @param[in,out] size Uplink size, diagnostics included on return
+ * @param[in] ttl_s TTL left to the uplink
+ * @param[in] critical #true to request an ack whatever the link health
+ * @param[in] diag #false to send the payload as is, for payloads whose layout
+ *                 is not known to the diagnostics decoder
+ * @param[out] desc Message descriptor
+ *
+ * @returns SID_ERROR_NONE once queued in the stack
+ ******************************************************************************/
+static sid_error_t put_uplink(app_context_t *app_context,
+                              enum sid_link_type link,
+                              size_t mtu,
+                              uint8_t *payload,
+                              size_t *size,
+                              uint32_t ttl_s,
+                              bool critical,
+                              bool diag,
+                              struct sid_msg_desc *desc);
+
+/*******************************************************************************
+ * Function to queue an uplink in the outbox
+ *
+ * @param[in] msg_class Class of the uplink
+ * @param[in] kind What to build when it goes out
+ * @param[in] value Value of the uplink
+ ******************************************************************************/
+static void outbox_push(app_outbox_class_t msg_class, app_outbox_kind_t kind, int32_t value);
+
+/*******************************************************************************
+ * Function to send the waiting uplinks, highest class first
+ *
+ * Stops on the first uplink held back by the airtime budget or when the stack
+ * is not ready. Uplinks past their TTL are dropped on the way.
+ *
+ * @param[in] app_context The context which is applicable for the current application
+ ******************************************************************************/
+static void outbox_pump(app_context_t *app_context);
+
+/*******************************************************************************
+ * Function to bring a link up for a waiting alarm
  *
  * @param[in] app_context The context which is applicable for the current application
  ******************************************************************************/
-static void send_counter_update(app_context_t *app_context);
+static void alarm_bring_up(app_context_t *app_context);
+
+/*******************************************************************************
+ * Function to print the outbox counters per class
+ ******************************************************************************/
+static void outbox_stats(void);
 
 /*******************************************************************************
  * Function to get time
@@ -166,14 +307,233 @@ static void on_sidewalk_factory_reset(void *context);
  *
  * @param[out] app_context The context which is applicable for the current application
  * @param[out] config The configuration parameters
+ * @param[in] target Link to switch to (SID_LINK_TYPE_x), 0 for the next one
  *
  * @returns #true           on success
  * @returns #false          on failure
  ******************************************************************************/
-static bool link_switch(app_context_t *app_context, struct sid_config *config);
+static bool link_switch(app_context_t *app_context, struct sid_config *config, uint32_t target);
+
+/*******************************************************************************
+ * Function to tell whether a link is built into the application
+ *
+ * @param[in] link Link (SID_LINK_TYPE_x)
+ *
+ * @returns #true if supported
+ ******************************************************************************/
+static bool link_is_built(uint32_t link);
+
+/*******************************************************************************
+ * Function to start the stack on a set of links, a failure is handed to the
+ * supervisor
+ *
+ * @param[in] app_context The context which is applicable for the current application
+ * @param[in] config Sidewalk configuration
+ * @param[in] link_mask Links to start
+ * @param[in] preferred_link Link preferred by the router
+ *
+ * @returns #true if the stack started
+ ******************************************************************************/
+static bool stack_start(app_context_t *app_context, struct sid_config *config, uint32_t link_mask, uint32_t preferred_link);
+
+/*******************************************************************************
+ * Function to schedule a restart of the failed stack, or to give up until the
+ * next wake-up, see app_supervisor.h
+ *
+ * @param[in] app_context The context which is applicable for the current application
+ * @param[in] link_mask Links that failed to start
+ * @param[in] preferred_link Link preferred by the router
+ ******************************************************************************/
+static void stack_failed(app_context_t *app_context, uint32_t link_mask, uint32_t preferred_link);
+
+/*******************************************************************************
+ * Function to restart the stack once the backoff is over
+ *
+ * @param[in] app_context The context which is applicable for the current application
+ * @param[in] config Sidewalk configuration
+ ******************************************************************************/
+static void stack_restart(app_context_t *app_context, struct sid_config *config);
+
+/*******************************************************************************
+ * Function to sleep in EM4 with the stack down, the next boot starts it again
+ *
+ * @param[in] sleep_ms EM4 sleep time
+ ******************************************************************************/
+static void supervisor_sleep(uint32_t sleep_ms);
+
+/*******************************************************************************
+ * Function to print the restart counters of the stack
+ ******************************************************************************/
+static void supervisor_stats(void);
+
+/*******************************************************************************
+ * Restart timer callback, the backoff is over
+ *
+ * @param[in] timer Timer handle
+ ******************************************************************************/
+static void restart_timer_callback(TimerHandle_t timer);
 
 static void em4_sleep(app_context_t *app_context);
 
+/*******************************************************************************
+ * Function to get the regular EM4 sleep: the wake-up interval of the battery
+ * tier, cut short by the scheduled uplink
+ *
+ * @param[in] in_ms Time from now to the EM4 entry
+ *
+ * @returns Sleep in ms
+ ******************************************************************************/
+static uint32_t regular_sleep_ms(uint32_t in_ms);
+
+/*******************************************************************************
+ * Function to get the time to the regular wake-up after an uplink: the
+ * inactivity timeout of the battery tier, then one regular sleep
+ *
+ * @returns Time in ms
+ ******************************************************************************/
+static uint32_t rendezvous_lead_ms(void);
+
+/*******************************************************************************
+ * EM4 suspend hooks of the application, see em4_hooks.h
+ *
+ * @param[in] context The application context
+ *
+ * @returns #false to stay awake
+ ******************************************************************************/
+static bool em4_stack_stop(void *context);
+static bool em4_radio_sleep(void *context);
+static bool em4_stack_deinit(void *context);
+static bool em4_save_state(void *context);
+
+#if defined(SL_RADIO_EXTERNAL)
+/*******************************************************************************
+ * Function to put the SX126x to sleep before EM4, cold or warm start
+ * depending on the sleep duration
+ *
+ * @param[in] sleep_ms Planned EM4 sleep
+ *
+ * @returns Depth the radio sleeps in, APP_RADIO_SLEEP_NONE on failure
+ ******************************************************************************/
+static app_radio_sleep_depth_t radio_sleep(uint32_t sleep_ms);
+
+/*******************************************************************************
+ * Function to account and print the radio re-init time after EM4
+ *
+ * @param[in] start_ms Time taken to initialize and start the sub-GHz link
+ ******************************************************************************/
+static void radio_start_stats(uint32_t start_ms);
+#endif
+
+/*******************************************************************************
+ * Function to persist the registration outcome, written only on change
+ *
+ * @param[in] registered Registration status reported by the stack
+ ******************************************************************************/
+static void store_registration(bool registered);
+
+/*******************************************************************************
+ * Function to get the name of an event, used as trace legend
+ *
+ * @param[in] event The event
+ *
+ * @returns Event name
+ ******************************************************************************/
+static const char *event_type_name(enum event_type event);
+
+/*******************************************************************************
+ * Function to print the trace legend and records
+ ******************************************************************************/
+static void trace_dump(void);
+
+/*******************************************************************************
+ * Function to hold an uplink back when its link is over the airtime budget
+ *
+ * A held back uplink is retried once the budget allows it, the uplinks queued
+ * meanwhile wait in the outbox behind it.
+ *
+ * @param[in] link Link the uplink goes out on
+ * @param[in] airtime_us Estimated airtime of the uplink
+ * @param[in] retry_event Event that sends the uplink again
+ *
+ * @returns #true if the uplink may be sent now
+ ******************************************************************************/
+static bool airtime_admit(uint32_t link, uint32_t airtime_us, enum event_type retry_event);
+
+/*******************************************************************************
+ * Function to queue the uplinks held back by the airtime budget
+ ******************************************************************************/
+static void airtime_retry(void);
+
+/*******************************************************************************
+ * Function to print the airtime counters of the started links
+ *
+ * @param[in] context The context which is applicable for the current application
+ ******************************************************************************/
+static void airtime_stats(app_context_t *context);
+
+/*******************************************************************************
+ * Airtime timer callback, the budget allows the held back uplinks again
+ *
+ * @param[in] timer Timer handle
+ ******************************************************************************/
+static void airtime_timer_callback(TimerHandle_t timer);
+
+/*******************************************************************************
+ * Function to set the radio of a link to the power picked by app_tx_power.c
+ *
+ * @param[in] link Link the next uplink goes out on
+ ******************************************************************************/
+static void tx_power_apply(uint32_t link);
+
+/*******************************************************************************
+ * Function to print a TX power change
+ *
+ * @param[in] link Link whose power changed
+ * @param[in] reason What triggered the change
+ ******************************************************************************/
+static void tx_power_changed(uint32_t link, const char *reason);
+
+/*******************************************************************************
+ * Function to move samples from the ring into the report batch
+ *
+ * @param[in] all Drain the whole ring, otherwise one batch and queue another
+ *                event for the rest
+ ******************************************************************************/
+static void drain_samples(bool all);
+
+/*******************************************************************************
+ * Function to send the scheduled uplink if it is due, once the stack is ready
+ *
+ * @param[in] app_context The context which is applicable for the current application
+ ******************************************************************************/
+static void scheduled_send(app_context_t *app_context);
+
+/*******************************************************************************
+ * Function to start the schedule timer on the next due time
+ ******************************************************************************/
+static void schedule_arm(void);
+
+/*******************************************************************************
+ * Schedule timer callback, the scheduled uplink is due
+ *
+ * @param[in] timer Timer handle
+ ******************************************************************************/
+static void schedule_timer_callback(TimerHandle_t timer);
+
+/*******************************************************************************
+ * Function to extend the awake time, from the CLI, a button or a downlink
+ *
+ * @param[in] seconds Lease from now
+ ******************************************************************************/
+static void awake_lease(uint32_t seconds);
+
+/*******************************************************************************
+ * Rendezvous timer callback, the device may try EM4 again
+ *
+ * @param[in] timer Timer handle
+ ******************************************************************************/
+static void rendezvous_timer_callback(TimerHandle_t timer);
+
 /*******************************************************************************
  * Function to convert link_type configuration to sidewalk stack link_mask
  *
@@ -190,6 +550,31 @@ static uint32_t link_type_to_link_mask(uint8_t link_type);
  * @param[in] context The context which is applicable for the current application
  ******************************************************************************/
 static void toggle_connection_request(app_context_t *context);
+
+/*******************************************************************************
+ * Function to start the deadline of the pending connect-and-send
+ ******************************************************************************/
+static void connect_arm(void);
+
+/*******************************************************************************
+ * Function to retry, fall back or give up once the BLE connection missed
+ * its deadline
+ *
+ * @param[in] context The context which is applicable for the current application
+ ******************************************************************************/
+static void connect_deadline(app_context_t *context);
+
+/*******************************************************************************
+ * Function to print the connect-and-send statistics
+ ******************************************************************************/
+static void connect_stats(void);
+
+/*******************************************************************************
+ * Connect timer callback, the BLE connection missed its deadline
+ *
+ * @param[in] timer Timer handle
+ ******************************************************************************/
+static void connect_timer_callback(TimerHandle_t timer);
 #endif
 // -----------------------------------------------------------------------------
 //                                Global Variables
@@ -204,18 +589,64 @@ static QueueHandle_t g_event_queue;
 #if defined(SL_BLE_SUPPORTED)
 // button send update request
 static bool button_send_update_req;
+static TimerHandle_t connect_timer;
 #endif
 
 static app_context_t application_context;
+
+// Registration outcome persisted in NVM3
+static bool device_registered;
+// Time from boot to the first ready status, 0 until then
+static uint32_t boot_to_ready_ms;
+// Uplinks held back by the airtime budget, bit per event type
+static uint32_t airtime_deferred_events;
+_Static_assert(EVENT_TYPE_INVALID <= 32, "too many events for the deferral mask");
+static TimerHandle_t airtime_timer;
+// A samples event is queued and not yet handled
+static atomic_bool samples_event_pending;
+static TimerHandle_t schedule_timer;
+// The scheduled uplink is due and waits for the stack to be ready
+static bool schedule_waiting;
+// Alarms raised outside the main task, bit per alarm code
+static atomic_uint alarm_request;
+_Static_assert(APP_OUTBOX_ALARM_CODES <= 32, "too many alarm codes for the request mask");
+_Static_assert(APP_OUTBOX_ALARM_MARKER < APP_SEGMENT_HEADER_MARKER && APP_OUTBOX_ALARM_MARKER != APP_DIAG_MARKER,
+               "alarm marker taken for a fragment header or a diagnostic block");
+// Stack restart under way, the links to bring back
+static struct {
+  bool active;
+  bool fallback;              // Restart on fallback_link alone
+  uint32_t link_mask;
+  uint32_t preferred_link;
+  uint32_t fallback_link;
+} restart;
+static TimerHandle_t restart_timer;
+// Holds off EM4 until the promised window or the lease is over
+static TimerHandle_t rendezvous_timer;
+// EM4 entry under way, shared by the suspend hooks
+static struct {
+  uint32_t sleep_ms;
+  app_radio_sleep_depth_t radio_depth;
+} em4_plan;
+static const em4_hook_t em4_app_hooks[] = {
+  { "sid_stop", EM4_HOOK_PRIORITY_STACK, em4_stack_stop, NULL, &application_context },
+  { "radio_sleep", EM4_HOOK_PRIORITY_RADIO, em4_radio_sleep, NULL, &application_context },
+  { "sid_deinit", EM4_HOOK_PRIORITY_STACK_DEINIT, em4_stack_deinit, NULL, &application_context },
+  { "save_state", EM4_HOOK_PRIORITY_STATE, em4_save_state, NULL, &application_context },
+};
 // -----------------------------------------------------------------------------
 //                          Public Function Definitions
 // -----------------------------------------------------------------------------
-static int32_t init_and_start_link(app_context_t *context, struct sid_config *config, uint32_t link_mask)
+static int32_t init_and_start_link(app_context_t *context, struct sid_config *config, uint32_t link_mask, uint32_t preferred_link)
 {
   if (config->link_mask != link_mask) {
     sid_error_t ret = SID_ERROR_NONE;
     if (context->sidewalk_handle != NULL) {
       ret = sid_deinit(context->sidewalk_handle);
+      // Gone whatever the outcome, the error path must not deinit it again
+      context->sidewalk_handle = NULL;
+      app_segment_reset();
+      app_trace_record(APP_TRACE_LINK_STOP, 0, (uint16_t)config->link_mask);
       if (ret != SID_ERROR_NONE) {
         SL_SID_LOG_APP_ERROR("sidewalk deinitialization failed, link mask: %x, error: %d", (int)link_mask, (int)ret);
         goto error;
@@ -225,6 +656,9 @@ static int32_t init_and_start_link(app_context_t *context, struct sid_config *co
 
     struct sid_handle *sid_handle = NULL;
     config->link_mask = link_mask;
+#if defined(SL_RADIO_EXTERNAL)
+    TickType_t start_ticks = xTaskGetTickCount();
+#endif
     // Initialise sidewalk
     ret = sid_init(config, &sid_handle);
     if (ret != SID_ERROR_NONE) {
@@ -233,6 +667,9 @@ static int32_t init_and_start_link(app_context_t *context, struct sid_config *co
     }
     SL_SID_LOG_APP_INFO("sidewalk initializated, link mask: %x", (int)link_mask);
 
+    // Register sidewalk handler to the application context
+    context->sidewalk_handle = sid_handle;
+
 #if (defined(SL_SIDEWALK_COMMON_DEFAULT_LINK_CONNECTION_POLICY) && (SL_SIDEWALK_COMMON_DEFAULT_LINK_CONNECTION_POLICY == SID_LINK_CONNECTION_POLICY_MULTI_LINK_MANAGER)) \
     && defined(SL_SIDEWALK_COMMON_DEFAULT_MULTI_LINK_POLICY)
     enum sid_link_connection_policy link_conn_policy = SL_SIDEWALK_COMMON_DEFAULT_LINK_CONNECTION_POLICY;
@@ -258,9 +695,6 @@ static int32_t init_and_start_link(app_context_t *context, struct sid_config *co
     }
 #endif
 
-    // Register sidewalk handler to the application context
-    context->sidewalk_handle = sid_handle;
-
     // Start the sidewalk stack
     ret = sid_start(sid_handle, link_mask);
     if (ret != SID_ERROR_NONE) {
@@ -268,6 +702,16 @@ static int32_t init_and_start_link(app_context_t *context, struct sid_config *co
       goto error;
     }
     SL_SID_LOG_APP_INFO("sidewalk started, link mask: %x", (int)link_mask);
+    app_trace_record(APP_TRACE_LINK_START, 0, (uint16_t)link_mask);
+#if defined(SL_RADIO_EXTERNAL)
+    if (link_mask & (SID_LINK_TYPE_2 | SID_LINK_TYPE_3)) {
+      radio_start_stats((uint32_t)(xTaskGetTickCount() - start_ticks) * portTICK_PERIOD_MS);
+    }
+#endif
+
+    app_link_router_init(link_mask, preferred_link);
+  } else {
+    (void)app_link_router_set_preferred(preferred_link);
   }
   application_context.current_link_type = link_mask;
 #if defined(SL_BLE_SUPPORTED)
@@ -277,6 +721,11 @@ static int32_t init_and_start_link(app_context_t *context, struct sid_config *co
   return 0;
 
   error:
+  if (context->sidewalk_handle != NULL) {
+    // No half started stack left behind, the supervisor starts over
+    (void)sid_deinit(context->sidewalk_handle);
+    app_segment_reset();
+  }
   context->sidewalk_handle = NULL;
   config->link_mask = 0;
   return -1;
@@ -315,6 +764,8 @@ void main_thread(void *context)
   application_context.sidewalk_handle = NULL;
   application_context.state           = STATE_INIT;
 
+  app_trace_init();
+
   // Register the callback functions and the context
   struct sid_event_callbacks event_callbacks =
   {
@@ -352,7 +803,7 @@ void main_thread(void *context)
 #endif
 
   // Queue creation for the sidewalk events
-  g_event_queue = xQueueCreate(MSG_QUEUE_LEN, sizeof(enum event_type));
+  g_event_queue = xQueueCreate(MSG_QUEUE_LEN, sizeof(app_event_t));
   app_assert(g_event_queue != NULL, "queue creation failed");
 
 #if defined(SL_BLE_SUPPORTED)
@@ -392,36 +843,171 @@ void main_thread(void *context)
   // Assign queue to the application context
   application_context.event_queue = g_event_queue;
 
-  if (init_and_start_link(&application_context, &config, link_type_to_link_mask(SL_SIDEWALK_COMMON_REGISTRATION_LINK)) != 0) {
-    goto error;
+  airtime_timer = xTimerCreate("airtime", 1, pdFALSE, NULL, airtime_timer_callback);
+  app_assert(airtime_timer != NULL, "airtime timer creation failed");
+  schedule_timer = xTimerCreate("schedule", 1, pdFALSE, NULL, schedule_timer_callback);
+  app_assert(schedule_timer != NULL, "schedule timer creation failed");
+  rendezvous_timer = xTimerCreate("rendezvous", 1, pdFALSE, NULL, rendezvous_timer_callback);
+  app_assert(rendezvous_timer != NULL, "rendezvous timer creation failed");
+  restart_timer = xTimerCreate("restart", 1, pdFALSE, NULL, restart_timer_callback);
+  app_assert(restart_timer != NULL, "restart timer creation failed");
+
+  for (uint32_t i = 0; i < sizeof(em4_app_hooks) / sizeof(em4_app_hooks[0]); i++) {
+    (void)em4_hooks_register(&em4_app_hooks[i]);
+  }
+  em4_hooks_resume();
+#if defined(SL_BLE_SUPPORTED)
+  connect_timer = xTimerCreate("connect", pdMS_TO_TICKS(APP_CONNECT_DEADLINE_MS), pdFALSE, NULL, connect_timer_callback);
+  app_assert(connect_timer != NULL, "connect timer creation failed");
+#endif
+
+  app_supervisor_stats_t supervisor;
+  uint8_t registered = 0;
+  device_registered = app_nvm_read(APP_NVM_KEY_REGISTERED, &registered, sizeof(registered)) && (registered != 0);
+  // Samples batched and uplinks waiting over the previous wake-ups
+  app_report_restore();
+  app_outbox_restore();
+
+  // Start all links concurrently right away unless registration needs a link
+  // that is not part of the default link set (CSS default). A device known to
+  // be registered skips the registration link altogether.
+  uint32_t boot_link = link_type_to_link_mask(SL_SIDEWALK_COMMON_REGISTRATION_LINK);
+  uint32_t boot_mask = boot_link;
+  if (device_registered) {
+    SL_SID_LOG_APP_INFO("device already registered, starting on default link");
+    boot_link = link_type_to_link_mask(SL_SIDEWALK_LINK_TO_USE);
+    boot_mask = app_link_router_supported_mask(boot_link);
+  } else if (SL_SIDEWALK_COMMON_DEFAULT_LINK_TYPE == SL_SIDEWALK_COMMON_REGISTRATION_LINK) {
+    boot_mask = app_link_router_supported_mask(boot_link);
+  }
+  app_supervisor_get_stats(app_retained_now_ms(), &supervisor);
+  if (supervisor.restarts != 0) {
+    app_diag_set(APP_DIAG_STACK_RESTARTS, supervisor.restarts);
   }
+  (void)stack_start(&application_context, &config, boot_mask, boot_link);
 
   SL_SID_LOG_APP_INFO("main task started");
 
   //Adding the timeout mechanism to go to EM4 sleep when Sidewalk is inactive for too long
   start_burtc_timeout();
 
+  if (app_schedule_ms_until_due() != UINT32_MAX) {
+    SL_SID_LOG_APP_INFO("uplink schedule, period: %lu s, slot: %lu ms, next in: %lu ms, missed: %lu",
+                        (unsigned long)(APP_SCHEDULE_PERIOD_MS / 1000U),
+                        (unsigned long)app_schedule_get_slot_ms(),
+                        (unsigned long)app_schedule_ms_until_due(),
+                        (unsigned long)app_schedule_get_missed());
+    schedule_arm();
+  }
+
   while (1) {
-    enum event_type event = EVENT_TYPE_INVALID;
+    app_event_t event = { .type = EVENT_TYPE_INVALID, .payload = APP_PAYLOAD_NONE, .arg = 0 };
 
     if (xQueueReceive(application_context.event_queue, &event, portMAX_DELAY) == pdTRUE) {
+      // Inputs are staged before their event is queued, they come first
+      app_trace_drain_inputs();
+      app_trace_record(APP_TRACE_EVENT_BEGIN, (uint8_t)event.type, 0);
       // State machine for Sidewalk events
-      switch (event) {
+      switch (event.type) {
         case EVENT_TYPE_SIDEWALK:
           SL_SID_LOG_APP_DEBUG("sidewalk process event");
           sid_process(application_context.sidewalk_handle);
+          // Callbacks may have released room for pending fragments
+          app_segment_resume(application_context.sidewalk_handle);
+          app_bench_pump(application_context.sidewalk_handle);
           break;
 
         case EVENT_TYPE_SEND_COUNTER_UPDATE:
           SL_SID_LOG_APP_INFO("counter update event");
 
+          outbox_push(APP_OUTBOX_CLASS_NORMAL, APP_OUTBOX_KIND_COUNTER, 0);
+          outbox_pump(&application_context);
+          break;
+
+        case EVENT_TYPE_SEND_REPORT:
+          SL_SID_LOG_APP_INFO("send report event");
+
+          outbox_push(APP_OUTBOX_CLASS_BULK, APP_OUTBOX_KIND_REPORT, 0);
+          outbox_pump(&application_context);
+          break;
+
+        case EVENT_TYPE_SEND:
+          SL_SID_LOG_APP_INFO("send event, size: %u", (unsigned int)app_payload_get_size(event.payload));
+
+          // The outbox owns the buffer from here and releases it once removed
+          outbox_push(APP_OUTBOX_CLASS_NORMAL, APP_OUTBOX_KIND_PAYLOAD, (int32_t)event.payload);
+          event.payload = APP_PAYLOAD_NONE;
+          outbox_pump(&application_context);
+          break;
+
+        case EVENT_TYPE_ALARM:
+        {
+          uint32_t codes = atomic_exchange(&alarm_request, 0U);
+
+          for (uint32_t code = 0; code < APP_OUTBOX_ALARM_CODES; code++) {
+            if ((codes & (1UL << code)) != 0) {
+              SL_SID_LOG_APP_INFO("alarm event, code: %lu", (unsigned long)code);
+              outbox_push(APP_OUTBOX_CLASS_ALARM, APP_OUTBOX_KIND_ALARM, (int32_t)code);
+            }
+          }
+          outbox_pump(&application_context);
+          break;
+        }
+
+        case EVENT_TYPE_OUTBOX:
+          outbox_pump(&application_context);
+          break;
+
+        case EVENT_TYPE_OUTBOX_STATS:
+          outbox_stats();
+          break;
+
+        case EVENT_TYPE_STACK_RESTART:
+          stack_restart(&application_context, &config);
+          break;
+
+        case EVENT_TYPE_SUPERVISOR_STATS:
+          supervisor_stats();
+          break;
+
+        case EVENT_TYPE_TRACE_DUMP:
+          trace_dump();
+          break;
+
+        case EVENT_TYPE_AIRTIME_RETRY:
+          airtime_retry();
+          break;
+
+        case EVENT_TYPE_AIRTIME_STATS:
+          airtime_stats(&application_context);
+          break;
+
+        case EVENT_TYPE_BENCH_START:
+          SL_SID_LOG_APP_INFO("bench start event");
+
           if (application_context.state == STATE_SIDEWALK_READY) {
-            send_counter_update(&application_context);
+            (void)app_bench_start(application_context.sidewalk_handle);
           } else {
             SL_SID_LOG_APP_WARNING("sidewalk not ready yet");
           }
           break;
 
+        case EVENT_TYPE_BENCH_STOP:
+          app_bench_stop();
+          break;
+
+        case EVENT_TYPE_SAMPLES:
+          drain_samples(false);
+          break;
+
+        case EVENT_TYPE_SCHEDULED_SEND:
+          scheduled_send(&application_context);
+          break;
+
+        case EVENT_TYPE_AWAKE_LEASE:
+          awake_lease(event.arg);
+          break;
+
         case EVENT_TYPE_GET_TIME:
           SL_SID_LOG_APP_INFO("get time event");
 
@@ -443,9 +1029,8 @@ void main_thread(void *context)
         case EVENT_TYPE_LINK_SWITCH:
           SL_SID_LOG_APP_INFO("link switch event");
 
-          if (link_switch(&application_context, &config) != true) {
-            goto error;
-          }
+          // A failed restart is left to the supervisor
+          (void)link_switch(&application_context, &config, event.arg);
           break;
 
         case EVENT_TYPE_EM4_TIMEOUT:
@@ -458,38 +1043,47 @@ void main_thread(void *context)
           SL_SID_LOG_APP_INFO("device registered event");
 
           if (SL_SIDEWALK_COMMON_DEFAULT_LINK_TYPE != SL_SIDEWALK_COMMON_REGISTRATION_LINK) {
-            if (init_and_start_link(&application_context, &config, link_type_to_link_mask(SL_SIDEWALK_LINK_TO_USE)) != 0) {
-              goto error;
-            }
+            uint32_t default_link = link_type_to_link_mask(SL_SIDEWALK_LINK_TO_USE);
+            (void)stack_start(&application_context, &config, app_link_router_supported_mask(default_link), default_link);
+          }
+          break;
+
+        case EVENT_TYPE_REGISTRATION_FALLBACK:
+        {
+          SL_SID_LOG_APP_WARNING("device not registered, falling back on registration link");
+
+          uint32_t registration_link = link_type_to_link_mask(SL_SIDEWALK_COMMON_REGISTRATION_LINK);
+          if ((application_context.current_link_type & registration_link) == 0) {
+            (void)stack_start(&application_context, &config, registration_link, registration_link);
           }
           break;
+        }
 
 #if defined(SL_BLE_SUPPORTED)
         case EVENT_TYPE_CONNECTION_REQUEST:
           SL_SID_LOG_APP_INFO("BLE connection request event");
 
           toggle_connection_request(&application_context);
+          if (button_send_update_req && !app_connect_is_pending()) {
+            app_connect_begin((uint32_t)xTaskGetTickCount() * portTICK_PERIOD_MS);
+            connect_arm();
+          }
           break;
-#endif
+
+        case EVENT_TYPE_CONNECT_DEADLINE:
+          connect_deadline(&application_context);
+          break;
+#endif
 
         default:
-          SL_SID_LOG_APP_ERROR("unexpected event: %d", (int)event);
+          SL_SID_LOG_APP_ERROR("unexpected event: %d", (int)event.type);
           break;
       }
+      // A payload no handler took over goes back to the pool
+      app_payload_release(event.payload);
+      app_trace_record(APP_TRACE_EVENT_END, (uint8_t)event.type, 0);
     }
   }
-
-  error:
-  // If error happens deinit sidewalk
-  if (application_context.sidewalk_handle != NULL) {
-    sid_stop(application_context.sidewalk_handle, config.link_mask);
-    sid_deinit(application_context.sidewalk_handle);
-    application_context.sidewalk_handle = NULL;
-  }
-  SL_SID_LOG_APP_ERROR("unrecoverable error occurred");
-
-  sid_platform_deinit();
-  vTaskDelete(NULL);
 }
 
 #if defined(SL_CATALOG_SIMPLE_BUTTON_PRESENT)
@@ -509,8 +1103,11 @@ void app_button_press_cb(uint8_t button, uint8_t duration)
       app_trigger_connect_and_send();
     }
 #else // All others target others than KG100S
-    (void)duration;
-    app_trigger_em4_sleep();
+    if (duration != APP_BUTTON_PRESS_DURATION_SHORT) { // long press
+      app_trigger_awake_lease(APP_RENDEZVOUS_BUTTON_LEASE_S);
+    } else { // short press
+      app_trigger_em4_sleep();
+    }
 #endif  // !defined(SL_CATALOG_BTN1_PRESENT)
   } else { // PB1
 #if !defined(SL_CATALOG_BTN1_PRESENT) //KG100S
@@ -524,28 +1121,32 @@ void app_button_press_cb(uint8_t button, uint8_t duration)
 
 void app_trigger_connect_and_send(void)
 {
-  if (application_context.current_link_type & SID_LINK_TYPE_1) { // BLE
+  app_trace_input(APP_TRACE_INPUT_CONNECT_AND_SEND, 0);
+  // Queued directly, the trace holds the input that caused them
+  if (app_link_router_get_preferred() == SID_LINK_TYPE_1) { // BLE
 #if defined(SL_BLE_SUPPORTED)
-    if (application_context.state != STATE_SIDEWALK_READY) {
+    if (application_context.state != STATE_SIDEWALK_READY
+        || !app_link_router_is_up(SID_LINK_TYPE_1)) {
       if (!button_send_update_req) {
         button_send_update_req = true;
-        app_trigger_connection_request();
+        queue_event(g_event_queue, EVENT_TYPE_CONNECTION_REQUEST);
       } else {
         SL_SID_LOG_APP_WARNING("connection request already in progress");
       }
     } else {
-      app_trigger_send_counter_update();
+      queue_event(g_event_queue, EVENT_TYPE_SEND_COUNTER_UPDATE);
     }
 #endif // defined(SL_BLE_SUPPORTED)
   } else { // FSK or CSS
-    app_trigger_send_counter_update();
+    queue_event(g_event_queue, EVENT_TYPE_SEND_COUNTER_UPDATE);
   }
 }
 
 #if defined(SL_BLE_SUPPORTED)
 static void toggle_connection_request(app_context_t *context)
 {
-  if (context->state == STATE_SIDEWALK_READY) {
+  // Ready may come from a sub-GHz link, only BLE being up counts here
+  if (context->state == STATE_SIDEWALK_READY && app_link_router_is_up(SID_LINK_TYPE_1)) {
     SL_SID_LOG_APP_WARNING("BLE connection is already established");
   } else {
     context->connection_request = true;
@@ -559,6 +1160,79 @@ static void toggle_connection_request(app_context_t *context)
     SL_SID_LOG_APP_INFO("BLE connection request set");
   }
 }
+
+static void connect_arm(void)
+{
+  // A send waiting for its link keeps the device out of EM4
+  reset_burtc_timer();
+  (void)xTimerChangePeriod(connect_timer, pdMS_TO_TICKS(APP_CONNECT_DEADLINE_MS), 0);
+}
+
+static void connect_deadline(app_context_t *context)
+{
+  if (!app_connect_is_pending()) {
+    // The link came up while the timer event was queued
+    return;
+  }
+
+  uint32_t attempt = app_connect_get_attempt();
+  bool fallback_up = (context->state == STATE_SIDEWALK_READY)
+                     && (app_link_router_is_up(SID_LINK_TYPE_2) || app_link_router_is_up(SID_LINK_TYPE_3));
+
+  switch (app_connect_on_deadline((uint32_t)xTaskGetTickCount() * portTICK_PERIOD_MS, fallback_up)) {
+    case APP_CONNECT_ACTION_RETRY:
+      SL_SID_LOG_APP_WARNING("BLE connect attempt %lu timed out after %u ms, retrying",
+                             (unsigned long)attempt,
+                             (unsigned int)APP_CONNECT_DEADLINE_MS);
+      // The request only restarts beaconing from a cleared state
+      context->connection_request = false;
+      (void)sid_ble_bcn_connection_request(context->sidewalk_handle, false);
+      toggle_connection_request(context);
+      connect_arm();
+      break;
+
+    case APP_CONNECT_ACTION_FALLBACK:
+      SL_SID_LOG_APP_WARNING("BLE connect attempt %lu timed out after %u ms, sending over sub-GHz",
+                             (unsigned long)attempt,
+                             (unsigned int)APP_CONNECT_DEADLINE_MS);
+      button_send_update_req = false;
+      queue_event(g_event_queue, EVENT_TYPE_SEND_COUNTER_UPDATE);
+      connect_stats();
+      break;
+
+    case APP_CONNECT_ACTION_GIVE_UP:
+      SL_SID_LOG_APP_ERROR("BLE connect attempt %lu timed out after %u ms, no link to send on, update dropped",
+                           (unsigned long)attempt,
+                           (unsigned int)APP_CONNECT_DEADLINE_MS);
+      button_send_update_req = false;
+      connect_stats();
+      break;
+  }
+}
+
+static void connect_stats(void)
+{
+  const app_connect_stats_t *stats = app_connect_get_stats();
+
+  SL_SID_LOG_APP_INFO("connect stats, attempts: %lu, connected: %lu, timeouts: %lu, fallbacks: %lu, dropped: %lu",
+                      (unsigned long)stats->attempts,
+                      (unsigned long)stats->connected,
+                      (unsigned long)stats->timeouts,
+                      (unsigned long)stats->fallbacks,
+                      (unsigned long)stats->given_up);
+  if (stats->connected != 0) {
+    SL_SID_LOG_APP_INFO("connect latency, min: %lu ms, avg: %lu ms, max: %lu ms",
+                        (unsigned long)stats->latency_min_ms,
+                        (unsigned long)(stats->latency_sum_ms / stats->connected),
+                        (unsigned long)stats->latency_max_ms);
+  }
+}
+
+static void connect_timer_callback(TimerHandle_t timer)
+{
+  UNUSED(timer);
+  queue_event(g_event_queue, EVENT_TYPE_CONNECT_DEADLINE);
+}
 #endif
 
 void app_trigger_switching_to_default_link(void)
@@ -566,39 +1240,149 @@ void app_trigger_switching_to_default_link(void)
   queue_event(g_event_queue, EVENT_TYPE_REGISTERED);
 }
 
-void app_trigger_link_switch(void)
+void app_trigger_link_switch(uint32_t link)
 {
-  queue_event(g_event_queue, EVENT_TYPE_LINK_SWITCH);
+  app_event_t event = { .type = EVENT_TYPE_LINK_SWITCH, .payload = APP_PAYLOAD_NONE, .arg = link };
+
+  app_trace_input(APP_TRACE_INPUT_LINK_SWITCH, (uint16_t)link);
+  (void)post_event(g_event_queue, &event);
 }
 
 void app_trigger_em4_sleep()
 {
+  app_trace_input(APP_TRACE_INPUT_EM4_SLEEP, 0);
   queue_event(g_event_queue, EVENT_TYPE_EM4_TIMEOUT);
 }
 
+void app_trigger_awake_lease(uint16_t seconds)
+{
+  app_event_t event = { .type = EVENT_TYPE_AWAKE_LEASE, .payload = APP_PAYLOAD_NONE, .arg = seconds };
+
+  app_trace_input(APP_TRACE_INPUT_AWAKE_LEASE, seconds);
+  (void)post_event(g_event_queue, &event);
+}
+
+bool app_trigger_send(app_payload_handle_t payload)
+{
+  app_event_t event = { .type = EVENT_TYPE_SEND, .payload = payload, .arg = 0 };
+
+  const uint8_t *data = app_payload_data(payload);
+
+  if (data == NULL) {
+    return false;
+  }
+  if (app_payload_get_size(payload) == 0 || (data[0] & APP_SEGMENT_HEADER_MARKER) != 0) {
+    // Bit 7 of the first byte marks a fragment, see app_segment.h
+    SL_SID_LOG_APP_ERROR("invalid payload, it must start with a byte below 0x80");
+    app_payload_release(payload);
+    return false;
+  }
+  app_trace_input(APP_TRACE_INPUT_SEND, (uint16_t)app_payload_get_size(payload));
+  if (!post_event(g_event_queue, &event)) {
+    SL_SID_LOG_APP_ERROR("event queue full, payload dropped");
+    app_payload_release(payload);
+    return false;
+  }
+  return true;
+}
+
 void app_trigger_send_counter_update(void)
 {
+  app_trace_input(APP_TRACE_INPUT_SEND_COUNTER_UPDATE, 0);
   queue_event(g_event_queue, EVENT_TYPE_SEND_COUNTER_UPDATE);
 }
 
+void app_trigger_alarm(uint8_t code)
+{
+  if (code >= APP_OUTBOX_ALARM_CODES) {
+    SL_SID_LOG_APP_ERROR("invalid alarm code: %u", (unsigned int)code);
+    return;
+  }
+  app_trace_input(APP_TRACE_INPUT_ALARM, code);
+  (void)atomic_fetch_or(&alarm_request, 1U << code);
+  queue_event(g_event_queue, EVENT_TYPE_ALARM);
+}
+
+void app_trigger_outbox_stats(void)
+{
+  app_trace_input(APP_TRACE_INPUT_OUTBOX_STATS, 0);
+  queue_event(g_event_queue, EVENT_TYPE_OUTBOX_STATS);
+}
+
+void app_trigger_supervisor_stats(void)
+{
+  app_trace_input(APP_TRACE_INPUT_SUPERVISOR_STATS, 0);
+  queue_event(g_event_queue, EVENT_TYPE_SUPERVISOR_STATS);
+}
+
+void app_trigger_trace_dump(void)
+{
+  app_trace_input(APP_TRACE_INPUT_TRACE_DUMP, 0);
+  queue_event(g_event_queue, EVENT_TYPE_TRACE_DUMP);
+}
+
+void app_trigger_airtime_stats(void)
+{
+  app_trace_input(APP_TRACE_INPUT_AIRTIME_STATS, 0);
+  queue_event(g_event_queue, EVENT_TYPE_AIRTIME_STATS);
+}
+
+void app_trigger_bench(const app_bench_config_t *config)
+{
+  app_bench_request(config);
+  queue_event(g_event_queue, EVENT_TYPE_BENCH_START);
+}
+
+void app_trigger_bench_stop(void)
+{
+  queue_event(g_event_queue, EVENT_TYPE_BENCH_STOP);
+}
+
+void app_submit_sample(uint8_t type, int32_t value)
+{
+  app_sample_t sample = {
+    .timestamp = app_retained_now_ms(),
+    .value = value,
+    .type = type,
+  };
+
+  if (!app_sample_ring_push(&sample)) {
+    return;
+  }
+  // One event per batch, not per sample
+  if (!atomic_exchange(&samples_event_pending, true)) {
+    queue_event(g_event_queue, EVENT_TYPE_SAMPLES);
+  }
+}
+
+void app_trigger_send_report(void)
+{
+  app_trace_input(APP_TRACE_INPUT_SEND_REPORT, 0);
+  queue_event(g_event_queue, EVENT_TYPE_SEND_REPORT);
+}
+
 void app_trigger_factory_reset(void)
 {
+  app_trace_input(APP_TRACE_INPUT_FACTORY_RESET, 0);
   queue_event(g_event_queue, EVENT_TYPE_FACTORY_RESET);
 }
 
 void app_trigger_get_time(void)
 {
+  app_trace_input(APP_TRACE_INPUT_GET_TIME, 0);
   queue_event(g_event_queue, EVENT_TYPE_GET_TIME);
 }
 
 void app_trigger_get_mtu(void)
 {
+  app_trace_input(APP_TRACE_INPUT_GET_MTU, 0);
   queue_event(g_event_queue, EVENT_TYPE_GET_MTU);
 }
 
 #if defined(SL_BLE_SUPPORTED)
 void app_trigger_connection_request(void)
 {
+  app_trace_input(APP_TRACE_INPUT_CONNECTION_REQUEST, 0);
   queue_event(g_event_queue, EVENT_TYPE_CONNECTION_REQUEST);
 }
 #endif
@@ -609,19 +1393,29 @@ void app_trigger_connection_request(void)
 static void queue_event(QueueHandle_t queue,
                         enum event_type event)
 {
+  app_event_t record = { .type = event, .payload = APP_PAYLOAD_NONE, .arg = 0 };
+
+  (void)post_event(queue, &record);
+}
+
+static bool post_event(QueueHandle_t queue, const app_event_t *event)
+{
+  BaseType_t queued = pdFALSE;
+
   if(queue == NULL)
   {
-    return;
+    return false;
   }
-  // Check if queue_event was called from ISR
+  // Check if post_event was called from ISR
   if ((bool)xPortIsInsideInterrupt()) {
     BaseType_t task_woken = pdFALSE;
 
-    xQueueSendFromISR(queue, &event, &task_woken);
+    queued = xQueueSendFromISR(queue, event, &task_woken);
     portYIELD_FROM_ISR(task_woken);
   } else {
-    xQueueSend(queue, &event, 0);
+    queued = xQueueSend(queue, event, 0);
   }
+  return queued == pdTRUE;
 }
 
 static void on_sidewalk_event(bool in_isr,
@@ -639,6 +1433,7 @@ static void on_sidewalk_msg_received(const struct sid_msg_desc *msg_desc,
 {
   UNUSED(context);
   reset_burtc_timer();
+  app_trace_record(APP_TRACE_MSG_RECEIVED, (uint8_t)msg_desc->link_type, (uint16_t)msg->size);
   SL_SID_LOG_APP_INFO("downlink message received");
   SL_SID_LOG_APP_INFO("link type: %x, msg id: %u, msg size: %u, msg type: %d, ack requested: %d, is ack: %d, is duplicate: %d, rssi: %d, snr: %d",
                       msg_desc->link_type,
@@ -657,6 +1452,17 @@ static void on_sidewalk_msg_received(const struct sid_msg_desc *msg_desc,
       SL_SID_LOG_APP_INFO("received message: %.*s", msg->size, (char *)msg->data);
     }
   }
+
+  // Called from sid_process(), already in the main task
+  if (app_tx_power_on_downlink((uint32_t)msg_desc->link_type,
+                               msg_desc->msg_desc_attr.rx_attr.rssi,
+                               msg_desc->msg_desc_attr.rx_attr.snr)) {
+    tx_power_changed((uint32_t)msg_desc->link_type, "downlink margin");
+  }
+  uint32_t lease_s = 0;
+  if (app_rendezvous_parse_lease((const uint8_t *)msg->data, msg->size, &lease_s)) {
+    awake_lease(lease_s);
+  }
 }
 
 static void on_sidewalk_msg_sent(const struct sid_msg_desc *msg_desc,
@@ -664,6 +1470,12 @@ static void on_sidewalk_msg_sent(const struct sid_msg_desc *msg_desc,
 {
   UNUSED(context);
   reset_burtc_timer();
+  app_segment_on_msg_sent(msg_desc);
+  (void)app_bench_on_msg_sent(msg_desc);
+  if (app_ack_policy_on_msg_sent(msg_desc)) {
+    SL_SID_LOG_APP_INFO("%s delivery healthy, uplinks without ack", app_link_router_link_name((uint32_t)msg_desc->link_type));
+  }
+  app_trace_record(APP_TRACE_MSG_SENT, (uint8_t)msg_desc->link_type, msg_desc->id);
   SL_SID_LOG_APP_INFO("uplink message sent");
   SL_SID_LOG_APP_INFO("link type: %x, msg id: %u, msg type: %d",
                       msg_desc->link_type,
@@ -677,6 +1489,16 @@ static void on_sidewalk_send_error(sid_error_t error,
 {
   UNUSED(context);
   reset_burtc_timer();
+  app_segment_on_send_error(error, msg_desc);
+  (void)app_bench_on_send_error(error, msg_desc);
+  app_diag_set_error(error);
+  if (app_tx_power_on_send_error((uint32_t)msg_desc->link_type)) {
+    tx_power_changed((uint32_t)msg_desc->link_type, "send error");
+  }
+  if (app_ack_policy_on_send_error(msg_desc)) {
+    SL_SID_LOG_APP_WARNING("%s delivery degraded, uplinks acked", app_link_router_link_name((uint32_t)msg_desc->link_type));
+  }
+  app_trace_record(APP_TRACE_MSG_ERROR, (uint8_t)(int8_t)error, msg_desc->id);
   SL_SID_LOG_APP_ERROR("uplink message send failed");
   SL_SID_LOG_APP_ERROR("link type: %x, msg id: %u, msg type: %d, error: %d",
                        msg_desc->link_type,
@@ -693,10 +1515,37 @@ static void on_sidewalk_status_changed(const struct sid_status *status,
 {
   app_context_t *app_context = (app_context_t *)context;
 
+  app_link_router_set_link_status(status->detail.link_status_mask);
+  app_diag_set(APP_DIAG_LINK_STATUS,
+               (status->detail.link_status_mask & 0x3FU)
+               | ((status->detail.registration_status == SID_STATUS_REGISTERED) ? 0x40U : 0U)
+               | ((status->detail.time_sync_status == SID_STATUS_TIME_SYNCED) ? 0x80U : 0U));
+  app_trace_record(APP_TRACE_STATUS,
+                   (uint8_t)status->state,
+                   (uint16_t)((status->detail.registration_status & 0x1U)
+                              | ((status->detail.time_sync_status & 0x1U) << 1)
+                              | ((status->detail.link_status_mask & 0xFFFU) << 4)));
+
   switch (status->state) {
     case SID_STATE_READY:
       app_context->state = STATE_SIDEWALK_READY;
       SL_SID_LOG_APP_INFO("sidewalk status ready");
+      restart.active = false;
+      uint32_t recovery_ms = 0;
+      if (app_supervisor_on_ready(app_retained_now_ms(), &recovery_ms)) {
+        app_diag_set(APP_DIAG_RECOVERY_S, (recovery_ms / 1000U > UINT16_MAX) ? UINT16_MAX : recovery_ms / 1000U);
+        SL_SID_LOG_APP_INFO("sidewalk stack recovered in %lu ms", (unsigned long)recovery_ms);
+      }
+      if (boot_to_ready_ms == 0) {
+        boot_to_ready_ms = (uint32_t)xTaskGetTickCount() * portTICK_PERIOD_MS;
+        SL_SID_LOG_APP_INFO("boot to ready: %lu ms", (unsigned long)boot_to_ready_ms);
+      }
+      if (schedule_waiting) {
+        queue_event(app_context->event_queue, EVENT_TYPE_SCHEDULED_SEND);
+      }
+      if (app_outbox_count() != 0) {
+        queue_event(app_context->event_queue, EVENT_TYPE_OUTBOX);
+      }
       break;
 
     case SID_STATE_NOT_READY:
@@ -705,6 +1554,7 @@ static void on_sidewalk_status_changed(const struct sid_status *status,
       break;
 
     case SID_STATE_ERROR:
+      app_diag_set_error(sid_get_error(app_context->sidewalk_handle));
       SL_SID_LOG_APP_ERROR("sidewalk status error, error: %d", (int)sid_get_error(app_context->sidewalk_handle));
       break;
 
@@ -715,7 +1565,12 @@ static void on_sidewalk_status_changed(const struct sid_status *status,
   }
 
   if (status->detail.registration_status == SID_STATUS_REGISTERED) {
+    store_registration(true);
     app_trigger_switching_to_default_link();
+  } else if (device_registered) {
+    // Persisted outcome was stale, registration has to run again
+    store_registration(false);
+    queue_event(app_context->event_queue, EVENT_TYPE_REGISTRATION_FALLBACK);
   }
 
   SL_SID_LOG_APP_INFO("registration status: %u, time sync: %u, link: %lu",
@@ -724,9 +1579,18 @@ static void on_sidewalk_status_changed(const struct sid_status *status,
                       status->detail.link_status_mask);
 
 #if defined(SL_BLE_SUPPORTED)
-  if (button_send_update_req && status->state == SID_STATE_READY) {
+  // Sent once BLE itself is up, the deadline handles the sub-GHz fallback
+  if (button_send_update_req && status->state == SID_STATE_READY
+      && (status->detail.link_status_mask & SID_LINK_TYPE_1) != 0) {
     button_send_update_req = false;
-    app_trigger_send_counter_update();
+    if (app_connect_is_pending()) {
+      (void)xTimerStop(connect_timer, 0);
+      uint32_t attempt = app_connect_get_attempt();
+      uint32_t latency_ms = app_connect_on_link_up((uint32_t)xTaskGetTickCount() * portTICK_PERIOD_MS);
+      SL_SID_LOG_APP_INFO("BLE connect attempt %lu up in %lu ms", (unsigned long)attempt, (unsigned long)latency_ms);
+      connect_stats();
+    }
+    queue_event(app_context->event_queue, EVENT_TYPE_SEND_COUNTER_UPDATE);
   }
 #endif
 }
@@ -735,6 +1599,9 @@ static void on_sidewalk_factory_reset(void *context)
 {
   UNUSED(context);
   SL_SID_LOG_APP_INFO("device factory reset");
+  store_registration(false);
+  app_trace_flush();
+  app_retained_save_time();
   // This is the callback function of the factory reset and as the last step a reset is applied.
   NVIC_SystemReset();
 }
@@ -781,14 +1648,140 @@ static enum sid_link_type get_next_link(enum sid_link_type current_link)
   }
 }
 
-static bool link_switch(app_context_t *app_context, struct sid_config *config)
+static bool stack_start(app_context_t *app_context, struct sid_config *config, uint32_t link_mask, uint32_t preferred_link)
 {
-  enum sid_link_type current_link = config->link_mask;
-  enum sid_link_type next_link = get_next_link(config->link_mask);
+  if (init_and_start_link(app_context, config, link_mask, preferred_link) == 0) {
+    return true;
+  }
+  stack_failed(app_context, link_mask, preferred_link);
+  return false;
+}
+
+static void stack_failed(app_context_t *app_context, uint32_t link_mask, uint32_t preferred_link)
+{
+  uint32_t delay_ms = 0;
+
+  // Nothing goes out until the stack is ready again
+  app_context->state = STATE_SIDEWALK_NOT_READY;
+  app_context->current_link_type = 0;
+  app_link_router_set_link_status(0);
+  if (!restart.active) {
+    restart.active = true;
+    restart.link_mask = link_mask;
+    restart.preferred_link = preferred_link;
+    restart.fallback_link = preferred_link;
+  }
+
+  app_supervisor_action_t action = app_supervisor_on_failure(app_retained_now_ms(), &delay_ms);
+  if (action == APP_SUPERVISOR_FALLBACK && !device_registered) {
+    // Registration needs the link that failed
+    action = APP_SUPERVISOR_RETRY;
+  }
+  restart.fallback = (action == APP_SUPERVISOR_FALLBACK);
+  if (restart.fallback) {
+    restart.fallback_link = get_next_link((enum sid_link_type)restart.fallback_link);
+  }
+
+  switch (action) {
+    case APP_SUPERVISOR_SLEEP:
+      SL_SID_LOG_APP_ERROR("sidewalk stack failed, giving up for %lu ms", (unsigned long)delay_ms);
+      supervisor_sleep(delay_ms);
+      break;
+    default:
+      SL_SID_LOG_APP_ERROR("sidewalk stack failed, restart on %s in %lu ms",
+                           restart.fallback ? app_link_router_link_name(restart.fallback_link) : "the same links",
+                           (unsigned long)delay_ms);
+      (void)xTimerChangePeriod(restart_timer, pdMS_TO_TICKS(delay_ms) + 1, 0);
+      break;
+  }
+}
+
+static void stack_restart(app_context_t *app_context, struct sid_config *config)
+{
+  uint32_t link_mask = restart.fallback ? restart.fallback_link : restart.link_mask;
+  uint32_t preferred_link = restart.fallback ? restart.fallback_link : restart.preferred_link;
+  app_supervisor_stats_t stats;
+
+  if (!restart.active) {
+    // Recovered meanwhile
+    return;
+  }
+  app_supervisor_on_restart();
+  app_supervisor_get_stats(app_retained_now_ms(), &stats);
+  app_diag_set(APP_DIAG_STACK_RESTARTS, stats.restarts);
+  SL_SID_LOG_APP_INFO("sidewalk stack restart %lu, link mask: %x", (unsigned long)stats.attempt, (int)link_mask);
+  if (init_and_start_link(app_context, config, link_mask, preferred_link) != 0) {
+    stack_failed(app_context, link_mask, preferred_link);
+  }
+}
+
+static void supervisor_sleep(uint32_t sleep_ms)
+{
+  em4_plan.sleep_ms = sleep_ms;
+  em4_plan.radio_depth = APP_RADIO_SLEEP_NONE;
+
+  if (!em4_hooks_suspend()) {
+    // Keep restarting from the longest backoff
+    (void)xTimerChangePeriod(restart_timer, pdMS_TO_TICKS(APP_SUPERVISOR_BACKOFF_MAX_MS), 0);
+    return;
+  }
+  //Go to EM4
+  em_EM4_ULfrcoBURTC();
+}
+
+static void supervisor_stats(void)
+{
+  app_supervisor_stats_t stats;
+
+  app_supervisor_get_stats(app_retained_now_ms(), &stats);
+  SL_SID_LOG_APP_INFO("stack restarts: %lu, failures this boot: %lu, in a row: %lu, EM4 escalations: %lu",
+                      (unsigned long)stats.restarts,
+                      (unsigned long)stats.failures,
+                      (unsigned long)stats.attempt,
+                      (unsigned long)stats.escalations);
+  SL_SID_LOG_APP_INFO("stack recoveries: %lu, mean: %lu ms, max: %lu s",
+                      (unsigned long)stats.recoveries,
+                      (unsigned long)((stats.recoveries != 0) ? stats.recovery_sum_ms / stats.recoveries : 0U),
+                      (unsigned long)(stats.recovery_max_ms / 1000U));
+  if (stats.failing_ms != 0) {
+    SL_SID_LOG_APP_INFO("stack down for %lu ms", (unsigned long)stats.failing_ms);
+  }
+}
+
+static void restart_timer_callback(TimerHandle_t timer)
+{
+  UNUSED(timer);
+  queue_event(g_event_queue, EVENT_TYPE_STACK_RESTART);
+}
+
+static bool link_switch(app_context_t *app_context, struct sid_config *config, uint32_t target)
+{
+  enum sid_link_type current_link = app_link_router_get_preferred();
+  enum sid_link_type next_link = current_link;
+
+  if (target == 0) {
+    next_link = get_next_link(current_link);
+  } else if (!link_is_built(target)) {
+    SL_SID_LOG_APP_WARNING("%s link not supported on this platform", app_link_router_link_name(target));
+    return true;
+  } else if (target == current_link) {
+    SL_SID_LOG_APP_INFO("already on %s link", app_link_router_link_name(target));
+    return true;
+  } else {
+    SL_SID_LOG_APP_INFO("switching to %s link", app_link_router_link_name(target));
+    next_link = (enum sid_link_type)target;
+  }
 
   if (current_link != next_link) {
-    if (init_and_start_link(app_context, config, next_link) != 0) {
-      return false;
+    // Links already running only change the routing preference, the stack
+    // is restarted only when swapping the sub-GHz link (FSK <-> CSS)
+    if (app_link_router_set_preferred(next_link)) {
+      SL_SID_LOG_APP_INFO("preferred link: %s", app_link_router_link_name(next_link));
+    } else {
+      uint32_t link_mask = (config->link_mask & SID_LINK_TYPE_1) | next_link;
+      if (!stack_start(app_context, config, link_mask, next_link)) {
+        return false;
+      }
     }
   } else {
     SL_SID_LOG_APP_WARNING("only one link available on this platform");
@@ -797,79 +1790,791 @@ static bool link_switch(app_context_t *app_context, struct sid_config *config)
   return true;
 }
 
+static bool link_is_built(uint32_t link)
+{
+  uint32_t built = 0;
+
+#if defined(SL_BLE_SUPPORTED)
+  built |= SID_LINK_TYPE_1;
+#endif
+#if defined(SL_FSK_SUPPORTED)
+  built |= SID_LINK_TYPE_2;
+#endif
+#if defined(SL_CSS_SUPPORTED)
+  built |= SID_LINK_TYPE_3;
+#endif
+  return (built & link) != 0;
+}
+
+static uint32_t regular_sleep_ms(uint32_t in_ms)
+{
+  // An overdue uplink waits for the regular wake-up, stretched by the tier
+  uint32_t sleep_ms = app_battery_get_mode()->wakeup_interval_ms;
+  uint32_t until_due_ms = app_schedule_ms_until_due();
+  if (until_due_ms > in_ms && until_due_ms - in_ms < sleep_ms) {
+    sleep_ms = until_due_ms - in_ms;
+  }
+  return sleep_ms;
+}
+
+static uint32_t rendezvous_lead_ms(void)
+{
+  // The sent callback of the uplink restarts the inactivity timeout
+  uint32_t awake_ms = app_battery_get_mode()->awake_ms;
+  return awake_ms + regular_sleep_ms(awake_ms);
+}
+
 static void em4_sleep(app_context_t *app_context)
 {
+  // A waiting alarm keeps the device up until sent or expired
+  outbox_pump(app_context);
+  if (app_outbox_depth(APP_OUTBOX_CLASS_ALARM) != 0) {
+    app_log_info("app: EM4 held off, alarm waiting");
+    reset_burtc_timer();
+    return;
+  }
+
+  // The receive window promised in the uplinks or a lease keeps the device up
+  uint32_t hold_ms = app_rendezvous_hold_ms();
+  if (hold_ms != 0) {
+    app_log_info("app: EM4 held off for %lu ms, rendezvous", (unsigned long)hold_ms);
+    (void)xTimerChangePeriod(rendezvous_timer, pdMS_TO_TICKS(hold_ms) + 1, 0);
+    return;
+  }
+
+  // Wake up on the scheduled slot and on the promised receive window
+  em4_plan.sleep_ms = app_rendezvous_sleep_ms(regular_sleep_ms(0));
+  em4_plan.radio_depth = APP_RADIO_SLEEP_NONE;
+
+  // Stack teardown and state, then the pins, clocks and EMU from em4_mode.c
+  if (!em4_hooks_suspend()) {
+    return;
+  }
+  //Go to EM4
+  em_EM4_ULfrcoBURTC();
+  return;
+}
+
+static bool em4_stack_stop(void *context)
+{
+  app_context_t *app_context = (app_context_t *)context;
+
+  if (app_context->sidewalk_handle == NULL) {
+    // Stack down, see stack_failed()
+    return true;
+  }
   //Stop the Sidewalk stack
-  sid_error_t ret = SID_ERROR_NONE;
-  ret = sid_stop(app_context->sidewalk_handle, app_context->current_link_type);
+  sid_error_t ret = sid_stop(app_context->sidewalk_handle, app_context->current_link_type);
   if(ret != SID_ERROR_NONE) {
       app_log_error("app: failed to stop the stack: %d", (int)ret);
-      return;
+      return false;
   }
   app_log_info("app: stack stopped");
+  return true;
+}
+
+static bool em4_radio_sleep(void *context)
+{
 #if defined(SL_RADIO_EXTERNAL)
-  if(app_context->current_link_type != SID_LINK_TYPE_1) {
-      ret = sid_pal_radio_sleep(WAKEUP_INTERVAL_MS);
-        if(ret != RADIO_ERROR_NONE) {
-            app_log_error("app: fail to make the Semtech chip sleep: %d", (int)ret);
-            return;
-        }
-        app_log_info("app: radio transceiver put to sleep");
+  app_context_t *app_context = (app_context_t *)context;
+
+  if(app_context->current_link_type & (SID_LINK_TYPE_2 | SID_LINK_TYPE_3)) {
+      em4_plan.radio_depth = radio_sleep(em4_plan.sleep_ms);
+      if(em4_plan.radio_depth == APP_RADIO_SLEEP_NONE) {
+          return false;
+      }
   }
+#else
+  UNUSED(context);
 #endif
+  return true;
+}
+
+static bool em4_stack_deinit(void *context)
+{
+  app_context_t *app_context = (app_context_t *)context;
+
+  if (app_context->sidewalk_handle == NULL) {
+    return true;
+  }
   //De-init the Sidewalk stack
-  ret = sid_deinit(app_context->sidewalk_handle);
+  sid_error_t ret = sid_deinit(app_context->sidewalk_handle);
   if(ret != SID_ERROR_NONE) {
       app_log_error("app: failed to deinit the stack: %d", (int)ret);
-      return;
+      return false;
   }
+  app_segment_reset();
   app_log_info("app: stack de-initialized");
-  //Go to EM4
-  em_EM4_ULfrcoBURTC();
-  return;
+  return true;
 }
 
-static void send_counter_update(app_context_t *app_context)
+static bool em4_save_state(void *context)
 {
-  char counter_buff[10] = { 0 };
+  app_context_t *app_context = (app_context_t *)context;
 
-  if (app_context->state == STATE_SIDEWALK_READY
-      || app_context->state == STATE_SIDEWALK_SECURE_CONNECTION) {
-    SL_SID_LOG_APP_INFO("sending counter update, counter: %d", app_context->counter);
+  set_em4_sleep_duration(em4_plan.sleep_ms);
+  app_radio_sleep_entered(em4_plan.radio_depth);
+  // The waiting uplinks go on after the sleep until their TTL
+  size_t dropped = app_outbox_save();
+  if (dropped != 0) {
+    app_log_info("app: %u waiting uplinks dropped, no room to store them", (unsigned int)dropped);
+  }
 
-    // buffer for str representation of integer value
-    snprintf(counter_buff, sizeof(counter_buff), "%d", app_context->counter);
+  // The report batch spans wake-ups
+  drain_samples(true);
+  app_report_save();
 
-    struct sid_msg msg = {
-      .data = (void *)counter_buff,
-      .size = sizeof(counter_buff)
-    };
-    struct sid_msg_desc desc = {
-      .type = SID_MSG_TYPE_NOTIFY,
-      .link_type = SID_LINK_TYPE_ANY,
-    };
+  app_trace_record(APP_TRACE_LINK_STOP, 0, (uint16_t)app_context->current_link_type);
+  app_trace_record(APP_TRACE_EM4_ENTER, (uint8_t)em4_plan.radio_depth, (uint16_t)(em4_plan.sleep_ms / 1000U));
+  app_trace_flush();
+  app_retained_save_time();
+  return true;
+}
 
-    sid_error_t ret = sid_put_msg(app_context->sidewalk_handle, &msg, &desc);
-    if (ret != SID_ERROR_NONE) {
-      SL_SID_LOG_APP_ERROR("send message failed, error: %d", (int)ret);
+#if defined(SL_RADIO_EXTERNAL)
+static app_radio_sleep_depth_t radio_sleep(uint32_t sleep_ms)
+{
+  app_radio_sleep_depth_t depth = app_radio_sleep_select(sleep_ms, sid_pal_radio_sleep_cold != NULL);
+  int32_t ret = RADIO_ERROR_NONE;
+
+  if (depth == APP_RADIO_SLEEP_COLD) {
+    ret = sid_pal_radio_sleep_cold(sleep_ms);
+  } else {
+    ret = sid_pal_radio_sleep(sleep_ms);
+  }
+  if (ret != RADIO_ERROR_NONE) {
+    app_log_error("app: fail to make the Semtech chip sleep: %d", (int)ret);
+    return APP_RADIO_SLEEP_NONE;
+  }
+  app_log_info("app: radio transceiver put to sleep, %s start, break-even: %lu ms",
+               (depth == APP_RADIO_SLEEP_COLD) ? "cold" : "warm",
+               (unsigned long)app_radio_sleep_break_even_ms());
+
+  return depth;
+}
+
+static void radio_start_stats(uint32_t start_ms)
+{
+  app_radio_sleep_on_start(start_ms);
+
+  uint32_t warm_x16 = app_radio_sleep_reinit_x16(APP_RADIO_SLEEP_WARM);
+  uint32_t cold_x16 = app_radio_sleep_reinit_x16(APP_RADIO_SLEEP_COLD);
+  SL_SID_LOG_APP_INFO("radio re-init: %lu ms, mean warm: %lu.%02lu ms, cold: %lu.%02lu ms",
+                      (unsigned long)start_ms,
+                      (unsigned long)(warm_x16 >> 4), (unsigned long)(((warm_x16 & 0xFU) * 100U) >> 4),
+                      (unsigned long)(cold_x16 >> 4), (unsigned long)(((cold_x16 & 0xFU) * 100U) >> 4));
+}
+#endif
+
+static void store_registration(bool registered)
+{
+  if (device_registered == registered) {
+    return;
+  }
+
+  device_registered = registered;
+  uint8_t value = registered ? 1U : 0U;
+  if (app_nvm_write(APP_NVM_KEY_REGISTERED, &value, sizeof(value))) {
+    SL_SID_LOG_APP_INFO("registration status stored, registered: %d", (int)registered);
+  }
+}
+
+static const char *event_type_name(enum event_type event)
+{
+  switch (event) {
+    case EVENT_TYPE_SIDEWALK:
+      return "sidewalk";
+#if defined(SL_BLE_SUPPORTED)
+    case EVENT_TYPE_CONNECTION_REQUEST:
+      return "connection_request";
+#endif
+    case EVENT_TYPE_SEND_COUNTER_UPDATE:
+      return "send_counter_update";
+    case EVENT_TYPE_FACTORY_RESET:
+      return "factory_reset";
+    case EVENT_TYPE_LINK_SWITCH:
+      return "link_switch";
+    case EVENT_TYPE_EM4_TIMEOUT:
+      return "em4_timeout";
+    case EVENT_TYPE_GET_TIME:
+      return "get_time";
+    case EVENT_TYPE_GET_MTU:
+      return "get_mtu";
+    case EVENT_TYPE_REGISTERED:
+      return "registered";
+    case EVENT_TYPE_REGISTRATION_FALLBACK:
+      return "registration_fallback";
+    case EVENT_TYPE_SEND:
+      return "send";
+    case EVENT_TYPE_SEND_REPORT:
+      return "send_report";
+    case EVENT_TYPE_TRACE_DUMP:
+      return "trace_dump";
+    case EVENT_TYPE_AIRTIME_RETRY:
+      return "airtime_retry";
+    case EVENT_TYPE_AIRTIME_STATS:
+      return "airtime_stats";
+    case EVENT_TYPE_BENCH_START:
+      return "bench_start";
+    case EVENT_TYPE_BENCH_STOP:
+      return "bench_stop";
+    case EVENT_TYPE_SAMPLES:
+      return "samples";
+    case EVENT_TYPE_SCHEDULED_SEND:
+      return "scheduled_send";
+    case EVENT_TYPE_AWAKE_LEASE:
+      return "awake_lease";
+    case EVENT_TYPE_ALARM:
+      return "alarm";
+    case EVENT_TYPE_OUTBOX:
+      return "outbox";
+    case EVENT_TYPE_OUTBOX_STATS:
+      return "outbox_stats";
+    case EVENT_TYPE_STACK_RESTART:
+      return "stack_restart";
+    case EVENT_TYPE_SUPERVISOR_STATS:
+      return "supervisor_stats";
+#if defined(SL_BLE_SUPPORTED)
+    case EVENT_TYPE_CONNECT_DEADLINE:
+      return "connect_deadline";
+#endif
+    case EVENT_TYPE_INVALID:
+    default:
+      return "invalid";
+  }
+}
+
+static void trace_dump(void)
+{
+  for (uint32_t event = 0; event < EVENT_TYPE_INVALID; event++) {
+    SL_SID_LOG_APP_INFO("trace: event %lu %s", (unsigned long)event, event_type_name((enum event_type)event));
+  }
+  app_trace_dump();
+}
+
+static outbox_result_t send_counter_update(app_context_t *app_context, uint32_t ttl_s)
+{
+  // Counter as a 10 byte string, diagnostics fill the rest of the frame
+  uint8_t payload[APP_SEGMENT_MAX_PAYLOAD] = { 0 };
+  const size_t counter_size = 10U;
+  uint8_t counter = app_context->counter;
+
+  SL_SID_LOG_APP_INFO("sending counter update, counter: %d", (int)counter);
+
+  // buffer for str representation of integer value, ASCII keeps bit 7 of the
+  // first byte clear
+  snprintf((char *)payload, counter_size, "%d", (int)counter);
+
+  // A low battery trades the preferred link for the cheapest one
+  app_link_urgency_t urgency = app_battery_get_mode()->cheapest_link ? APP_LINK_URGENCY_LOW : APP_LINK_URGENCY_NORMAL;
+  enum sid_link_type link = app_link_router_select(app_context->sidewalk_handle, counter_size, urgency);
+  size_t mtu = app_link_router_get_mtu(app_context->sidewalk_handle, link);
+  if (mtu > sizeof(payload)) {
+    mtu = sizeof(payload);
+  }
+  // Budget the whole frame, diagnostics may fill it up
+  uint32_t airtime_us = app_airtime_estimate_us(link, (mtu > counter_size) ? mtu : counter_size, mtu);
+  if (!airtime_admit(link, airtime_us, EVENT_TYPE_OUTBOX)) {
+    return OUTBOX_HELD;
+  }
+
+  size_t size = counter_size;
+  struct sid_msg_desc desc = { 0 };
+  sid_error_t ret = put_uplink(app_context, link, mtu, payload, &size, ttl_s, false, true, &desc);
+
+  // Every counter value also goes into the next batched report
+  app_submit_sample(APP_SAMPLE_COUNTER, counter);
+
+  if (ret != SID_ERROR_NONE) {
+    SL_SID_LOG_APP_ERROR("send message failed, error: %d", (int)ret);
+    return OUTBOX_DROPPED;
+  }
+  app_context->counter++;
+  SL_SID_LOG_APP_INFO("message queued");
+  SL_SID_LOG_APP_INFO("link type: %x, msg id: %u, msg size: %u, msg type: %d, ack requested: %d, ttl: %d, max retry: %d, additional attr: %d",
+                      desc.link_type,
+                      desc.id,
+                      size,
+                      (int)desc.type,
+                      desc.msg_desc_attr.tx_attr.request_ack,
+                      desc.msg_desc_attr.tx_attr.ttl_in_seconds,
+                      desc.msg_desc_attr.tx_attr.num_retries,
+                      desc.msg_desc_attr.tx_attr.additional_attr);
+  SL_SID_LOG_APP_HEXDUMP_INFO((const void *)payload, size);
+  return OUTBOX_SENT;
+}
+
+static outbox_result_t send_report(app_context_t *app_context, uint32_t ttl_s)
+{
+  uint8_t report[APP_SEGMENT_MAX_PAYLOAD];
+  size_t sample_count = 0;
+
+  drain_samples(true);
+  // Samples older than a bulk uplink may wait are not worth the airtime
+  size_t expired = app_report_expire(app_retained_now_ms(), APP_OUTBOX_TTL_BULK_S * 1000U);
+  if (expired != 0) {
+    SL_SID_LOG_APP_WARNING("samples expired: %u", (unsigned int)expired);
+  }
+  if (app_report_pending() == 0) {
+    SL_SID_LOG_APP_INFO("no sample to report");
+    return OUTBOX_DROPPED;
+  }
+
+  // One frame of the cheapest link, as many samples as the MTU allows
+  enum sid_link_type link = app_link_router_select(app_context->sidewalk_handle, 1, APP_LINK_URGENCY_LOW);
+  size_t mtu = app_link_router_get_mtu(app_context->sidewalk_handle, link);
+  if (mtu > sizeof(report)) {
+    mtu = sizeof(report);
+  }
+
+  size_t size = app_report_build(report, mtu, &sample_count);
+  if (size == 0) {
+    SL_SID_LOG_APP_ERROR("report does not fit, mtu: %u", (unsigned int)mtu);
+    return OUTBOX_DROPPED;
+  }
+  // Samples stay pending while the report is held back
+  if (!airtime_admit(link, app_airtime_estimate_us(link, mtu, mtu), EVENT_TYPE_OUTBOX)) {
+    return OUTBOX_HELD;
+  }
+
+  struct sid_msg_desc desc = { 0 };
+  sid_error_t ret = put_uplink(app_context, link, mtu, report, &size, ttl_s, false, true, &desc);
+  if (ret != SID_ERROR_NONE) {
+    SL_SID_LOG_APP_ERROR("send report failed, error: %d", (int)ret);
+    return OUTBOX_DROPPED;
+  }
+
+  app_report_consume(sample_count);
+  SL_SID_LOG_APP_INFO("report queued, samples: %u, size: %u, raw size: %u, pending: %u, dropped: %lu, ring overflows: %lu",
+                      (unsigned int)sample_count,
+                      (unsigned int)size,
+                      (unsigned int)(sample_count * 8U),
+                      (unsigned int)app_report_pending(),
+                      (unsigned long)app_report_get_dropped(),
+                      (unsigned long)app_sample_ring_get_overflows());
+  return OUTBOX_SENT;
+}
+
+static outbox_result_t send_alarm(app_context_t *app_context, const app_outbox_entry_t *entry, uint32_t ttl_s)
+{
+  uint8_t payload[APP_SEGMENT_MAX_PAYLOAD] = { 0 };
+  uint32_t age_s = (app_retained_now_ms() - entry->queued_ms) / 1000U;
+
+  payload[0] = APP_OUTBOX_ALARM_MARKER;
+  payload[1] = (uint8_t)entry->value;
+  payload[2] = (uint8_t)((age_s > 0xFFFFU ? 0xFFFFU : age_s) >> 8);
+  payload[3] = (uint8_t)(age_s > 0xFFFFU ? 0xFFFFU : age_s);
+
+  enum sid_link_type link = app_link_router_select(app_context->sidewalk_handle, APP_OUTBOX_ALARM_SIZE, APP_LINK_URGENCY_HIGH);
+  size_t mtu = app_link_router_get_mtu(app_context->sidewalk_handle, link);
+  if (mtu > sizeof(payload)) {
+    mtu = sizeof(payload);
+  }
+  uint32_t airtime_us = app_airtime_estimate_us(link, (mtu > APP_OUTBOX_ALARM_SIZE) ? mtu : APP_OUTBOX_ALARM_SIZE, mtu);
+  if (!airtime_admit(link, airtime_us, EVENT_TYPE_OUTBOX)) {
+    return OUTBOX_HELD;
+  }
+
+  size_t size = APP_OUTBOX_ALARM_SIZE;
+  struct sid_msg_desc desc = { 0 };
+  sid_error_t ret = put_uplink(app_context, link, mtu, payload, &size, ttl_s, true, true, &desc);
+  if (ret != SID_ERROR_NONE) {
+    SL_SID_LOG_APP_ERROR("send alarm failed, error: %d", (int)ret);
+    return OUTBOX_DROPPED;
+  }
+  SL_SID_LOG_APP_INFO("alarm queued, code: %d, age: %lu s, link: %s, msg id: %u",
+                      (int)entry->value,
+                      (unsigned long)age_s,
+                      app_link_router_link_name(link),
+                      desc.id);
+  return OUTBOX_SENT;
+}
+
+static outbox_result_t send_payload(app_context_t *app_context, const app_outbox_entry_t *entry, uint32_t ttl_s)
+{
+  app_payload_handle_t handle = (app_payload_handle_t)entry->value;
+  // Sent from the producer's buffer unchanged, the cloud could not tell its
+  // bytes from appended diagnostics
+  uint8_t *payload = app_payload_data(handle);
+  size_t size = app_payload_get_size(handle);
+
+  if (payload == NULL || size == 0) {
+    return OUTBOX_DROPPED;
+  }
+
+  app_link_urgency_t urgency = app_battery_get_mode()->cheapest_link ? APP_LINK_URGENCY_LOW : APP_LINK_URGENCY_NORMAL;
+  enum sid_link_type link = app_link_router_select(app_context->sidewalk_handle, size, urgency);
+  size_t mtu = app_link_router_get_mtu(app_context->sidewalk_handle, link);
+  if (!airtime_admit(link, app_airtime_estimate_us(link, size, mtu), EVENT_TYPE_OUTBOX)) {
+    return OUTBOX_HELD;
+  }
+
+  struct sid_msg_desc desc = { 0 };
+  sid_error_t ret = put_uplink(app_context, link, mtu, payload, &size, ttl_s, false, false, &desc);
+  if (ret != SID_ERROR_NONE) {
+    SL_SID_LOG_APP_ERROR("send payload failed, error: %d", (int)ret);
+    return OUTBOX_DROPPED;
+  }
+  SL_SID_LOG_APP_INFO("payload queued, link: %s, msg id: %u, msg size: %u",
+                      app_link_router_link_name(link),
+                      desc.id,
+                      (unsigned int)size);
+  SL_SID_LOG_APP_HEXDUMP_INFO((const void *)payload, size);
+  return OUTBOX_SENT;
+}
+
+static sid_error_t put_uplink(app_context_t *app_context,
+                              enum sid_link_type link,
+                              size_t mtu,
+                              uint8_t *payload,
+                              size_t *size,
+                              uint32_t ttl_s,
+                              bool critical,
+                              bool diag,
+                              struct sid_msg_desc *desc)
+{
+  app_diag_set(APP_DIAG_RENDEZVOUS, app_rendezvous_hint(rendezvous_lead_ms()));
+  app_diag_set(APP_DIAG_TX_POWER, (uint8_t)app_tx_power_get_dbm(link));
+  if (diag && mtu > *size) {
+    *size += app_diag_fill(&payload[*size], mtu - *size);
+  }
+
+  desc->type = SID_MSG_TYPE_NOTIFY;
+  desc->link_type = link;
+  // The stack gives up on the uplink once the outbox would have
+  desc->msg_desc_attr.tx_attr.ttl_in_seconds = (uint16_t)((ttl_s > 0xFFFFU) ? 0xFFFFU : ttl_s);
+  // Acks only where the delivery history asks for them
+  (void)app_ack_policy_apply(link, critical, desc);
+
+  tx_power_apply(link);
+  sid_error_t ret = app_segment_send(app_context->sidewalk_handle, payload, *size, desc);
+  if (ret != SID_ERROR_NONE) {
+    app_diag_set_error(ret);
+    return ret;
+  }
+
+  uint32_t airtime_us = app_airtime_estimate_us(link, *size, mtu);
+  app_airtime_charge(link, airtime_us);
+  return SID_ERROR_NONE;
+}
+
+static void outbox_push(app_outbox_class_t msg_class, app_outbox_kind_t kind, int32_t value)
+{
+  if (!app_outbox_push(msg_class, kind, value, app_retained_now_ms())) {
+    SL_SID_LOG_APP_WARNING("%s outbox full, oldest uplink dropped", app_outbox_class_name(msg_class));
+  }
+}
+
+static void outbox_pump(app_context_t *app_context)
+{
+  app_outbox_class_t msg_class = APP_OUTBOX_CLASS_COUNT;
+  const app_outbox_entry_t *entry = NULL;
+
+  while ((entry = app_outbox_peek(app_retained_now_ms(), &msg_class)) != NULL) {
+    if (app_context->state != STATE_SIDEWALK_READY
+        && app_context->state != STATE_SIDEWALK_SECURE_CONNECTION) {
+      if (msg_class == APP_OUTBOX_CLASS_ALARM) {
+        alarm_bring_up(app_context);
+      }
+      SL_SID_LOG_APP_INFO("%s uplink waiting for sidewalk ready, waiting: %u",
+                          app_outbox_class_name(msg_class),
+                          (unsigned int)app_outbox_count());
+      return;
+    }
+
+    uint32_t ttl_s = app_outbox_ttl_left_s(msg_class, entry, app_retained_now_ms());
+    outbox_result_t result = OUTBOX_DROPPED;
+    switch (entry->kind) {
+      case APP_OUTBOX_KIND_ALARM:
+        result = send_alarm(app_context, entry, ttl_s);
+        break;
+      case APP_OUTBOX_KIND_COUNTER:
+        result = send_counter_update(app_context, ttl_s);
+        break;
+      case APP_OUTBOX_KIND_REPORT:
+        result = send_report(app_context, ttl_s);
+        break;
+      case APP_OUTBOX_KIND_PAYLOAD:
+        result = send_payload(app_context, entry, ttl_s);
+        break;
+      default:
+        break;
+    }
+    if (result == OUTBOX_HELD) {
+      // First in line until the airtime budget allows it
+      return;
+    }
+    app_outbox_pop(app_retained_now_ms(), result == OUTBOX_SENT);
+  }
+}
+
+static void alarm_bring_up(app_context_t *app_context)
+{
+#if defined(SL_BLE_SUPPORTED)
+  // BLE is the fastest link to come up, on request of the device
+  if ((app_context->current_link_type & SID_LINK_TYPE_1) != 0
+      && !app_link_router_is_up(SID_LINK_TYPE_1)
+      && !app_context->connection_request) {
+    toggle_connection_request(app_context);
+  }
+#else
+  UNUSED(app_context);
+#endif
+  // EM4 is held off meanwhile, see em4_sleep()
+  reset_burtc_timer();
+}
+
+static void outbox_stats(void)
+{
+  for (uint32_t i = 0; i < APP_OUTBOX_CLASS_COUNT; i++) {
+    const app_outbox_stats_t *stats = app_outbox_get_stats((app_outbox_class_t)i);
+    SL_SID_LOG_APP_INFO("%s uplinks, ttl: %lu s, waiting: %u, max: %lu, queued: %lu, sent: %lu, expired: %lu, dropped: %lu",
+                        app_outbox_class_name((app_outbox_class_t)i),
+                        (unsigned long)app_outbox_ttl_s((app_outbox_class_t)i),
+                        (unsigned int)app_outbox_depth((app_outbox_class_t)i),
+                        (unsigned long)stats->depth_max,
+                        (unsigned long)stats->queued,
+                        (unsigned long)stats->sent,
+                        (unsigned long)stats->expired,
+                        (unsigned long)stats->dropped);
+    if (stats->sent != 0) {
+      SL_SID_LOG_APP_INFO("%s wait, min: %lu ms, avg: %lu ms, max: %lu ms",
+                          app_outbox_class_name((app_outbox_class_t)i),
+                          (unsigned long)stats->wait_min_ms,
+                          (unsigned long)(stats->wait_sum_ms / stats->sent),
+                          (unsigned long)stats->wait_max_ms);
+    }
+  }
+}
+
+static void scheduled_send(app_context_t *app_context)
+{
+  if (app_schedule_ms_until_due() != 0) {
+    // Timer of a schedule that moved meanwhile
+    schedule_arm();
+    return;
+  }
+  if (app_context->state != STATE_SIDEWALK_READY) {
+    schedule_waiting = true;
+    SL_SID_LOG_APP_INFO("scheduled uplink due, waiting for sidewalk ready");
+    return;
+  }
+  schedule_waiting = false;
+
+  outbox_push(APP_OUTBOX_CLASS_NORMAL, APP_OUTBOX_KIND_COUNTER, 0);
+  outbox_pump(app_context);
+
+  struct sid_timespec gps_time = { 0 };
+  bool time_valid = (sid_get_time(app_context->sidewalk_handle, SID_GET_GPS_TIME, &gps_time) == SID_ERROR_NONE);
+  app_schedule_advance(time_valid, gps_time.tv_sec);
+  SL_SID_LOG_APP_INFO("scheduled uplink sent, next in: %lu ms, gps aligned: %d, missed: %lu",
+                      (unsigned long)app_schedule_ms_until_due(),
+                      (int)time_valid,
+                      (unsigned long)app_schedule_get_missed());
+  schedule_arm();
+}
+
+static void schedule_arm(void)
+{
+  uint32_t until_due_ms = app_schedule_ms_until_due();
+
+  if (until_due_ms == UINT32_MAX) {
+    return;
+  }
+  if (until_due_ms == 0) {
+    queue_event(g_event_queue, EVENT_TYPE_SCHEDULED_SEND);
+    return;
+  }
+  (void)xTimerChangePeriod(schedule_timer, pdMS_TO_TICKS(until_due_ms) + 1, 0);
+}
+
+static void schedule_timer_callback(TimerHandle_t timer)
+{
+  UNUSED(timer);
+  queue_event(g_event_queue, EVENT_TYPE_SCHEDULED_SEND);
+}
+
+static void awake_lease(uint32_t seconds)
+{
+  app_rendezvous_lease(seconds);
+  // The inactivity timeout restarts, EM4 is then held off for the rest
+  reset_burtc_timer();
+  SL_SID_LOG_APP_INFO("awake lease, hold: %lu ms", (unsigned long)app_rendezvous_hold_ms());
+}
+
+static void rendezvous_timer_callback(TimerHandle_t timer)
+{
+  UNUSED(timer);
+  queue_event(g_event_queue, EVENT_TYPE_EM4_TIMEOUT);
+}
+
+static void drain_samples(bool all)
+{
+  app_sample_t batch[SAMPLE_DRAIN_BATCH];
+  size_t count = 0;
+
+  // Cleared first: a sample pushed from now on queues a new event
+  atomic_store(&samples_event_pending, false);
+  do {
+    count = app_sample_ring_pop(batch, SAMPLE_DRAIN_BATCH);
+    for (size_t i = 0; i < count; i++) {
+      switch (batch[i].type) {
+        case APP_SAMPLE_COUNTER:
+          app_report_add_sample(batch[i].timestamp, batch[i].value);
+          break;
+        default:
+          SL_SID_LOG_APP_WARNING("unknown sample type: %u", (unsigned int)batch[i].type);
+          break;
+      }
+    }
+  } while (all && count == SAMPLE_DRAIN_BATCH);
+
+  // Leave the queue to the Sidewalk events before the next batch
+  if (app_sample_ring_count() != 0 && !atomic_exchange(&samples_event_pending, true)) {
+    queue_event(g_event_queue, EVENT_TYPE_SAMPLES);
+  }
+}
+
+static bool airtime_admit(uint32_t link, uint32_t airtime_us, enum event_type retry_event)
+{
+  // A higher class uplink may go out on a link with budget left
+  uint32_t wait_ms = app_airtime_wait_ms(link, airtime_us);
+  if (wait_ms == 0) {
+    return true;
+  }
+
+  if ((airtime_deferred_events & (1UL << retry_event)) != 0) {
+    app_airtime_count_deferral(link, true);
+    SL_SID_LOG_APP_INFO("uplink waits behind the held back one, %s", app_link_router_link_name(link));
+    return false;
+  }
+
+  app_airtime_count_deferral(link, false);
+  airtime_deferred_events |= (1UL << retry_event);
+
+  // One timer for all held back uplinks, it fires for the latest one
+  TickType_t wait_ticks = pdMS_TO_TICKS(wait_ms) + 1;
+  if (xTimerIsTimerActive(airtime_timer) == pdFALSE
+      || (xTimerGetExpiryTime(airtime_timer) - xTaskGetTickCount()) < wait_ticks) {
+    (void)xTimerChangePeriod(airtime_timer, wait_ticks, 0);
+  }
+  SL_SID_LOG_APP_WARNING("%s held back, %s airtime budget exceeded, retry in %lu ms",
+                         event_type_name(retry_event),
+                         app_link_router_link_name(link),
+                         (unsigned long)wait_ms);
+  return false;
+}
+
+static void airtime_retry(void)
+{
+  uint32_t events = airtime_deferred_events;
+
+  airtime_deferred_events = 0;
+  for (uint32_t event = 0; event < EVENT_TYPE_INVALID; event++) {
+    if ((events & (1UL << event)) != 0) {
+      queue_event(g_event_queue, (enum event_type)event);
+    }
+  }
+}
+
+static void airtime_stats(app_context_t *context)
+{
+  uint32_t link = 0;
+
+  while ((link = app_link_router_next_link(context->current_link_type, link)) != 0) {
+    const app_airtime_stats_t *stats = app_airtime_get_stats(link);
+    SL_SID_LOG_APP_INFO("%s airtime: %lu ms, sent: %lu, deferred: %lu, merged: %lu",
+                        app_link_router_link_name(link),
+                        (unsigned long)stats->airtime_ms,
+                        (unsigned long)stats->sent,
+                        (unsigned long)stats->deferred,
+                        (unsigned long)stats->merged);
+    uint32_t left_ms = app_airtime_get_left_ms(link);
+    if (left_ms != UINT32_MAX) {
+      SL_SID_LOG_APP_INFO("%s budget left: %lu ms of %lu ms per hour",
+                          app_link_router_link_name(link),
+                          (unsigned long)left_ms,
+                          (unsigned long)APP_AIRTIME_BUDGET_MS_PER_HOUR);
+    }
+    const app_tx_power_stats_t *power = app_tx_power_get_stats(link);
+    if (power->measured) {
+      SL_SID_LOG_APP_INFO("%s tx power: %d dBm, margin: %d dB, steps down: %lu, up: %lu",
+                          app_link_router_link_name(link),
+                          (int)power->power_dbm,
+                          (int)power->margin_db,
+                          (unsigned long)power->steps_down,
+                          (unsigned long)power->steps_up);
     } else {
-      SL_SID_LOG_APP_INFO("message queued");
-      SL_SID_LOG_APP_INFO("link type: %x, msg id: %u, msg size: %u, msg type: %d, ack requested: %d, ttl: %d, max retry: %d, additional attr: %d",
-                          desc.link_type,
-                          desc.id,
-                          msg.size,
-                          (int)desc.type,
-                          desc.msg_desc_attr.tx_attr.request_ack,
-                          desc.msg_desc_attr.tx_attr.ttl_in_seconds,
-                          desc.msg_desc_attr.tx_attr.num_retries,
-                          desc.msg_desc_attr.tx_attr.additional_attr);
-      SL_SID_LOG_APP_HEXDUMP_INFO((const void *)msg.data, msg.size);
+      SL_SID_LOG_APP_INFO("%s tx power: %d dBm, no downlink yet",
+                          app_link_router_link_name(link),
+                          (int)power->power_dbm);
     }
+    uint32_t outcomes = 0;
+    uint32_t failures = app_ack_policy_get_failures(link, &outcomes);
+    const app_ack_policy_stats_t *acks = app_ack_policy_get_stats(link);
+    SL_SID_LOG_APP_INFO("%s delivery: %s, failed %lu of last %lu, unacked: %lu, probes: %lu, acked: %lu, confirmed: %lu, errors: %lu",
+                        app_link_router_link_name(link),
+                        app_ack_policy_is_degraded(link) ? "degraded" : "healthy",
+                        (unsigned long)failures,
+                        (unsigned long)outcomes,
+                        (unsigned long)acks->unacked,
+                        (unsigned long)acks->probes,
+                        (unsigned long)acks->acked,
+                        (unsigned long)acks->delivered,
+                        (unsigned long)acks->failed);
+  }
+}
 
-    app_context->counter++;
-  } else {
-    SL_SID_LOG_APP_ERROR("sidewalk not ready yet");
+static void airtime_timer_callback(TimerHandle_t timer)
+{
+  UNUSED(timer);
+  queue_event(g_event_queue, EVENT_TYPE_AIRTIME_RETRY);
+}
+
+static void tx_power_apply(uint32_t link)
+{
+  int8_t power_dbm = app_tx_power_get_dbm(link);
+
+#if defined(SL_BLE_SUPPORTED)
+  if (link == SID_LINK_TYPE_1) {
+    // 0.1 dBm units, the stack picks the closest power the PA supports. The
+    // range is pinned to the power so LE power control does not drop to the
+    // minimum of the range.
+    int16_t set_min = 0;
+    int16_t set_max = 0;
+    sl_status_t status = sl_bt_system_set_tx_power((int16_t)(power_dbm * 10),
+                                                   (int16_t)(power_dbm * 10),
+                                                   &set_min,
+                                                   &set_max);
+    if (status != SL_STATUS_OK) {
+      SL_SID_LOG_APP_ERROR("ble tx power not set, status: 0x%04lx", (unsigned long)status);
+    }
+    return;
+  }
+#endif
+
+#if (defined(SL_FSK_SUPPORTED) || defined(SL_CSS_SUPPORTED))
+  if (link == SID_LINK_TYPE_2 || link == SID_LINK_TYPE_3) {
+    // FSK and CSS share the radio, set it for the link of this uplink
+    int32_t ret = sid_pal_radio_set_tx_power(power_dbm);
+    if (ret != RADIO_ERROR_NONE) {
+      SL_SID_LOG_APP_ERROR("sub-ghz tx power not set, error: %d", (int)ret);
+    }
   }
+#endif
+
+  UNUSED(power_dbm);
+}
+
+static void tx_power_changed(uint32_t link, const char *reason)
+{
+  const app_tx_power_stats_t *power = app_tx_power_get_stats(link);
+
+  SL_SID_LOG_APP_INFO("%s tx power %d dBm after %s, margin: %d dB",
+                      app_link_router_link_name(link),
+                      (int)power->power_dbm,
+                      reason,
+                      (int)power->margin_db);
 }
 
 static void factory_reset(app_context_t *context)
@@ -878,6 +2583,7 @@ static void factory_reset(app_context_t *context)
   if (ret != SID_ERROR_NONE) {
     SL_SID_LOG_APP_ERROR("factory reset failed, error: %d", (int)ret);
 
+    app_trace_flush();
     NVIC_SystemReset();
   } else {
     SL_SID_LOG_APP_INFO("factory reset request accepted");
@@ -897,11 +2603,15 @@ static void get_time(app_context_t *context)
 
 static void get_mtu(app_context_t *context)
 {
-  size_t mtu;
-  sid_error_t ret = sid_get_mtu(context->sidewalk_handle, application_context.current_link_type, &mtu);
-  if (ret == SID_ERROR_NONE) {
-    SL_SID_LOG_APP_INFO("current MTU: %d", mtu);
-  } else {
-    SL_SID_LOG_APP_ERROR("get MTU failed, error: %d", (int)ret);
+  uint32_t link = 0;
+
+  while ((link = app_link_router_next_link(context->current_link_type, link)) != 0) {
+    size_t mtu;
+    sid_error_t ret = sid_get_mtu(context->sidewalk_handle, (enum sid_link_type)link, &mtu);
+    if (ret == SID_ERROR_NONE) {
+      SL_SID_LOG_APP_INFO("%s MTU: %d, up: %d", app_link_router_link_name(link), (int)mtu, app_link_router_is_up(link));
+    } else {
+      SL_SID_LOG_APP_ERROR("get %s MTU failed, error: %d", app_link_router_link_name(link), (int)ret);
+    }
   }
 }
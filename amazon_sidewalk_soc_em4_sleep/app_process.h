@@ -35,6 +35,9 @@ extern "C" {
 #endif
 
 #include <stdint.h>
+#include <stdbool.h>
+#include "app_bench.h"
+#include "app_payload.h"
 
 // -----------------------------------------------------------------------------
 //                                   Includes
@@ -61,6 +64,26 @@ void main_thread(void * context);
  ******************************************************************************/
 void app_trigger_send_counter_update(void);
 
+/*******************************************************************************
+ * Application function to send a payload filled by the caller
+ *
+ * The buffer is sent as is in a single frame when it fits the MTU, without
+ * diagnostics, no copy is made on the way to the stack. It is owned by the
+ * main task from this call on, whatever the outcome.
+ *
+ * @param[in] payload Buffer claimed with app_payload_claim(), its size set,
+ *                    starting with a byte below 0x80 (see app_segment.h)
+ *
+ * @returns #false if the payload is empty or starts with bit 7 set, or if the
+ *          event queue is full, the buffer is released
+ ******************************************************************************/
+bool app_trigger_send(app_payload_handle_t payload);
+
+/*******************************************************************************
+ * Application function to send the pending samples as a compressed report
+ ******************************************************************************/
+void app_trigger_send_report(void);
+
 /*******************************************************************************
  * Application function to connect, update and send counter
  ******************************************************************************/
@@ -76,6 +99,70 @@ void app_trigger_factory_reset(void);
  ******************************************************************************/
 void app_trigger_get_time(void);
 
+/*******************************************************************************
+ * Application function to print the event trace
+ ******************************************************************************/
+void app_trigger_trace_dump(void);
+
+/*******************************************************************************
+ * Application function to print the airtime counters
+ ******************************************************************************/
+void app_trigger_airtime_stats(void);
+
+/*******************************************************************************
+ * Application function to keep the device awake for a while
+ *
+ * The receive window is extended so downlinks get through, then the device
+ * goes back to its regular EM4 cycle.
+ *
+ * @param[in] seconds Lease from now, capped to APP_RENDEZVOUS_LEASE_MAX_S
+ ******************************************************************************/
+void app_trigger_awake_lease(uint16_t seconds);
+
+/*******************************************************************************
+ * Application function to raise an alarm
+ *
+ * The alarm goes out ahead of the waiting uplinks on the fastest link, EM4 is
+ * held off until it is sent or its TTL is over. Callable from an ISR.
+ *
+ * @param[in] code Alarm code, below APP_OUTBOX_ALARM_CODES
+ ******************************************************************************/
+void app_trigger_alarm(uint8_t code);
+
+/*******************************************************************************
+ * Application function to print the outbox counters per message class
+ ******************************************************************************/
+void app_trigger_outbox_stats(void);
+
+/*******************************************************************************
+ * Application function to print the restart counters of the Sidewalk stack
+ ******************************************************************************/
+void app_trigger_supervisor_stats(void);
+
+/*******************************************************************************
+ * Application function to hand a sensor sample to the uplink pipeline
+ *
+ * Lock free and callable from an ISR or a timer callback, see
+ * app_sample_ring.h for the single producer rule. Samples are batched into
+ * the next report by the main task.
+ *
+ * @param[in] type Sample type, app_sample_type_t
+ * @param[in] value Sample value
+ ******************************************************************************/
+void app_submit_sample(uint8_t type, int32_t value);
+
+/*******************************************************************************
+ * Application function to start a throughput and latency bench run
+ *
+ * @param[in] config Bench parameters
+ ******************************************************************************/
+void app_trigger_bench(const app_bench_config_t *config);
+
+/*******************************************************************************
+ * Application function to stop the bench run and print its summary
+ ******************************************************************************/
+void app_trigger_bench_stop(void);
+
 /*******************************************************************************
  * Application function to trigger get MTU
  ******************************************************************************/
@@ -83,8 +170,11 @@ void app_trigger_get_mtu(void);
 
 /*******************************************************************************
  * Application function to switch between BLE/FSK/CSS
+ *
+ * @param[in] link Link to switch to (SID_LINK_TYPE_x), 0 for the next one in
+ *                 the order BLE -> FSK -> CSS
  ******************************************************************************/
-void app_trigger_link_switch(void);
+void app_trigger_link_switch(uint32_t link);
 
 /*******************************************************************************
  * Application function to trigger connection request
@@ -0,0 +1,150 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_radio_sleep.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdbool.h>
+#include "app_radio_sleep.h"
+#include "app_retained.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Weight of a new measure in the mean, 1/2^n
+#define REINIT_MEAN_SHIFT       (2U)
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to get the retained slot of a depth re-init time
+ *
+ * @param[in] depth APP_RADIO_SLEEP_WARM or APP_RADIO_SLEEP_COLD
+ *
+ * @returns Retained slot
+ ******************************************************************************/
+static app_retained_slot_t reinit_slot(app_radio_sleep_depth_t depth);
+
+// -----------------------------------------------------------------------------
+//                                Global Variables
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+// Depth the radio slept in before this boot
+static app_radio_sleep_depth_t slept_depth;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+void app_radio_sleep_init(void)
+{
+  slept_depth = APP_RADIO_SLEEP_NONE;
+  if (app_retained_is_em4_wake()) {
+    slept_depth = (app_radio_sleep_depth_t)app_retained_get(APP_RETAINED_SLOT_RADIO_SLEEP_DEPTH);
+  }
+  // Only the boot right after the sleep measures it
+  app_retained_set(APP_RETAINED_SLOT_RADIO_SLEEP_DEPTH, APP_RADIO_SLEEP_NONE);
+}
+
+void app_radio_sleep_on_start(uint32_t start_ms)
+{
+  if (slept_depth != APP_RADIO_SLEEP_WARM && slept_depth != APP_RADIO_SLEEP_COLD) {
+    return;
+  }
+
+  app_retained_slot_t slot = reinit_slot(slept_depth);
+  uint32_t mean_x16 = app_retained_get(slot);
+  uint32_t sample_x16 = (start_ms << 4) | 1U; // Never 0, that means not measured
+  if (mean_x16 == 0) {
+    mean_x16 = sample_x16;
+  } else {
+    mean_x16 = mean_x16 - (mean_x16 >> REINIT_MEAN_SHIFT) + (sample_x16 >> REINIT_MEAN_SHIFT);
+  }
+  app_retained_set(slot, mean_x16);
+  slept_depth = APP_RADIO_SLEEP_NONE;
+}
+
+app_radio_sleep_depth_t app_radio_sleep_select(uint32_t sleep_ms, bool cold_available)
+{
+  if (!cold_available) {
+    return APP_RADIO_SLEEP_WARM;
+  }
+  if (app_retained_get(APP_RETAINED_SLOT_RADIO_REINIT_COLD) == 0) {
+    return APP_RADIO_SLEEP_COLD;
+  }
+  if (app_retained_get(APP_RETAINED_SLOT_RADIO_REINIT_WARM) == 0) {
+    return APP_RADIO_SLEEP_WARM;
+  }
+
+  return (sleep_ms >= app_radio_sleep_break_even_ms()) ? APP_RADIO_SLEEP_COLD : APP_RADIO_SLEEP_WARM;
+}
+
+void app_radio_sleep_entered(app_radio_sleep_depth_t depth)
+{
+  app_retained_set(APP_RETAINED_SLOT_RADIO_SLEEP_DEPTH, (uint32_t)depth);
+}
+
+uint32_t app_radio_sleep_break_even_ms(void)
+{
+  uint32_t warm_x16 = app_retained_get(APP_RETAINED_SLOT_RADIO_REINIT_WARM);
+  uint32_t cold_x16 = app_retained_get(APP_RETAINED_SLOT_RADIO_REINIT_COLD);
+  uint32_t extra_x16 = APP_RADIO_SLEEP_COLD_EXTRA_MS << 4;
+
+  if (warm_x16 != 0 && cold_x16 != 0) {
+    extra_x16 = (cold_x16 > warm_x16) ? cold_x16 - warm_x16 : 0U;
+  }
+
+  // extra time * active current = sleep * (warm - cold current)
+  uint64_t break_even_ms = ((uint64_t)extra_x16 * APP_RADIO_SLEEP_ACTIVE_UA * 1000U)
+                           / ((uint64_t)(APP_RADIO_SLEEP_WARM_NA - APP_RADIO_SLEEP_COLD_NA) << 4);
+  return (break_even_ms > UINT32_MAX) ? UINT32_MAX : (uint32_t)break_even_ms;
+}
+
+uint32_t app_radio_sleep_reinit_x16(app_radio_sleep_depth_t depth)
+{
+  if (depth != APP_RADIO_SLEEP_WARM && depth != APP_RADIO_SLEEP_COLD) {
+    return 0;
+  }
+  return app_retained_get(reinit_slot(depth));
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+static app_retained_slot_t reinit_slot(app_radio_sleep_depth_t depth)
+{
+  return (depth == APP_RADIO_SLEEP_COLD) ? APP_RETAINED_SLOT_RADIO_REINIT_COLD : APP_RETAINED_SLOT_RADIO_REINIT_WARM;
+}
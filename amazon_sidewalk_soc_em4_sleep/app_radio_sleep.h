@@ -0,0 +1,123 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_radio_sleep.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef APP_RADIO_SLEEP_H
+#define APP_RADIO_SLEEP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdbool.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// SX126x sleep current, warm start keeps the configuration
+#define APP_RADIO_SLEEP_WARM_NA         (600U)
+#define APP_RADIO_SLEEP_COLD_NA         (160U)
+// Current while the MCU brings the radio back up
+#define APP_RADIO_SLEEP_ACTIVE_UA       (4000U)
+// Extra re-init time of a cold start assumed until both depths are measured
+#define APP_RADIO_SLEEP_COLD_EXTRA_MS   (5U)
+
+// Radio sleep depth before EM4
+typedef enum {
+  APP_RADIO_SLEEP_NONE = 0,   // Radio not put to sleep, or no sub-GHz link
+  APP_RADIO_SLEEP_WARM,
+  APP_RADIO_SLEEP_COLD,
+} app_radio_sleep_depth_t;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to load the depth the radio slept in and the re-init times, after
+ * app_retained_init()
+ ******************************************************************************/
+void app_radio_sleep_init(void);
+
+/*******************************************************************************
+ * Function to account the first radio start of the boot
+ *
+ * The time is credited to the depth the radio slept in, a start that does not
+ * follow a radio sleep is ignored.
+ *
+ * @param[in] start_ms Time taken to initialize and start the sub-GHz link
+ ******************************************************************************/
+void app_radio_sleep_on_start(uint32_t start_ms);
+
+/*******************************************************************************
+ * Function to pick the sleep depth
+ *
+ * Cold start is picked when the current saved over the sleep outweighs its
+ * extra re-init time. A depth not measured yet is tried once. Without a cold
+ * start sleep in the PAL, the radio always sleeps warm.
+ *
+ * @param[in] sleep_ms Planned EM4 sleep
+ * @param[in] cold_available The PAL provides the cold start sleep
+ *
+ * @returns APP_RADIO_SLEEP_WARM or APP_RADIO_SLEEP_COLD
+ ******************************************************************************/
+app_radio_sleep_depth_t app_radio_sleep_select(uint32_t sleep_ms, bool cold_available);
+
+/*******************************************************************************
+ * Function to record the depth the radio was put in before EM4
+ *
+ * @param[in] depth Sleep depth
+ ******************************************************************************/
+void app_radio_sleep_entered(app_radio_sleep_depth_t depth);
+
+/*******************************************************************************
+ * Function to get the sleep above which cold start pays off
+ *
+ * @returns Break-even sleep in ms
+ ******************************************************************************/
+uint32_t app_radio_sleep_break_even_ms(void);
+
+/*******************************************************************************
+ * Function to get the mean re-init time after a depth
+ *
+ * @param[in] depth APP_RADIO_SLEEP_WARM or APP_RADIO_SLEEP_COLD
+ *
+ * @returns Re-init time in 1/16 ms, 0 when not measured
+ ******************************************************************************/
+uint32_t app_radio_sleep_reinit_x16(app_radio_sleep_depth_t depth);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_RADIO_SLEEP_H
@@ -0,0 +1,179 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_rendezvous.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include "app_rendezvous.h"
+#include "app_retained.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to drop the promised window once it is over
+ *
+ * @param[in] now_ms Device time
+ ******************************************************************************/
+static void expire(uint32_t now_ms);
+
+/*******************************************************************************
+ * Function to get the time left to the awake lease
+ *
+ * @param[in] now_ms Device time
+ *
+ * @returns Time in ms, 0 if no lease is running
+ ******************************************************************************/
+static uint32_t lease_left_ms(uint32_t now_ms);
+
+// -----------------------------------------------------------------------------
+//                                Global Variables
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+// Device time of the promised window, 0: none. Kept in backup RAM.
+static uint32_t window_ms;
+// End of the awake lease, lost with RAM as the device only sleeps after it
+static uint32_t lease_until_ms;
+static bool leased;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+void app_rendezvous_init(void)
+{
+  window_ms = app_retained_get(APP_RETAINED_SLOT_RENDEZVOUS_MS);
+  leased = false;
+  expire(app_retained_now_ms());
+}
+
+uint32_t app_rendezvous_hint(uint32_t lead_ms)
+{
+  uint32_t now_ms = app_retained_now_ms();
+  uint32_t left_ms = lease_left_ms(now_ms);
+
+  expire(now_ms);
+  if (left_ms != 0) {
+    return left_ms / 1000U;
+  }
+  if (window_ms == 0) {
+    // Never 0, that means none
+    window_ms = (now_ms + lead_ms != 0) ? now_ms + lead_ms : 1U;
+    app_retained_set(APP_RETAINED_SLOT_RENDEZVOUS_MS, window_ms);
+  }
+
+  // Device time wraps, compare differences. Past the start, expire() keeps
+  // the difference above -APP_RENDEZVOUS_WINDOW_MS.
+  int32_t to_ms = (int32_t)(window_ms - now_ms);
+  uint32_t in_s = (to_ms > 0) ? ((uint32_t)to_ms + 999U) / 1000U : 0U;
+  uint32_t for_s = (to_ms > 0) ? APP_RENDEZVOUS_WINDOW_MS / 1000U
+                   : (uint32_t)(to_ms + (int32_t)APP_RENDEZVOUS_WINDOW_MS) / 1000U;
+  return ((in_s > UINT16_MAX ? UINT16_MAX : in_s) << 16) | for_s;
+}
+
+void app_rendezvous_lease(uint32_t seconds)
+{
+  uint32_t now_ms = app_retained_now_ms();
+
+  if (seconds > APP_RENDEZVOUS_LEASE_MAX_S) {
+    seconds = APP_RENDEZVOUS_LEASE_MAX_S;
+  }
+  if (seconds * 1000U > lease_left_ms(now_ms)) {
+    lease_until_ms = now_ms + (seconds * 1000U);
+    leased = true;
+  }
+}
+
+bool app_rendezvous_parse_lease(const uint8_t *data, size_t size, uint32_t *seconds)
+{
+  if (data == NULL || size != 3U || data[0] != APP_RENDEZVOUS_LEASE_COMMAND) {
+    return false;
+  }
+  *seconds = ((uint32_t)data[1] << 8) | data[2];
+  return true;
+}
+
+uint32_t app_rendezvous_hold_ms(void)
+{
+  uint32_t now_ms = app_retained_now_ms();
+  uint32_t hold_ms = lease_left_ms(now_ms);
+
+  expire(now_ms);
+  // Inside the window or too close to it to sleep first
+  if (window_ms != 0) {
+    int32_t to_ms = (int32_t)(window_ms - now_ms);
+    if (to_ms <= (int32_t)APP_RENDEZVOUS_MIN_SLEEP_MS
+        && (uint32_t)(to_ms + (int32_t)APP_RENDEZVOUS_WINDOW_MS) > hold_ms) {
+      hold_ms = (uint32_t)(to_ms + (int32_t)APP_RENDEZVOUS_WINDOW_MS);
+    }
+  }
+
+  return hold_ms;
+}
+
+uint32_t app_rendezvous_sleep_ms(uint32_t sleep_ms)
+{
+  int32_t to_ms = (int32_t)(window_ms - app_retained_now_ms());
+
+  if (window_ms != 0 && to_ms > 0 && (uint32_t)to_ms < sleep_ms) {
+    return (uint32_t)to_ms;
+  }
+  return sleep_ms;
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+static void expire(uint32_t now_ms)
+{
+  if (window_ms != 0 && (int32_t)(now_ms - window_ms) >= (int32_t)APP_RENDEZVOUS_WINDOW_MS) {
+    window_ms = 0;
+    app_retained_set(APP_RETAINED_SLOT_RENDEZVOUS_MS, 0);
+  }
+}
+
+static uint32_t lease_left_ms(uint32_t now_ms)
+{
+  int32_t left_ms = (int32_t)(lease_until_ms - now_ms);
+
+  if (!leased || left_ms <= 0) {
+    leased = false;
+    return 0;
+  }
+  return (uint32_t)left_ms;
+}
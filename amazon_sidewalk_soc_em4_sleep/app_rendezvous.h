@@ -0,0 +1,119 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_rendezvous.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef APP_RENDEZVOUS_H
+#define APP_RENDEZVOUS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Receive window promised in the uplinks, counted from the wake-up
+#define APP_RENDEZVOUS_WINDOW_MS        (20000UL)
+// A window closer than this is waited for awake rather than in EM4
+#define APP_RENDEZVOUS_MIN_SLEEP_MS     (2000UL)
+// Longest awake lease, requests above are capped
+#define APP_RENDEZVOUS_LEASE_MAX_S      (3600U)
+// Lease taken by a long press on PB0
+#define APP_RENDEZVOUS_BUTTON_LEASE_S   (120U)
+// Downlink asking for a lease, followed by the duration in s (2 bytes, big endian)
+#define APP_RENDEZVOUS_LEASE_COMMAND    (0xA1U)
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to restore the promised window at boot, after app_retained_init()
+ ******************************************************************************/
+void app_rendezvous_init(void);
+
+/*******************************************************************************
+ * Function to get the hint carried by an uplink
+ *
+ * Promises the next receive window if none is pending: the wake-up after
+ * lead_ms, from then on the device keeps to it. An active lease is reported
+ * instead, the device being awake right away.
+ *
+ * @param[in] lead_ms Time to the regular wake-up after this uplink
+ *
+ * @returns Seconds to the window << 16 | window length in s
+ ******************************************************************************/
+uint32_t app_rendezvous_hint(uint32_t lead_ms);
+
+/*******************************************************************************
+ * Function to extend the awake time
+ *
+ * @param[in] seconds Lease from now, capped to APP_RENDEZVOUS_LEASE_MAX_S
+ ******************************************************************************/
+void app_rendezvous_lease(uint32_t seconds);
+
+/*******************************************************************************
+ * Function to recognize a lease request in a downlink
+ *
+ * @param[in] data Downlink payload
+ * @param[in] size Payload size
+ * @param[out] seconds Lease requested
+ *
+ * @returns #true if the downlink is a lease request
+ ******************************************************************************/
+bool app_rendezvous_parse_lease(const uint8_t *data, size_t size, uint32_t *seconds);
+
+/*******************************************************************************
+ * Function to get how long the device has to stay awake before EM4
+ *
+ * @returns Time in ms, 0 if the device may sleep now
+ ******************************************************************************/
+uint32_t app_rendezvous_hold_ms(void);
+
+/*******************************************************************************
+ * Function to cut a sleep short so the device wakes up for the promised window
+ *
+ * @param[in] sleep_ms Planned sleep
+ *
+ * @returns Sleep in ms
+ ******************************************************************************/
+uint32_t app_rendezvous_sleep_ms(uint32_t sleep_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_RENDEZVOUS_H
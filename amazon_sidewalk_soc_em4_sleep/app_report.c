@@ -0,0 +1,172 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_report.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <string.h>
+
+#include "app_report.h"
+#include "app_series_codec.h"
+#include "app_segment.h"
+#include "app_nvm.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+_Static_assert(APP_SERIES_CODEC_TYPE < APP_SEGMENT_HEADER_MARKER, "report taken for a fragment header");
+_Static_assert(APP_REPORT_STORED_BYTES <= UINT8_MAX, "stored batch size is kept in one byte");
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Global Variables
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+// Pending samples, oldest first
+static app_series_sample_t samples[APP_REPORT_MAX_SAMPLES];
+static size_t sample_count;
+static uint32_t dropped_count;
+
+// Stored batch, its size in the first byte
+static uint8_t stored[1U + APP_REPORT_STORED_BYTES];
+// Samples added or consumed since the batch was restored or saved
+static bool changed;
+// The stored batch holds samples
+static bool stored_samples;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+void app_report_restore(void)
+{
+  size_t count = 0;
+
+  if (!app_nvm_read_partial(APP_NVM_KEY_REPORT_BATCH, stored, 1U)
+      || stored[0] > APP_REPORT_STORED_BYTES
+      || !app_nvm_read_partial(APP_NVM_KEY_REPORT_BATCH, stored, 1U + stored[0])) {
+    return;
+  }
+
+  stored_samples = (stored[0] != 0);
+  if (stored_samples && app_series_decode(&stored[1], stored[0], samples, APP_REPORT_MAX_SAMPLES, &count)) {
+    sample_count = count;
+  }
+  changed = false;
+}
+
+void app_report_save(void)
+{
+  size_t first = 0;
+  size_t encoded = 0;
+  size_t size = 0;
+
+  if (!changed || (sample_count == 0 && !stored_samples)) {
+    return;
+  }
+
+  for (; first < sample_count; first++) {
+    size = app_series_encode(&samples[first], sample_count - first, &stored[1], APP_REPORT_STORED_BYTES, &encoded);
+    if (first + encoded == sample_count) {
+      break;
+    }
+  }
+  if (first == sample_count) {
+    size = 0;
+  }
+  dropped_count += (uint32_t)first;
+
+  stored[0] = (uint8_t)size;
+  // Lost on EM4 if the write failed, the next wake-up carries on without them
+  if (app_nvm_write(APP_NVM_KEY_REPORT_BATCH, stored, 1U + size)) {
+    stored_samples = (size != 0);
+    changed = false;
+  }
+}
+
+void app_report_add_sample(uint32_t timestamp, int32_t value)
+{
+  changed = true;
+  if (sample_count == APP_REPORT_MAX_SAMPLES) {
+    app_report_consume(1);
+    dropped_count++;
+  }
+
+  samples[sample_count].timestamp = timestamp;
+  samples[sample_count].value = value;
+  sample_count++;
+}
+
+size_t app_report_pending(void)
+{
+  return sample_count;
+}
+
+size_t app_report_build(uint8_t *out, size_t out_size, size_t *count)
+{
+  return app_series_encode(samples, sample_count, out, out_size, count);
+}
+
+void app_report_consume(size_t count)
+{
+  if (count != 0) {
+    changed = true;
+  }
+  if (count >= sample_count) {
+    sample_count = 0;
+    return;
+  }
+
+  memmove(&samples[0], &samples[count], (sample_count - count) * sizeof(samples[0]));
+  sample_count -= count;
+}
+
+size_t app_report_expire(uint32_t now_ms, uint32_t max_age_ms)
+{
+  size_t stale = 0;
+
+  while (stale < sample_count && (now_ms - samples[stale].timestamp) > max_age_ms) {
+    stale++;
+  }
+  app_report_consume(stale);
+  return stale;
+}
+
+uint32_t app_report_get_dropped(void)
+{
+  return dropped_count;
+}
@@ -0,0 +1,127 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_report.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef APP_REPORT_H
+#define APP_REPORT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stddef.h>
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Samples kept until they are reported, the oldest are dropped beyond that
+#define APP_REPORT_MAX_SAMPLES      (32U)
+// Encoded batch kept in NVM3 across EM4, the object stays below the 254 bytes
+// NVM3 accepts by default
+#define APP_REPORT_STORED_BYTES     (240U)
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to load the samples kept in NVM3 by the last app_report_save()
+ ******************************************************************************/
+void app_report_restore(void);
+
+/*******************************************************************************
+ * Function to keep the pending samples in NVM3, before EM4
+ *
+ * The batch is stored encoded and only when it changed since the last
+ * restore or save. The oldest samples are dropped if it does not fit
+ * APP_REPORT_STORED_BYTES.
+ ******************************************************************************/
+void app_report_save(void);
+
+/*******************************************************************************
+ * Function to add a sample to the next report, main task only
+ *
+ * @param[in] timestamp Sample time in ms, see app_retained_now_ms()
+ * @param[in] value Sample value
+ ******************************************************************************/
+void app_report_add_sample(uint32_t timestamp, int32_t value);
+
+/*******************************************************************************
+ * Function to get the number of samples waiting to be reported
+ *
+ * @returns Number of pending samples
+ ******************************************************************************/
+size_t app_report_pending(void);
+
+/*******************************************************************************
+ * Function to encode the oldest pending samples into a report
+ *
+ * The pending samples are not removed, see app_report_consume().
+ *
+ * @param[out] out Output buffer
+ * @param[in] out_size Size of the output buffer, typically the link MTU
+ * @param[out] sample_count Number of samples in the report
+ *
+ * @returns Report size in bytes, 0 if nothing fits
+ ******************************************************************************/
+size_t app_report_build(uint8_t *out, size_t out_size, size_t *sample_count);
+
+/*******************************************************************************
+ * Function to remove reported samples
+ *
+ * @param[in] sample_count Number of samples to remove, oldest first
+ ******************************************************************************/
+void app_report_consume(size_t sample_count);
+
+/*******************************************************************************
+ * Function to remove the samples too old to be worth reporting
+ *
+ * @param[in] now_ms Current time, same base as the sample timestamps
+ * @param[in] max_age_ms Age above which a sample is removed
+ *
+ * @returns Number of samples removed
+ ******************************************************************************/
+size_t app_report_expire(uint32_t now_ms, uint32_t max_age_ms);
+
+/*******************************************************************************
+ * Function to get the number of samples dropped because the batch was full
+ *
+ * @returns Number of dropped samples
+ ******************************************************************************/
+uint32_t app_report_get_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_REPORT_H
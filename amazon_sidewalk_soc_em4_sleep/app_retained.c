@@ -0,0 +1,124 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_retained.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include "em_device.h"
+#include "em_cmu.h"
+#include "em_rmu.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "app_retained.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Marks the retained words as valid, change it when the slot layout changes
+#define RETAINED_MAGIC          (0x5D3E400CUL)
+
+#define RETAINED_WORD_COUNT     (sizeof(((BURAM_TypeDef *)0)->RET) / sizeof(((BURAM_TypeDef *)0)->RET[0]))
+
+_Static_assert(APP_RETAINED_SLOT_COUNT <= RETAINED_WORD_COUNT, "too many retained slots");
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Global Variables
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+static uint32_t reset_cause;
+// Device time at the start of this boot
+static uint32_t time_base_ms;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+void app_retained_init(uint32_t slept_ms)
+{
+#if defined(_CMU_CLKEN1_BURAM_MASK)
+  CMU_ClockEnable(cmuClock_BURAM, true);
+#endif
+
+  reset_cause = RMU_ResetCauseGet();
+  RMU_ResetCauseClear();
+
+  if ((reset_cause & (EMU_RSTCAUSE_POR | EMU_RSTCAUSE_DVDDBOD
+                      | EMU_RSTCAUSE_AVDDBOD | EMU_RSTCAUSE_DECBOD)) != 0
+      || BURAM->RET[APP_RETAINED_SLOT_MAGIC].REG != RETAINED_MAGIC) {
+    for (uint32_t i = 0; i < APP_RETAINED_SLOT_COUNT; i++) {
+      BURAM->RET[i].REG = 0;
+    }
+    BURAM->RET[APP_RETAINED_SLOT_MAGIC].REG = RETAINED_MAGIC;
+  }
+
+  time_base_ms = BURAM->RET[APP_RETAINED_SLOT_UPTIME_MS].REG;
+  if (app_retained_is_em4_wake()) {
+    time_base_ms += slept_ms;
+  }
+}
+
+uint32_t app_retained_get(app_retained_slot_t slot)
+{
+  return BURAM->RET[slot].REG;
+}
+
+void app_retained_set(app_retained_slot_t slot, uint32_t value)
+{
+  BURAM->RET[slot].REG = value;
+}
+
+uint32_t app_retained_get_reset_cause(void)
+{
+  return reset_cause;
+}
+
+bool app_retained_is_em4_wake(void)
+{
+  return (reset_cause & EMU_RSTCAUSE_EM4) != 0;
+}
+
+uint32_t app_retained_now_ms(void)
+{
+  TickType_t ticks = xPortIsInsideInterrupt() ? xTaskGetTickCountFromISR() : xTaskGetTickCount();
+  return time_base_ms + ((uint32_t)ticks * portTICK_PERIOD_MS);
+}
+
+void app_retained_save_time(void)
+{
+  BURAM->RET[APP_RETAINED_SLOT_UPTIME_MS].REG = app_retained_now_ms();
+}
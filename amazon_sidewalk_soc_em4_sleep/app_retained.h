@@ -0,0 +1,141 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_retained.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef APP_RETAINED_H
+#define APP_RETAINED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Backup RAM words kept across EM4 and resets, lost on power-on and brown-out
+typedef enum {
+  APP_RETAINED_SLOT_MAGIC = 0,
+  APP_RETAINED_SLOT_UPTIME_MS,        // Device time when the last boot slept or reset
+  APP_RETAINED_SLOT_TRACE_SEQ,        // Sequence number of the next trace chunk
+  APP_RETAINED_SLOT_WAKE_COUNT,       // Boots since the last power-on
+  APP_RETAINED_SLOT_LAST_ERROR,       // Last sid_error_t seen
+  APP_RETAINED_SLOT_AIRTIME_FSK_US,   // Airtime used on FSK, not yet refilled
+  APP_RETAINED_SLOT_AIRTIME_CSS_US,   // Airtime used on CSS, not yet refilled
+  APP_RETAINED_SLOT_AIRTIME_TIME_MS,  // Device time of the last airtime refill
+  APP_RETAINED_SLOT_SCHEDULE_DUE_MS,  // Device time the scheduled uplink is due
+  APP_RETAINED_SLOT_SCHEDULE_INDEX,   // Period index of the due slot plus one, 0: unset
+  APP_RETAINED_SLOT_SCHEDULE_MISSED,  // Scheduled periods skipped
+  APP_RETAINED_SLOT_RENDEZVOUS_MS,    // Device time of the promised receive window, 0: none
+  APP_RETAINED_SLOT_RADIO_SLEEP_DEPTH, // Depth the radio was put in before EM4
+  APP_RETAINED_SLOT_RADIO_REINIT_WARM, // Mean radio re-init time after a warm sleep, 1/16 ms
+  APP_RETAINED_SLOT_RADIO_REINIT_COLD, // Mean radio re-init time after a cold sleep, 1/16 ms
+  APP_RETAINED_SLOT_EM4_HOOKS_RUN,    // Suspend hooks run on the last EM4 entry
+  APP_RETAINED_SLOT_EM4_HOOKS_TOTAL_US, // Time of the last EM4 entry in us
+  APP_RETAINED_SLOT_EM4_HOOKS_US,     // Time of each suspend hook in us, two per word
+  APP_RETAINED_SLOT_EM4_HOOKS_US_LAST = APP_RETAINED_SLOT_EM4_HOOKS_US + 3,
+  APP_RETAINED_SLOT_TX_POWER_STATE,   // TX power backoff of each link, see app_tx_power.c
+  APP_RETAINED_SLOT_ACK_POLICY,       // Delivery history of each link, see app_ack_policy.c
+  APP_RETAINED_SLOT_ACK_POLICY_LAST = APP_RETAINED_SLOT_ACK_POLICY + 2,
+  APP_RETAINED_SLOT_SUPERVISOR_STATE, // Stack failures in a row and restarts, see app_supervisor.c
+  APP_RETAINED_SLOT_SUPERVISOR_FAILING_MS, // Device time of the first failure, 0: stack running
+  APP_RETAINED_SLOT_SUPERVISOR_RECOVERY, // Recoveries and the longest one
+  APP_RETAINED_SLOT_SUPERVISOR_RECOVERY_SUM_MS, // Failure to ready time summed over the recoveries
+  APP_RETAINED_SLOT_BATTERY,          // Battery tier and the lowest supply, see app_battery.c
+  APP_RETAINED_SLOT_EM4_CLOCK,        // Calibration of the EM4 clock, see em4_clock.c
+  APP_RETAINED_SLOT_COUNT
+} app_retained_slot_t;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to validate the retained words at boot
+ *
+ * The words are cleared after a power-on or when their content is not valid,
+ * the device time is advanced by the time spent in EM4.
+ *
+ * @param[in] slept_ms Time spent in EM4 before this boot
+ ******************************************************************************/
+void app_retained_init(uint32_t slept_ms);
+
+/*******************************************************************************
+ * Function to read a retained word
+ *
+ * @param[in] slot Retained word
+ *
+ * @returns Value of the word
+ ******************************************************************************/
+uint32_t app_retained_get(app_retained_slot_t slot);
+
+/*******************************************************************************
+ * Function to write a retained word
+ *
+ * @param[in] slot Retained word
+ * @param[in] value Value to store
+ ******************************************************************************/
+void app_retained_set(app_retained_slot_t slot, uint32_t value);
+
+/*******************************************************************************
+ * Function to get the reset cause of this boot
+ *
+ * @returns EMU_RSTCAUSE_x flags
+ ******************************************************************************/
+uint32_t app_retained_get_reset_cause(void);
+
+/*******************************************************************************
+ * Function to check if this boot is a wake-up from EM4
+ *
+ * @returns #true on EM4 wake-up
+ ******************************************************************************/
+bool app_retained_is_em4_wake(void);
+
+/*******************************************************************************
+ * Function to get the device time, continuous across EM4 and resets
+ *
+ * @returns Device time in ms
+ ******************************************************************************/
+uint32_t app_retained_now_ms(void);
+
+/*******************************************************************************
+ * Function to save the device time right before sleeping or resetting
+ ******************************************************************************/
+void app_retained_save_time(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_RETAINED_H
@@ -0,0 +1,113 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_sample_ring.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdatomic.h>
+
+#include "app_sample_ring.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+#define RING_MASK                   (APP_SAMPLE_RING_SIZE - 1U)
+
+_Static_assert((APP_SAMPLE_RING_SIZE & RING_MASK) == 0U, "APP_SAMPLE_RING_SIZE must be a power of two");
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Global Variables
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+static app_sample_t ring[APP_SAMPLE_RING_SIZE];
+// Free running indexes, head written by the producer only, tail by the consumer only
+static atomic_uint_fast32_t head;
+static atomic_uint_fast32_t tail;
+// Written by the producer only
+static atomic_uint_fast32_t overflows;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+bool app_sample_ring_push(const app_sample_t *sample)
+{
+  uint32_t h = (uint32_t)atomic_load_explicit(&head, memory_order_relaxed);
+  // Acquire: the consumer is done reading the slot it released
+  uint32_t t = (uint32_t)atomic_load_explicit(&tail, memory_order_acquire);
+
+  if ((uint32_t)(h - t) >= APP_SAMPLE_RING_SIZE) {
+    atomic_store_explicit(&overflows,
+                          atomic_load_explicit(&overflows, memory_order_relaxed) + 1U,
+                          memory_order_relaxed);
+    return false;
+  }
+
+  ring[h & RING_MASK] = *sample;
+  // Release: the slot is written before the consumer sees it
+  atomic_store_explicit(&head, h + 1U, memory_order_release);
+  return true;
+}
+
+size_t app_sample_ring_pop(app_sample_t *out, size_t max)
+{
+  uint32_t t = (uint32_t)atomic_load_explicit(&tail, memory_order_relaxed);
+  uint32_t h = (uint32_t)atomic_load_explicit(&head, memory_order_acquire);
+  size_t count = (size_t)(uint32_t)(h - t);
+
+  if (count > max) {
+    count = max;
+  }
+  for (size_t i = 0; i < count; i++) {
+    out[i] = ring[(t + (uint32_t)i) & RING_MASK];
+  }
+  atomic_store_explicit(&tail, t + (uint32_t)count, memory_order_release);
+  return count;
+}
+
+size_t app_sample_ring_count(void)
+{
+  uint32_t h = (uint32_t)atomic_load_explicit(&head, memory_order_acquire);
+  uint32_t t = (uint32_t)atomic_load_explicit(&tail, memory_order_relaxed);
+  return (size_t)(uint32_t)(h - t);
+}
+
+uint32_t app_sample_ring_get_overflows(void)
+{
+  return (uint32_t)atomic_load_explicit(&overflows, memory_order_relaxed);
+}
@@ -0,0 +1,107 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_sample_ring.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef APP_SAMPLE_RING_H
+#define APP_SAMPLE_RING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Samples held between the producer and the main task, power of two
+#define APP_SAMPLE_RING_SIZE        (64U)
+
+// Sample types, products add their sensors here
+typedef enum {
+  APP_SAMPLE_COUNTER = 0,
+  APP_SAMPLE_TYPE_COUNT
+} app_sample_type_t;
+
+typedef struct {
+  uint32_t timestamp;         // Device time in ms, see app_retained_now_ms()
+  int32_t value;
+  uint8_t type;               // app_sample_type_t
+} app_sample_t;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to add a sample, producer side
+ *
+ * Lock free, callable from an ISR or a timer callback. A single context may
+ * produce: samples from several ISRs must not interleave on the same ring.
+ *
+ * @param[in] sample Sample, copied
+ *
+ * @returns #false if the ring is full, the sample is dropped and counted
+ ******************************************************************************/
+bool app_sample_ring_push(const app_sample_t *sample);
+
+/*******************************************************************************
+ * Function to take the oldest samples, consumer side
+ *
+ * @param[out] out Samples
+ * @param[in] max Capacity of out
+ *
+ * @returns Number of samples taken
+ ******************************************************************************/
+size_t app_sample_ring_pop(app_sample_t *out, size_t max);
+
+/*******************************************************************************
+ * Function to get the number of samples waiting in the ring
+ *
+ * @returns Number of samples
+ ******************************************************************************/
+size_t app_sample_ring_count(void);
+
+/*******************************************************************************
+ * Function to get the number of samples dropped because the ring was full
+ *
+ * @returns Number of dropped samples
+ ******************************************************************************/
+uint32_t app_sample_ring_get_overflows(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_SAMPLE_RING_H
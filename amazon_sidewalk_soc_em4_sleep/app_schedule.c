@@ -0,0 +1,191 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_schedule.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include "app_schedule.h"
+#include "app_retained.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+#define FNV_OFFSET_BASIS        (2166136261UL)
+#define FNV_PRIME               (16777619UL)
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to get the jitter of a period, the same for a device and a period
+ *
+ * @param[in] index Period index
+ *
+ * @returns Jitter in ms
+ ******************************************************************************/
+static uint32_t jitter_ms(uint32_t index);
+
+/*******************************************************************************
+ * Function to store the next due time
+ *
+ * @param[in] nominal_ms Device time of the slot, before jitter
+ * @param[in] index Period index of the slot
+ ******************************************************************************/
+static void set_due(uint32_t nominal_ms, uint32_t index);
+
+// -----------------------------------------------------------------------------
+//                                Global Variables
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+static uint32_t schedule_seed;
+static uint32_t slot_ms;
+static uint32_t stride = 1U;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+void app_schedule_init(uint32_t seed)
+{
+  schedule_seed = seed;
+#if APP_SCHEDULE_PERIOD_MS != 0
+  slot_ms = seed % APP_SCHEDULE_PERIOD_MS;
+
+  // Index is stored plus one, zeroed retained words after a power-on mean unset
+  if (app_retained_get(APP_RETAINED_SLOT_SCHEDULE_INDEX) == 0) {
+    set_due(app_retained_now_ms() + slot_ms, 0);
+  }
+#endif
+}
+
+uint32_t app_schedule_seed(const char *id)
+{
+  uint32_t hash = FNV_OFFSET_BASIS;
+
+  while (*id != '\0') {
+    hash ^= (uint8_t)*id++;
+    hash *= FNV_PRIME;
+  }
+  return hash;
+}
+
+uint32_t app_schedule_ms_until_due(void)
+{
+#if APP_SCHEDULE_PERIOD_MS != 0
+  int32_t left = (int32_t)(app_retained_get(APP_RETAINED_SLOT_SCHEDULE_DUE_MS) - app_retained_now_ms());
+  return (left > 0) ? (uint32_t)left : 0U;
+#else
+  return UINT32_MAX;
+#endif
+}
+
+void app_schedule_advance(bool time_valid, uint32_t gps_s)
+{
+#if APP_SCHEDULE_PERIOD_MS != 0
+  uint32_t now_ms = app_retained_now_ms();
+  uint32_t index = app_retained_get(APP_RETAINED_SLOT_SCHEDULE_INDEX) - 1U;
+  uint32_t nominal_ms = app_retained_get(APP_RETAINED_SLOT_SCHEDULE_DUE_MS) - jitter_ms(index);
+
+  if (time_valid) {
+    // First slot strictly after now on the GPS grid, mapped to device time
+    uint64_t gps_ms = (uint64_t)gps_s * 1000U;
+    uint64_t next = ((gps_ms + APP_SCHEDULE_PERIOD_MS - slot_ms) / APP_SCHEDULE_PERIOD_MS);
+    uint64_t slot_gps_ms = (next * APP_SCHEDULE_PERIOD_MS) + slot_ms;
+    index = (uint32_t)next;
+    nominal_ms = now_ms + (uint32_t)(slot_gps_ms - gps_ms);
+  } else {
+    index++;
+    nominal_ms += APP_SCHEDULE_PERIOD_MS;
+  }
+
+  // Periods the device slept or failed through are not caught up
+  while ((int32_t)(nominal_ms + jitter_ms(index) - now_ms) <= 0) {
+    index++;
+    nominal_ms += APP_SCHEDULE_PERIOD_MS;
+    app_retained_set(APP_RETAINED_SLOT_SCHEDULE_MISSED, app_retained_get(APP_RETAINED_SLOT_SCHEDULE_MISSED) + 1U);
+  }
+  // Periods left out on purpose, on the GPS grid the devices of a tier keep
+  // the same periods
+  while ((index % stride) != 0) {
+    index++;
+    nominal_ms += APP_SCHEDULE_PERIOD_MS;
+  }
+  set_due(nominal_ms, index);
+#else
+  (void)time_valid;
+  (void)gps_s;
+#endif
+}
+
+void app_schedule_set_stride(uint32_t periods)
+{
+  stride = (periods != 0) ? periods : 1U;
+}
+
+uint32_t app_schedule_get_slot_ms(void)
+{
+  return slot_ms;
+}
+
+uint32_t app_schedule_get_missed(void)
+{
+  return app_retained_get(APP_RETAINED_SLOT_SCHEDULE_MISSED);
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+static uint32_t jitter_ms(uint32_t index)
+{
+#if APP_SCHEDULE_JITTER_MS != 0
+  // Murmur3 finalizer, decorrelates consecutive periods and devices
+  uint32_t h = schedule_seed ^ (index * 0x9E3779B9UL);
+  h ^= h >> 16;
+  h *= 0x85EBCA6BUL;
+  h ^= h >> 13;
+  h *= 0xC2B2AE35UL;
+  h ^= h >> 16;
+  return h % (APP_SCHEDULE_JITTER_MS + 1U);
+#else
+  (void)index;
+  return 0;
+#endif
+}
+
+static void set_due(uint32_t nominal_ms, uint32_t index)
+{
+  app_retained_set(APP_RETAINED_SLOT_SCHEDULE_DUE_MS, nominal_ms + jitter_ms(index));
+  app_retained_set(APP_RETAINED_SLOT_SCHEDULE_INDEX, index + 1U);
+}
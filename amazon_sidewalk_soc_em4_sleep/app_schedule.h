@@ -0,0 +1,127 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_schedule.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef APP_SCHEDULE_H
+#define APP_SCHEDULE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Period of the scheduled uplink, 0 disables the scheduler
+#define APP_SCHEDULE_PERIOD_MS      (15UL * 60UL * 1000UL)
+// Random delay added to each slot, drawn again every period
+#define APP_SCHEDULE_JITTER_MS      (30UL * 1000UL)
+
+_Static_assert(APP_SCHEDULE_JITTER_MS < APP_SCHEDULE_PERIOD_MS || APP_SCHEDULE_PERIOD_MS == 0,
+               "jitter must stay within the period");
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to restore the schedule at boot, after app_retained_init()
+ *
+ * The slot of the device within the period is derived from the seed, devices
+ * with different seeds spread evenly over the period.
+ *
+ * @param[in] seed Device specific value, see app_schedule_seed()
+ ******************************************************************************/
+void app_schedule_init(uint32_t seed);
+
+/*******************************************************************************
+ * Function to derive the schedule seed from a device identifier
+ *
+ * @param[in] id Identifier string, typically the SMSN
+ *
+ * @returns Seed
+ ******************************************************************************/
+uint32_t app_schedule_seed(const char *id);
+
+/*******************************************************************************
+ * Function to get the time left before the scheduled uplink
+ *
+ * @returns Time in ms, 0 if due or overdue, UINT32_MAX if disabled
+ ******************************************************************************/
+uint32_t app_schedule_ms_until_due(void);
+
+/*******************************************************************************
+ * Function to move to the next period once the scheduled uplink is sent
+ *
+ * With network time the next slot is aligned on GPS time, so every device
+ * keeps its place in the period whatever its boot time. Without it the
+ * period runs on the device time.
+ *
+ * @param[in] time_valid #true if gps_s holds the network time
+ * @param[in] gps_s GPS time in s
+ ******************************************************************************/
+void app_schedule_advance(bool time_valid, uint32_t gps_s);
+
+/*******************************************************************************
+ * Function to send the scheduled uplink once every few periods only
+ *
+ * The uplink keeps its slot, periods whose index is not a multiple of
+ * periods are skipped without counting as missed. Applies from the next
+ * app_schedule_advance().
+ *
+ * @param[in] periods Periods between two uplinks, 1 for every period
+ ******************************************************************************/
+void app_schedule_set_stride(uint32_t periods);
+
+/*******************************************************************************
+ * Function to get the slot of the device within the period
+ *
+ * @returns Slot offset in ms
+ ******************************************************************************/
+uint32_t app_schedule_get_slot_ms(void);
+
+/*******************************************************************************
+ * Function to get the number of periods skipped because the device was not
+ * able to send in time, since the last power-on
+ *
+ * @returns Number of skipped periods
+ ******************************************************************************/
+uint32_t app_schedule_get_missed(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_SCHEDULE_H
@@ -0,0 +1,285 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_segment.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <string.h>
+
+#include "app_segment.h"
+#include "sl_sidewalk_log_app.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Outbound segmented message
+typedef struct {
+  uint8_t payload[APP_SEGMENT_MAX_PAYLOAD];
+  size_t size;
+  size_t offset;
+  size_t fragment_size;
+  uint8_t seq;
+  uint8_t index;
+  uint8_t in_flight_count;
+  uint16_t in_flight[APP_SEGMENT_MAX_IN_FLIGHT];
+  struct sid_msg_desc desc;
+  bool active;
+} segment_tx_t;
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to put fragments until the window is full or the stack pushes back
+ *
+ * @param[in] handle Sidewalk handle
+ *
+ * @returns #SID_ERROR_NONE on success or backpressure, error otherwise
+ ******************************************************************************/
+static sid_error_t push_fragments(struct sid_handle *handle);
+
+/*******************************************************************************
+ * Function to release an in flight fragment
+ *
+ * @param[in] id Message id of the fragment
+ *
+ * @returns #true if the id belonged to a fragment
+ ******************************************************************************/
+static bool release_fragment(uint16_t id);
+
+/*******************************************************************************
+ * Function to check if an error means the stack queue is full
+ *
+ * @param[in] error The error type
+ *
+ * @returns #true on backpressure
+ ******************************************************************************/
+static bool is_backpressure(sid_error_t error);
+
+// -----------------------------------------------------------------------------
+//                                Global Variables
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+static segment_tx_t tx;
+static uint8_t next_seq;
+static app_segment_stats_t stats;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+sid_error_t app_segment_send(struct sid_handle *handle,
+                             const void *data,
+                             size_t size,
+                             struct sid_msg_desc *desc)
+{
+  size_t mtu = 0;
+  sid_error_t ret = sid_get_mtu(handle, desc->link_type, &mtu);
+  if (ret != SID_ERROR_NONE) {
+    return ret;
+  }
+
+  const uint8_t *bytes = (const uint8_t *)data;
+  if (size != 0 && (bytes[0] & APP_SEGMENT_HEADER_MARKER) != 0) {
+    // The cloud would take it for a fragment, the producer breaks the layout
+    SL_SID_LOG_APP_ERROR("payload starts with reserved bit 7 set: %02x", (unsigned int)bytes[0]);
+    return SID_ERROR_INVALID_ARGS;
+  }
+  if (size <= mtu) {
+    struct sid_msg msg = {
+      .data = (void *)data,
+      .size = size,
+    };
+    ret = sid_put_msg(handle, &msg, desc);
+    if (ret == SID_ERROR_NONE) {
+      stats.unsegmented++;
+    }
+    return ret;
+  }
+
+  if (tx.active) {
+    return SID_ERROR_BUSY;
+  }
+  if (mtu <= APP_SEGMENT_HEADER_SIZE
+      || size > APP_SEGMENT_MAX_PAYLOAD
+      || size > APP_SEGMENT_MAX_FRAGMENTS * (mtu - APP_SEGMENT_HEADER_SIZE)) {
+    SL_SID_LOG_APP_ERROR("payload too large for segmentation, size: %u, mtu: %u", (unsigned int)size, (unsigned int)mtu);
+    return SID_ERROR_OUT_OF_RESOURCES;
+  }
+
+  memcpy(tx.payload, data, size);
+  tx.size = size;
+  tx.offset = 0;
+  tx.fragment_size = mtu - APP_SEGMENT_HEADER_SIZE;
+  tx.seq = next_seq;
+  tx.index = 0;
+  tx.in_flight_count = 0;
+  tx.desc = *desc;
+  tx.active = true;
+  next_seq = (next_seq + 1U) & APP_SEGMENT_HEADER_SEQ_MASK;
+  stats.messages++;
+
+  SL_SID_LOG_APP_INFO("segmenting message, size: %u, mtu: %u, fragments: %u",
+                      (unsigned int)size,
+                      (unsigned int)mtu,
+                      (unsigned int)((size + tx.fragment_size - 1U) / tx.fragment_size));
+
+  ret = push_fragments(handle);
+  if (ret != SID_ERROR_NONE) {
+    tx.active = false;
+    stats.aborted++;
+  }
+  return ret;
+}
+
+void app_segment_resume(struct sid_handle *handle)
+{
+  if (!tx.active || tx.offset >= tx.size) {
+    return;
+  }
+
+  sid_error_t ret = push_fragments(handle);
+  if (ret != SID_ERROR_NONE) {
+    SL_SID_LOG_APP_ERROR("fragment send failed, seq: %u, error: %d", tx.seq, (int)ret);
+    tx.active = false;
+    stats.aborted++;
+  }
+}
+
+void app_segment_on_msg_sent(const struct sid_msg_desc *msg_desc)
+{
+  if (release_fragment(msg_desc->id) && tx.offset >= tx.size && tx.in_flight_count == 0) {
+    SL_SID_LOG_APP_INFO("segmented message sent, seq: %u", tx.seq);
+    tx.active = false;
+  }
+}
+
+void app_segment_on_send_error(sid_error_t error, const struct sid_msg_desc *msg_desc)
+{
+  if (release_fragment(msg_desc->id)) {
+    // The cloud cannot rebuild the message without this fragment
+    SL_SID_LOG_APP_ERROR("segmented message aborted, seq: %u, error: %d", tx.seq, (int)error);
+    tx.active = false;
+    stats.aborted++;
+  }
+}
+
+void app_segment_reset(void)
+{
+  if (!tx.active) {
+    return;
+  }
+  SL_SID_LOG_APP_WARNING("segmented message aborted by a stack stop, seq: %u", tx.seq);
+  tx.active = false;
+  tx.in_flight_count = 0;
+  stats.aborted++;
+}
+
+bool app_segment_is_busy(void)
+{
+  return tx.active;
+}
+
+const app_segment_stats_t *app_segment_get_stats(void)
+{
+  return &stats;
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+static sid_error_t push_fragments(struct sid_handle *handle)
+{
+  uint8_t fragment[APP_SEGMENT_HEADER_SIZE + APP_SEGMENT_MAX_PAYLOAD];
+
+  while (tx.offset < tx.size && tx.in_flight_count < APP_SEGMENT_MAX_IN_FLIGHT) {
+    size_t chunk = tx.size - tx.offset;
+    if (chunk > tx.fragment_size) {
+      chunk = tx.fragment_size;
+    }
+    bool last = (tx.offset + chunk) >= tx.size;
+
+    fragment[0] = (uint8_t)(APP_SEGMENT_HEADER_MARKER
+                            | (tx.seq << APP_SEGMENT_HEADER_SEQ_SHIFT)
+                            | (last ? APP_SEGMENT_HEADER_LAST : 0U)
+                            | (tx.index & APP_SEGMENT_HEADER_INDEX_MASK));
+    memcpy(&fragment[APP_SEGMENT_HEADER_SIZE], &tx.payload[tx.offset], chunk);
+
+    struct sid_msg msg = {
+      .data = fragment,
+      .size = APP_SEGMENT_HEADER_SIZE + chunk,
+    };
+    struct sid_msg_desc desc = tx.desc;
+
+    sid_error_t ret = sid_put_msg(handle, &msg, &desc);
+    if (is_backpressure(ret)) {
+      // Retried from app_segment_resume() once the stack released a message
+      stats.backpressure++;
+      return SID_ERROR_NONE;
+    } else if (ret != SID_ERROR_NONE) {
+      return ret;
+    }
+
+    tx.in_flight[tx.in_flight_count++] = desc.id;
+    tx.offset += chunk;
+    tx.index++;
+    stats.fragments++;
+  }
+
+  return SID_ERROR_NONE;
+}
+
+static bool release_fragment(uint16_t id)
+{
+  if (!tx.active) {
+    return false;
+  }
+
+  for (uint8_t i = 0; i < tx.in_flight_count; i++) {
+    if (tx.in_flight[i] == id) {
+      tx.in_flight[i] = tx.in_flight[--tx.in_flight_count];
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static bool is_backpressure(sid_error_t error)
+{
+  return error == SID_ERROR_OUT_OF_RESOURCES
+         || error == SID_ERROR_TRY_AGAIN
+         || error == SID_ERROR_BUSY;
+}
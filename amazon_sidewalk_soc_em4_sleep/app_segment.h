@@ -0,0 +1,157 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_segment.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef APP_SEGMENT_H
+#define APP_SEGMENT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "sid_api.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Largest payload the segmentation layer accepts
+#define APP_SEGMENT_MAX_PAYLOAD         (256U)
+// Fragments handed to the stack before waiting for a sent/error callback
+#define APP_SEGMENT_MAX_IN_FLIGHT       (2U)
+
+// Bit 7 of the first byte of every application payload is reserved: producers
+// start their payloads with a byte below 0x80, so a frame starting with a byte
+// at or above it is always a fragment. app_segment_send() rejects payloads that
+// break this rule rather than spend an extra frame on them.
+//
+// Fragment header, one byte:
+//   bit 7      always set
+//   bits 6..5  message sequence number
+//   bit 4      last fragment of the message
+//   bits 3..0  fragment index
+#define APP_SEGMENT_HEADER_SIZE         (1U)
+#define APP_SEGMENT_HEADER_MARKER       (0x80U)
+#define APP_SEGMENT_HEADER_SEQ_SHIFT    (5U)
+#define APP_SEGMENT_HEADER_SEQ_MASK     (0x03U)
+#define APP_SEGMENT_HEADER_LAST         (0x10U)
+#define APP_SEGMENT_HEADER_INDEX_MASK   (0x0FU)
+#define APP_SEGMENT_MAX_FRAGMENTS       (APP_SEGMENT_HEADER_INDEX_MASK + 1U)
+
+// Segmentation counters
+typedef struct {
+  uint32_t messages;        // Messages sent in fragments
+  uint32_t unsegmented;     // Messages that fit the MTU and went out as is
+  uint32_t fragments;       // Fragments accepted by the stack
+  uint32_t backpressure;    // Times the stack refused a fragment for lack of resources
+  uint32_t aborted;         // Messages dropped after a fragment failed
+} app_segment_stats_t;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to send a payload of any size up to APP_SEGMENT_MAX_PAYLOAD
+ *
+ * Payloads that fit the MTU of the link in the descriptor are put as is in a
+ * single frame, larger ones are copied and sent as a sequence of fragments
+ * paced against the stack queue. The descriptor must name a single link.
+ *
+ * @param[in] handle Sidewalk handle
+ * @param[in] data Payload
+ * @param[in] size Payload size
+ * @param[in,out] desc Message descriptor, its id is updated for unsegmented
+ *                     payloads
+ *
+ * @returns #SID_ERROR_NONE            payload sent or first fragments queued
+ * @returns #SID_ERROR_BUSY            a segmented message is still in progress
+ * @returns #SID_ERROR_INVALID_ARGS    first byte at or above 0x80, see
+ *                                     APP_SEGMENT_HEADER_MARKER
+ * @returns #SID_ERROR_OUT_OF_RESOURCES payload too large for the link
+ * @returns error of sid_put_msg()     otherwise
+ ******************************************************************************/
+sid_error_t app_segment_send(struct sid_handle *handle,
+                             const void *data,
+                             size_t size,
+                             struct sid_msg_desc *desc);
+
+/*******************************************************************************
+ * Function to push pending fragments, to be called after sid_process()
+ *
+ * @param[in] handle Sidewalk handle
+ ******************************************************************************/
+void app_segment_resume(struct sid_handle *handle);
+
+/*******************************************************************************
+ * Function to notify the layer that a message was sent
+ *
+ * @param[in] msg_desc Descriptor of the sent message
+ ******************************************************************************/
+void app_segment_on_msg_sent(const struct sid_msg_desc *msg_desc);
+
+/*******************************************************************************
+ * Function to notify the layer that a message could not be sent
+ *
+ * @param[in] error The error type
+ * @param[in] msg_desc Descriptor of the failed message
+ ******************************************************************************/
+void app_segment_on_send_error(sid_error_t error, const struct sid_msg_desc *msg_desc);
+
+/*******************************************************************************
+ * Function to abort the segmented message in progress, to be called whenever
+ * the stack is de-initialized: its fragments get no sent or error callback
+ ******************************************************************************/
+void app_segment_reset(void);
+
+/*******************************************************************************
+ * Function to check if a segmented message is in progress
+ *
+ * @returns #true if fragments are pending or in flight
+ ******************************************************************************/
+bool app_segment_is_busy(void);
+
+/*******************************************************************************
+ * Function to get the segmentation counters
+ *
+ * @returns Pointer to the counters
+ ******************************************************************************/
+const app_segment_stats_t *app_segment_get_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_SEGMENT_H
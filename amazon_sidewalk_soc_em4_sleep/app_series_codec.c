@@ -0,0 +1,293 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_series_codec.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include "app_series_codec.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Output cursor, overflow is sticky so callers check once at the end
+typedef struct {
+  uint8_t *data;
+  size_t size;
+  size_t pos;
+  bool overflow;
+} writer_t;
+
+// Token stream with a pending run of zeros
+typedef struct {
+  writer_t *writer;
+  uint32_t zero_run;
+} token_writer_t;
+
+// Input cursor with the zero run still to be returned
+typedef struct {
+  const uint8_t *data;
+  size_t size;
+  size_t pos;
+  uint32_t zero_run;
+} reader_t;
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+static size_t encode_block(const app_series_sample_t *samples, size_t count, uint8_t *out, size_t out_size);
+static void put_varint(writer_t *writer, uint64_t value);
+static void put_token(token_writer_t *tokens, int32_t value);
+static void flush_tokens(token_writer_t *tokens);
+static bool get_varint(reader_t *reader, uint64_t *value);
+static bool get_token(reader_t *reader, int32_t *value);
+static uint32_t zigzag_encode(int32_t value);
+static int32_t zigzag_decode(uint32_t value);
+
+// -----------------------------------------------------------------------------
+//                                Global Variables
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+size_t app_series_encode(const app_series_sample_t *samples,
+                         size_t count,
+                         uint8_t *out,
+                         size_t out_size,
+                         size_t *encoded_count)
+{
+  size_t written = encode_block(samples, count, out, out_size);
+
+  if (written == 0 && count > 1) {
+    // Largest prefix that fits, the encoded size grows with the sample count
+    size_t low = 0;
+    size_t high = count - 1;
+    while (low < high) {
+      size_t mid = (low + high + 1) / 2;
+      if (encode_block(samples, mid, out, out_size) != 0) {
+        low = mid;
+      } else {
+        high = mid - 1;
+      }
+    }
+    count = low;
+    written = (count != 0) ? encode_block(samples, count, out, out_size) : 0;
+  }
+
+  *encoded_count = (written != 0) ? count : 0;
+  return written;
+}
+
+bool app_series_decode(const uint8_t *in,
+                       size_t in_size,
+                       app_series_sample_t *samples,
+                       size_t max_count,
+                       size_t *count)
+{
+  reader_t reader = { .data = in, .size = in_size, .pos = 0, .zero_run = 0 };
+  uint64_t raw;
+
+  *count = 0;
+  if (in_size == 0 || in[0] != APP_SERIES_CODEC_TYPE) {
+    return false;
+  }
+  reader.pos = 1;
+
+  if (!get_varint(&reader, &raw) || raw > max_count) {
+    return false;
+  }
+  size_t n = (size_t)raw;
+  if (n == 0) {
+    return true;
+  }
+
+  if (!get_varint(&reader, &raw)) {
+    return false;
+  }
+  samples[0].timestamp = (uint32_t)raw;
+  if (!get_varint(&reader, &raw)) {
+    return false;
+  }
+  samples[0].value = zigzag_decode((uint32_t)raw);
+
+  uint32_t delta = 0;
+  for (size_t i = 1; i < n; i++) {
+    int32_t token;
+    if (!get_token(&reader, &token)) {
+      return false;
+    }
+    delta = (i == 1) ? (uint32_t)token : delta + (uint32_t)token;
+    samples[i].timestamp = samples[i - 1].timestamp + delta;
+  }
+  if (reader.zero_run != 0) {
+    return false;
+  }
+
+  for (size_t i = 1; i < n; i++) {
+    int32_t token;
+    if (!get_token(&reader, &token)) {
+      return false;
+    }
+    samples[i].value = (int32_t)((uint32_t)samples[i - 1].value + (uint32_t)token);
+  }
+  if (reader.zero_run != 0) {
+    return false;
+  }
+
+  *count = n;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+static size_t encode_block(const app_series_sample_t *samples, size_t count, uint8_t *out, size_t out_size)
+{
+  writer_t writer = { .data = out, .size = out_size, .pos = 0, .overflow = false };
+  token_writer_t tokens = { .writer = &writer, .zero_run = 0 };
+
+  if (count == 0) {
+    return 0;
+  }
+
+  put_varint(&writer, APP_SERIES_CODEC_TYPE);
+  put_varint(&writer, count);
+  put_varint(&writer, samples[0].timestamp);
+  put_varint(&writer, zigzag_encode(samples[0].value));
+
+  // Timestamps: first delta, then delta-of-deltas, wrapping arithmetic
+  uint32_t previous_delta = 0;
+  for (size_t i = 1; i < count; i++) {
+    uint32_t delta = samples[i].timestamp - samples[i - 1].timestamp;
+    put_token(&tokens, (int32_t)((i == 1) ? delta : delta - previous_delta));
+    previous_delta = delta;
+  }
+  flush_tokens(&tokens);
+
+  // Values: deltas, runs of repeated values collapse into one token
+  for (size_t i = 1; i < count; i++) {
+    put_token(&tokens, (int32_t)((uint32_t)samples[i].value - (uint32_t)samples[i - 1].value));
+  }
+  flush_tokens(&tokens);
+
+  return writer.overflow ? 0 : writer.pos;
+}
+
+static void put_varint(writer_t *writer, uint64_t value)
+{
+  do {
+    uint8_t byte = (uint8_t)(value & 0x7FU);
+    value >>= 7;
+    if (value != 0) {
+      byte |= 0x80U;
+    }
+    if (writer->pos >= writer->size) {
+      writer->overflow = true;
+      return;
+    }
+    writer->data[writer->pos++] = byte;
+  } while (value != 0);
+}
+
+static void put_token(token_writer_t *tokens, int32_t value)
+{
+  if (value == 0) {
+    tokens->zero_run++;
+    return;
+  }
+  flush_tokens(tokens);
+  put_varint(tokens->writer, (uint64_t)zigzag_encode(value) << 1);
+}
+
+static void flush_tokens(token_writer_t *tokens)
+{
+  if (tokens->zero_run != 0) {
+    put_varint(tokens->writer, ((uint64_t)(tokens->zero_run - 1U) << 1) | 1U);
+    tokens->zero_run = 0;
+  }
+}
+
+static bool get_varint(reader_t *reader, uint64_t *value)
+{
+  uint64_t result = 0;
+
+  for (uint32_t shift = 0; shift < (7U * APP_SERIES_CODEC_VARINT_MAX); shift += 7U) {
+    if (reader->pos >= reader->size) {
+      return false;
+    }
+    uint8_t byte = reader->data[reader->pos++];
+    result |= (uint64_t)(byte & 0x7FU) << shift;
+    if ((byte & 0x80U) == 0) {
+      *value = result;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static bool get_token(reader_t *reader, int32_t *value)
+{
+  if (reader->zero_run != 0) {
+    reader->zero_run--;
+    *value = 0;
+    return true;
+  }
+
+  uint64_t raw;
+  if (!get_varint(reader, &raw)) {
+    return false;
+  }
+  if (raw & 1U) {
+    // Run of (raw >> 1) + 1 zeros, this call returns the first one
+    reader->zero_run = (uint32_t)(raw >> 1);
+    *value = 0;
+  } else {
+    *value = zigzag_decode((uint32_t)(raw >> 1));
+  }
+
+  return true;
+}
+
+static uint32_t zigzag_encode(int32_t value)
+{
+  return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t zigzag_decode(uint32_t value)
+{
+  return (int32_t)((value >> 1) ^ (0U - (value & 1U)));
+}
@@ -0,0 +1,113 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_series_codec.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef APP_SERIES_CODEC_H
+#define APP_SERIES_CODEC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// First byte of an encoded series, below 0x80 so that it is never taken for a
+// fragment header by the segmentation layer
+#define APP_SERIES_CODEC_TYPE         (0x01U)
+
+// Worst case size of one varint
+#define APP_SERIES_CODEC_VARINT_MAX   (5U)
+
+// Encoded block layout:
+//   type          APP_SERIES_CODEC_TYPE
+//   count         varint, number of samples
+//   timestamp0    varint
+//   value0        zigzag varint
+//   timestamps    count - 1 tokens: first delta, then delta-of-deltas
+//   values        count - 1 tokens: value deltas
+// A token is a varint holding either a zigzag literal (bit 0 clear) or a run
+// of zeros (bit 0 set, run length - 1 in the upper bits).
+
+// Numeric sample
+typedef struct {
+  uint32_t timestamp;
+  int32_t value;
+} app_series_sample_t;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to encode as many samples as fit in a buffer
+ *
+ * @param[in] samples Samples in timestamp order
+ * @param[in] count Number of samples
+ * @param[out] out Output buffer
+ * @param[in] out_size Size of the output buffer
+ * @param[out] encoded_count Number of samples actually encoded
+ *
+ * @returns Number of bytes written, 0 if not even one sample fits
+ ******************************************************************************/
+size_t app_series_encode(const app_series_sample_t *samples,
+                         size_t count,
+                         uint8_t *out,
+                         size_t out_size,
+                         size_t *encoded_count);
+
+/*******************************************************************************
+ * Function to decode an encoded series
+ *
+ * @param[in] in Encoded block
+ * @param[in] in_size Size of the encoded block
+ * @param[out] samples Decoded samples
+ * @param[in] max_count Capacity of the samples buffer
+ * @param[out] count Number of decoded samples
+ *
+ * @returns #true on success, #false on a malformed or truncated block
+ ******************************************************************************/
+bool app_series_decode(const uint8_t *in,
+                       size_t in_size,
+                       app_series_sample_t *samples,
+                       size_t max_count,
+                       size_t *count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_SERIES_CODEC_H
@@ -0,0 +1,182 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_supervisor.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include "app_supervisor.h"
+#include "app_retained.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Retained state word: failures in a row, EM4 sleeps after giving up and
+// restarts, saturating
+#define STATE_ATTEMPT_MASK      (0xFFUL)
+#define STATE_ESCALATION_SHIFT  (8U)
+#define STATE_ESCALATION_MASK   (0xFFUL)
+#define STATE_RESTART_SHIFT     (16U)
+#define STATE_RESTART_MASK      (0xFFFFUL)
+
+// Retained recovery word: recoveries and the longest one in s, saturating
+#define RECOVERY_COUNT_MASK     (0xFFFFUL)
+#define RECOVERY_MAX_SHIFT      (16U)
+#define RECOVERY_MAX_MASK       (0xFFFFUL)
+
+_Static_assert(APP_SUPERVISOR_SLEEP_AFTER <= STATE_ATTEMPT_MASK, "failures in a row do not fit the retained word");
+_Static_assert(APP_SUPERVISOR_FALLBACK_AFTER < APP_SUPERVISOR_SLEEP_AFTER, "fallback after giving up");
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to add to a field of a retained word, saturating
+ *
+ * @param[in] slot Retained word
+ * @param[in] shift Field position
+ * @param[in] mask Field mask
+ ******************************************************************************/
+static void count(app_retained_slot_t slot, uint32_t shift, uint32_t mask);
+
+// -----------------------------------------------------------------------------
+//                                Global Variables
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+// Stack failures since boot, the retained restarts only count the retries
+static uint32_t failures;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+void app_supervisor_init(void)
+{
+  failures = 0;
+  if ((app_retained_get(APP_RETAINED_SLOT_SUPERVISOR_STATE) & STATE_ATTEMPT_MASK) > APP_SUPERVISOR_SLEEP_AFTER) {
+    // Limit lowered by a firmware update
+    app_retained_set(APP_RETAINED_SLOT_SUPERVISOR_STATE,
+                     app_retained_get(APP_RETAINED_SLOT_SUPERVISOR_STATE) & ~STATE_ATTEMPT_MASK);
+  }
+}
+
+app_supervisor_action_t app_supervisor_on_failure(uint32_t now_ms, uint32_t *delay_ms)
+{
+  uint32_t state = app_retained_get(APP_RETAINED_SLOT_SUPERVISOR_STATE);
+  uint32_t attempt = (state & STATE_ATTEMPT_MASK) + 1U;
+
+  failures++;
+  if (app_retained_get(APP_RETAINED_SLOT_SUPERVISOR_FAILING_MS) == 0) {
+    // 0 stands for running
+    app_retained_set(APP_RETAINED_SLOT_SUPERVISOR_FAILING_MS, (now_ms != 0) ? now_ms : 1U);
+  }
+
+  if (attempt >= APP_SUPERVISOR_SLEEP_AFTER) {
+    // The next boot starts over from the first backoff step
+    app_retained_set(APP_RETAINED_SLOT_SUPERVISOR_STATE, state & ~STATE_ATTEMPT_MASK);
+    count(APP_RETAINED_SLOT_SUPERVISOR_STATE, STATE_ESCALATION_SHIFT, STATE_ESCALATION_MASK);
+    *delay_ms = APP_SUPERVISOR_SLEEP_MS;
+    return APP_SUPERVISOR_SLEEP;
+  }
+  app_retained_set(APP_RETAINED_SLOT_SUPERVISOR_STATE, (state & ~STATE_ATTEMPT_MASK) | attempt);
+
+  uint32_t backoff_ms = APP_SUPERVISOR_BACKOFF_MIN_MS;
+  for (uint32_t i = 1; i < attempt && backoff_ms < APP_SUPERVISOR_BACKOFF_MAX_MS; i++) {
+    backoff_ms *= 2U;
+  }
+  *delay_ms = (backoff_ms < APP_SUPERVISOR_BACKOFF_MAX_MS) ? backoff_ms : APP_SUPERVISOR_BACKOFF_MAX_MS;
+  return (attempt > APP_SUPERVISOR_FALLBACK_AFTER) ? APP_SUPERVISOR_FALLBACK : APP_SUPERVISOR_RETRY;
+}
+
+void app_supervisor_on_restart(void)
+{
+  count(APP_RETAINED_SLOT_SUPERVISOR_STATE, STATE_RESTART_SHIFT, STATE_RESTART_MASK);
+}
+
+bool app_supervisor_on_ready(uint32_t now_ms, uint32_t *recovery_ms)
+{
+  uint32_t failing_since_ms = app_retained_get(APP_RETAINED_SLOT_SUPERVISOR_FAILING_MS);
+
+  app_retained_set(APP_RETAINED_SLOT_SUPERVISOR_STATE,
+                   app_retained_get(APP_RETAINED_SLOT_SUPERVISOR_STATE) & ~STATE_ATTEMPT_MASK);
+  if (failing_since_ms == 0) {
+    return false;
+  }
+  app_retained_set(APP_RETAINED_SLOT_SUPERVISOR_FAILING_MS, 0);
+
+  *recovery_ms = now_ms - failing_since_ms;
+  uint32_t sum_ms = app_retained_get(APP_RETAINED_SLOT_SUPERVISOR_RECOVERY_SUM_MS);
+  app_retained_set(APP_RETAINED_SLOT_SUPERVISOR_RECOVERY_SUM_MS,
+                   (sum_ms > UINT32_MAX - *recovery_ms) ? UINT32_MAX : sum_ms + *recovery_ms);
+
+  uint32_t recovery = app_retained_get(APP_RETAINED_SLOT_SUPERVISOR_RECOVERY);
+  uint32_t max_s = (recovery >> RECOVERY_MAX_SHIFT) & RECOVERY_MAX_MASK;
+  uint32_t recovery_s = *recovery_ms / 1000U;
+  if (recovery_s > max_s) {
+    max_s = (recovery_s > RECOVERY_MAX_MASK) ? RECOVERY_MAX_MASK : recovery_s;
+    app_retained_set(APP_RETAINED_SLOT_SUPERVISOR_RECOVERY,
+                     (recovery & RECOVERY_COUNT_MASK) | (max_s << RECOVERY_MAX_SHIFT));
+  }
+  count(APP_RETAINED_SLOT_SUPERVISOR_RECOVERY, 0U, RECOVERY_COUNT_MASK);
+  return true;
+}
+
+void app_supervisor_get_stats(uint32_t now_ms, app_supervisor_stats_t *stats)
+{
+  uint32_t state = app_retained_get(APP_RETAINED_SLOT_SUPERVISOR_STATE);
+  uint32_t recovery = app_retained_get(APP_RETAINED_SLOT_SUPERVISOR_RECOVERY);
+  uint32_t failing_since_ms = app_retained_get(APP_RETAINED_SLOT_SUPERVISOR_FAILING_MS);
+
+  stats->attempt = state & STATE_ATTEMPT_MASK;
+  stats->failures = failures;
+  stats->restarts = (state >> STATE_RESTART_SHIFT) & STATE_RESTART_MASK;
+  stats->escalations = (state >> STATE_ESCALATION_SHIFT) & STATE_ESCALATION_MASK;
+  stats->recoveries = recovery & RECOVERY_COUNT_MASK;
+  stats->recovery_max_ms = ((recovery >> RECOVERY_MAX_SHIFT) & RECOVERY_MAX_MASK) * 1000U;
+  stats->recovery_sum_ms = app_retained_get(APP_RETAINED_SLOT_SUPERVISOR_RECOVERY_SUM_MS);
+  stats->failing_ms = (failing_since_ms != 0) ? now_ms - failing_since_ms : 0U;
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+static void count(app_retained_slot_t slot, uint32_t shift, uint32_t mask)
+{
+  uint32_t word = app_retained_get(slot);
+  uint32_t value = (word >> shift) & mask;
+
+  if (value < mask) {
+    app_retained_set(slot, (word & ~(mask << shift)) | ((value + 1U) << shift));
+  }
+}
@@ -0,0 +1,134 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_supervisor.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+#ifndef APP_SUPERVISOR_H
+#define APP_SUPERVISOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Delay before the first restart of the stack, doubled on each failure in a
+// row up to the maximum
+#ifndef APP_SUPERVISOR_BACKOFF_MIN_MS
+#define APP_SUPERVISOR_BACKOFF_MIN_MS   (1000U)
+#endif
+#ifndef APP_SUPERVISOR_BACKOFF_MAX_MS
+#define APP_SUPERVISOR_BACKOFF_MAX_MS   (60000U)
+#endif
+// Failures in a row before the restarts try the other links one at a time
+#define APP_SUPERVISOR_FALLBACK_AFTER   (2U)
+// Failures in a row before giving up until the next wake-up
+#ifndef APP_SUPERVISOR_SLEEP_AFTER
+#define APP_SUPERVISOR_SLEEP_AFTER      (6U)
+#endif
+// EM4 sleep after giving up
+#ifndef APP_SUPERVISOR_SLEEP_MS
+#define APP_SUPERVISOR_SLEEP_MS         (10U * 60U * 1000U)
+#endif
+
+typedef enum {
+  APP_SUPERVISOR_RETRY = 0,     // Restart on the same links after the backoff
+  APP_SUPERVISOR_FALLBACK,      // Restart on another link alone after the backoff
+  APP_SUPERVISOR_SLEEP,         // Sleep in EM4, the next boot starts the stack again
+} app_supervisor_action_t;
+
+typedef struct {
+  uint32_t attempt;           // Failures in a row, 0 while the stack runs
+  uint32_t failures;          // Stack failures since boot
+  uint32_t restarts;          // Restarts since power-on
+  uint32_t escalations;       // EM4 sleeps after too many failures since power-on
+  uint32_t recoveries;        // Failures followed by a ready stack since power-on
+  uint32_t recovery_max_ms;   // Longest first failure to ready
+  uint32_t recovery_sum_ms;
+  uint32_t failing_ms;        // Time since the first failure, 0 while the stack runs
+} app_supervisor_stats_t;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to restore the restart state
+ *
+ * The state is kept in retained memory, so failures in a row and the time to
+ * recovery hold across EM4. Must be called after app_retained_init().
+ ******************************************************************************/
+void app_supervisor_init(void);
+
+/*******************************************************************************
+ * Function to count a failed start, restart or link switch of the stack
+ *
+ * @param[in] now_ms Device time
+ * @param[out] delay_ms Delay before the restart, EM4 sleep time for
+ *                      APP_SUPERVISOR_SLEEP
+ *
+ * @returns What to do next
+ ******************************************************************************/
+app_supervisor_action_t app_supervisor_on_failure(uint32_t now_ms, uint32_t *delay_ms);
+
+/*******************************************************************************
+ * Function to count a restart of the stack
+ ******************************************************************************/
+void app_supervisor_on_restart(void);
+
+/*******************************************************************************
+ * Function to report the stack ready, ends a recovery
+ *
+ * @param[in] now_ms Device time
+ * @param[out] recovery_ms First failure to ready
+ *
+ * @returns #true if the stack recovered from a failure
+ ******************************************************************************/
+bool app_supervisor_on_ready(uint32_t now_ms, uint32_t *recovery_ms);
+
+/*******************************************************************************
+ * Function to get the restart counters
+ *
+ * @param[in] now_ms Device time
+ * @param[out] stats Counters
+ ******************************************************************************/
+void app_supervisor_get_stats(uint32_t now_ms, app_supervisor_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_SUPERVISOR_H
@@ -0,0 +1,101 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_supply.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include "em_cmu.h"
+#include "em_iadc.h"
+#include "app_supply.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+#define IADC_SRC_CLK_FREQ       (20000000UL)
+#define IADC_ADC_CLK_FREQ       (10000000UL)
+// Internal 1.21 V reference, 12-bit result
+#define IADC_VREF_MV            (1210UL)
+#define IADC_FULL_SCALE         (0xFFFUL)
+// The AVDD input is divided by 4 inside the IADC
+#define IADC_AVDD_DIVIDER       (4UL)
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Global Variables
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+uint16_t app_supply_measure_mv(void)
+{
+  IADC_Init_t init = IADC_INIT_DEFAULT;
+  IADC_AllConfigs_t all_configs = IADC_ALLCONFIGS_DEFAULT;
+  IADC_InitSingle_t init_single = IADC_INITSINGLE_DEFAULT;
+  IADC_SingleInput_t input = IADC_SINGLEINPUT_DEFAULT;
+
+  CMU_ClockEnable(cmuClock_IADC0, true);
+  CMU_ClockSelectSet(cmuClock_IADCCLK, cmuSelect_FSRCO);
+
+  init.srcClkPrescale = IADC_calcSrcClkPrescale(IADC0, IADC_SRC_CLK_FREQ, 0);
+  all_configs.configs[0].reference = iadcCfgReferenceInt1V2;
+  all_configs.configs[0].vRef = IADC_VREF_MV;
+  all_configs.configs[0].analogGain = iadcCfgAnalogGain1x;
+  all_configs.configs[0].adcClkPrescale = IADC_calcAdcClkPrescale(IADC0,
+                                                                  IADC_ADC_CLK_FREQ,
+                                                                  0,
+                                                                  iadcCfgModeNormal,
+                                                                  init.srcClkPrescale);
+  input.posInput = iadcPosInputAvdd;
+  input.negInput = iadcNegInputGnd;
+
+  IADC_reset(IADC0);
+  IADC_init(IADC0, &init, &all_configs);
+  IADC_initSingle(IADC0, &init_single, &input);
+
+  IADC_command(IADC0, iadcCmdStartSingle);
+  while ((IADC0->STATUS & (_IADC_STATUS_CONVERTING_MASK | _IADC_STATUS_SINGLEFIFODV_MASK))
+         != IADC_STATUS_SINGLEFIFODV) {
+  }
+  IADC_Result_t result = IADC_readSingleResult(IADC0);
+
+  IADC_reset(IADC0);
+  CMU_ClockEnable(cmuClock_IADC0, false);
+
+  return (uint16_t)((result.data * IADC_VREF_MV * IADC_AVDD_DIVIDER) / IADC_FULL_SCALE);
+}
@@ -0,0 +1,548 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_trace.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "app_trace.h"
+#include "app_retained.h"
+#include "app_nvm.h"
+#include "sl_sidewalk_log_app.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Chunk of packed records as stored in NVM3, the wake-ups append to the open
+// chunk until their records no longer fit. Only the used bytes are written.
+typedef struct {
+  uint32_t seq;
+  uint16_t size;              // Bytes of data used
+  uint16_t reserved;
+  uint32_t last_ms;           // Time of the last record, the next wake-up packs a delta to it
+  uint8_t data[APP_TRACE_CHUNK_BYTES];
+} trace_chunk_t;
+
+#define CHUNK_HEADER_BYTES          (offsetof(trace_chunk_t, data))
+
+// Packed record: a header byte with the type in the low nibble, flags for the
+// arguments that are not 0 and the size of the time field, followed by the
+// time and the arguments present, little endian. The time is the delta in ms
+// to the previous record of the chunk, or the device time for the first
+// record of a chunk and for larger deltas.
+#define PACKED_TYPE_MASK            (0x0FU)
+#define PACKED_ARG0                 (0x10U)
+#define PACKED_ARG1                 (0x20U)
+#define PACKED_TIME_SHIFT           (6U)
+#define PACKED_TIME_SAME            (0U)  // No time field, same ms as the previous record
+#define PACKED_TIME_DELTA8          (1U)
+#define PACKED_TIME_DELTA16         (2U)
+#define PACKED_TIME_ABSOLUTE        (3U)
+#define PACKED_RECORD_MAX_BYTES     (8U)
+// Packed type of an event begin directly followed by its end: arg0 is the
+// event type and arg1 the time in ms from the begin to the end
+#define PACKED_TYPE_DISPATCH        (0x0FU)
+
+// Input waiting for the main task, ready once completely written
+typedef struct {
+  atomic_bool ready;
+  app_trace_record_t record;
+} staged_input_t;
+
+_Static_assert(sizeof(app_trace_record_t) == 8, "trace records are dumped as 8 bytes");
+_Static_assert(APP_TRACE_INPUT < PACKED_TYPE_DISPATCH, "record types must fit in the packed header");
+_Static_assert(APP_TRACE_CHUNK_BYTES <= UINT16_MAX, "chunk size is stored in 16 bits");
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+#if APP_TRACE_PERSIST
+/*******************************************************************************
+ * Function to get the sequence number of the next chunk to write
+ *
+ * @returns Sequence number, starting at 1
+ ******************************************************************************/
+static uint32_t next_chunk_seq(void);
+
+/*******************************************************************************
+ * Function to read a chunk from NVM3 into the chunk buffer
+ *
+ * @param[in] seq Sequence number of the chunk
+ *
+ * @returns #true if the chunk is stored and still holds that sequence number
+ ******************************************************************************/
+static bool read_chunk(uint32_t seq);
+
+/*******************************************************************************
+ * Function to write the records of the wake-up to NVM3
+ ******************************************************************************/
+static void persist_pending(void);
+
+/*******************************************************************************
+ * Function to pack the records of the wake-up
+ *
+ * An event begin directly followed by its end is packed as one record.
+ * Packing stops at the first record that does not fit, the records left out
+ * are counted.
+ *
+ * @param[out] data Packed records
+ * @param[in] capacity Size of data
+ * @param[in] continued #true if data follows records of the chunk
+ * @param[in,out] last_ms Time of the last record of the chunk, updated
+ * @param[out] left_out Number of records that did not fit
+ *
+ * @returns Number of bytes packed
+ ******************************************************************************/
+static uint32_t pack_pending(uint8_t *data, uint32_t capacity, bool continued, uint32_t *last_ms, uint32_t *left_out);
+
+/*******************************************************************************
+ * Function to pack a record
+ *
+ * @param[out] out Packed record, PACKED_RECORD_MAX_BYTES at most
+ * @param[in] record Record
+ * @param[in] previous_ms Time of the previous record, NULL for the first one
+ *
+ * @returns Size of the packed record
+ ******************************************************************************/
+static uint32_t pack_record(uint8_t *out, const app_trace_record_t *record, const uint32_t *previous_ms);
+
+/*******************************************************************************
+ * Function to unpack a record
+ *
+ * @param[in] in Packed records
+ * @param[in] available Bytes left in the chunk
+ * @param[in,out] record Previous record of the chunk, replaced by the unpacked one
+ *
+ * @returns Size of the packed record, 0 if it is truncated
+ ******************************************************************************/
+static uint32_t unpack_record(const uint8_t *in, uint32_t available, app_trace_record_t *record);
+
+/*******************************************************************************
+ * Function to get the dispatch record standing for an event begin and end
+ *
+ * @param[in] begin Record, followed by the next one if any
+ * @param[in] count Number of records from begin
+ * @param[out] dispatch Dispatch record, timed at the begin
+ *
+ * @returns #true if begin is an event begin directly followed by its end
+ ******************************************************************************/
+static bool dispatch_record(const app_trace_record_t *begin, uint32_t count, app_trace_record_t *dispatch);
+
+/*******************************************************************************
+ * Function to print the records of the chunk buffer
+ *
+ * @returns Number of records printed
+ ******************************************************************************/
+static uint32_t dump_chunk(void);
+#endif
+
+/*******************************************************************************
+ * Function to print records
+ *
+ * @param[in] records Records
+ * @param[in] count Number of records
+ ******************************************************************************/
+static void dump_records(const app_trace_record_t *records, uint32_t count);
+
+/*******************************************************************************
+ * Function to append a record to the records of the wake-up
+ *
+ * @param[in] record Record, copied
+ ******************************************************************************/
+static void append(const app_trace_record_t *record);
+
+// -----------------------------------------------------------------------------
+//                                Global Variables
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+// Records of the wake-up, not persisted yet
+static app_trace_record_t pending[APP_TRACE_RAM_RECORDS];
+static uint32_t pending_count;
+
+// Records dropped since the boot, RAM buffer or chunk full
+static uint32_t dropped;
+
+#if APP_TRACE_PERSIST
+// Chunk being written or dumped
+static trace_chunk_t chunk;
+#endif
+
+// Free running indexes of the staged inputs. Producers claim a slot by moving
+// the head, the main task alone moves the tail.
+static staged_input_t staged[APP_TRACE_INPUT_SLOTS];
+static atomic_uint_fast32_t staged_head;
+static atomic_uint_fast32_t staged_tail;
+static atomic_uint_fast32_t staged_dropped;
+
+// Records written to NVM3, cleared by the battery tiers
+static bool persist = true;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+void app_trace_init(void)
+{
+  pending_count = 0;
+  app_trace_record(APP_TRACE_BOOT, 0, (uint16_t)app_retained_get_reset_cause());
+}
+
+void app_trace_record(app_trace_type_t type, uint8_t arg0, uint16_t arg1)
+{
+  app_trace_record_t record = {
+    .timestamp_ms = app_retained_now_ms(),
+    .type = (uint8_t)type,
+    .arg0 = arg0,
+    .arg1 = arg1,
+  };
+
+  append(&record);
+}
+
+void app_trace_input(app_trace_input_t input, uint16_t arg)
+{
+  uint_fast32_t head = atomic_load_explicit(&staged_head, memory_order_relaxed);
+
+  do {
+    if (head - atomic_load_explicit(&staged_tail, memory_order_acquire) >= APP_TRACE_INPUT_SLOTS) {
+      atomic_fetch_add_explicit(&staged_dropped, 1U, memory_order_relaxed);
+      return;
+    }
+  } while (!atomic_compare_exchange_weak_explicit(&staged_head, &head, head + 1U,
+                                                  memory_order_relaxed, memory_order_relaxed));
+
+  staged_input_t *slot = &staged[head % APP_TRACE_INPUT_SLOTS];
+  slot->record.timestamp_ms = app_retained_now_ms();
+  slot->record.type = (uint8_t)APP_TRACE_INPUT;
+  slot->record.arg0 = (uint8_t)input;
+  slot->record.arg1 = arg;
+  atomic_store_explicit(&slot->ready, true, memory_order_release);
+}
+
+void app_trace_drain_inputs(void)
+{
+  uint_fast32_t tail = atomic_load_explicit(&staged_tail, memory_order_relaxed);
+
+  while (tail != atomic_load_explicit(&staged_head, memory_order_relaxed)) {
+    staged_input_t *slot = &staged[tail % APP_TRACE_INPUT_SLOTS];
+    if (!atomic_load_explicit(&slot->ready, memory_order_acquire)) {
+      // Claimed by a producer that was interrupted, taken on the next drain
+      break;
+    }
+    append(&slot->record);
+    atomic_store_explicit(&slot->ready, false, memory_order_relaxed);
+    atomic_store_explicit(&staged_tail, ++tail, memory_order_release);
+  }
+}
+
+void app_trace_flush(void)
+{
+#if APP_TRACE_PERSIST
+  if (pending_count != 0 && persist) {
+    persist_pending();
+  }
+#endif
+  pending_count = 0;
+}
+
+void app_trace_set_persist(bool enable)
+{
+  persist = enable;
+}
+
+void app_trace_dump(void)
+{
+  uint32_t total = 0;
+
+  SL_SID_LOG_APP_INFO("trace: begin");
+
+#if APP_TRACE_PERSIST
+  uint32_t next = next_chunk_seq();
+  uint32_t first = (next > APP_TRACE_NVM_CHUNKS) ? (next - APP_TRACE_NVM_CHUNKS) : 1U;
+
+  for (uint32_t seq = first; seq < next; seq++) {
+    if (read_chunk(seq)) {
+      total += dump_chunk();
+    }
+  }
+#endif
+
+  dump_records(pending, pending_count);
+  total += pending_count;
+
+  SL_SID_LOG_APP_INFO("trace: end, records: %lu, dropped: %lu, inputs dropped: %lu",
+                      (unsigned long)total,
+                      (unsigned long)dropped,
+                      (unsigned long)atomic_load_explicit(&staged_dropped, memory_order_relaxed));
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+#if APP_TRACE_PERSIST
+static uint32_t next_chunk_seq(void)
+{
+  uint32_t next = app_retained_get(APP_RETAINED_SLOT_TRACE_SEQ);
+
+  if (next == 0) {
+    // Retained words lost (power-on), continue after the newest stored chunk
+    next = 1;
+    for (uint32_t i = 0; i < APP_TRACE_NVM_CHUNKS; i++) {
+      uint32_t seq;
+      if (app_nvm_read_partial((app_nvm_key_t)(APP_NVM_KEY_TRACE_CHUNK_FIRST + i), &seq, sizeof(seq))
+          && seq >= next) {
+        next = seq + 1U;
+      }
+    }
+    app_retained_set(APP_RETAINED_SLOT_TRACE_SEQ, next);
+  }
+
+  return next;
+}
+
+static bool read_chunk(uint32_t seq)
+{
+  app_nvm_key_t key = (app_nvm_key_t)(APP_NVM_KEY_TRACE_CHUNK_FIRST + (seq % APP_TRACE_NVM_CHUNKS));
+
+  return app_nvm_read_partial(key, &chunk, CHUNK_HEADER_BYTES)
+         && chunk.seq == seq
+         && chunk.size <= APP_TRACE_CHUNK_BYTES
+         && app_nvm_read_partial(key, &chunk, CHUNK_HEADER_BYTES + chunk.size);
+}
+
+static void persist_pending(void)
+{
+  uint32_t next = next_chunk_seq();
+  uint32_t left_out = 0;
+  uint32_t size = 0;
+  bool append_to_open = (next > 1U) && read_chunk(next - 1U);
+
+  if (append_to_open) {
+    uint32_t last_ms = chunk.last_ms;
+    size = pack_pending(&chunk.data[chunk.size], APP_TRACE_CHUNK_BYTES - chunk.size, true, &last_ms, &left_out);
+    chunk.last_ms = last_ms;
+  }
+  if (!append_to_open || left_out != 0) {
+    // The wake-up starts a new chunk, overwriting the oldest one
+    chunk.seq = next;
+    chunk.size = 0;
+    chunk.reserved = 0;
+    size = pack_pending(chunk.data, APP_TRACE_CHUNK_BYTES, false, &chunk.last_ms, &left_out);
+    dropped += left_out;
+  }
+  if (size == 0) {
+    return;
+  }
+
+  chunk.size = (uint16_t)(chunk.size + size);
+  app_nvm_key_t key = (app_nvm_key_t)(APP_NVM_KEY_TRACE_CHUNK_FIRST + (chunk.seq % APP_TRACE_NVM_CHUNKS));
+  // Dropped if the write failed, tracing must not keep the device awake
+  if (app_nvm_write(key, &chunk, CHUNK_HEADER_BYTES + chunk.size) && chunk.seq == next) {
+    app_retained_set(APP_RETAINED_SLOT_TRACE_SEQ, next + 1U);
+  }
+}
+
+static uint32_t pack_pending(uint8_t *data, uint32_t capacity, bool continued, uint32_t *last_ms, uint32_t *left_out)
+{
+  uint32_t size = 0;
+
+  *left_out = 0;
+  for (uint32_t i = 0; i < pending_count; i++) {
+    const app_trace_record_t *record = &pending[i];
+    app_trace_record_t dispatch;
+    uint32_t records = 1;
+    if (dispatch_record(record, pending_count - i, &dispatch)) {
+      record = &dispatch;
+      records = 2;
+    }
+
+    uint8_t packed[PACKED_RECORD_MAX_BYTES];
+    uint32_t packed_size = pack_record(packed, record, continued ? last_ms : NULL);
+    i += records - 1U;
+    if (*left_out != 0 || size + packed_size > capacity) {
+      *left_out += records;
+      continue;
+    }
+    memcpy(&data[size], packed, packed_size);
+    size += packed_size;
+    *last_ms = pending[i].timestamp_ms;
+    continued = true;
+  }
+
+  return size;
+}
+
+static uint32_t pack_record(uint8_t *out, const app_trace_record_t *record, const uint32_t *previous_ms)
+{
+  uint32_t time_code = PACKED_TIME_ABSOLUTE;
+  uint32_t time = record->timestamp_ms;
+  uint32_t size = 1;
+
+  // Device time may step back when it is synchronized, that record is absolute
+  if (previous_ms != NULL && record->timestamp_ms >= *previous_ms) {
+    uint32_t delta_ms = record->timestamp_ms - *previous_ms;
+    if (delta_ms <= UINT16_MAX) {
+      time_code = (delta_ms == 0) ? PACKED_TIME_SAME
+                  : (delta_ms <= UINT8_MAX) ? PACKED_TIME_DELTA8 : PACKED_TIME_DELTA16;
+      time = delta_ms;
+    }
+  }
+
+  out[0] = (uint8_t)((record->type & PACKED_TYPE_MASK)
+                     | ((record->arg0 != 0) ? PACKED_ARG0 : 0U)
+                     | ((record->arg1 != 0) ? PACKED_ARG1 : 0U)
+                     | (time_code << PACKED_TIME_SHIFT));
+  // The time field is as many bytes as its code, 4 for the absolute time
+  uint32_t time_bytes = (time_code == PACKED_TIME_ABSOLUTE) ? 4U : time_code;
+  for (uint32_t i = 0; i < time_bytes; i++) {
+    out[size++] = (uint8_t)(time >> (8U * i));
+  }
+  if (record->arg0 != 0) {
+    out[size++] = record->arg0;
+  }
+  if (record->arg1 != 0) {
+    out[size++] = (uint8_t)record->arg1;
+    out[size++] = (uint8_t)(record->arg1 >> 8);
+  }
+
+  return size;
+}
+
+static uint32_t unpack_record(const uint8_t *in, uint32_t available, app_trace_record_t *record)
+{
+  uint8_t header = in[0];
+  uint32_t time_code = header >> PACKED_TIME_SHIFT;
+  uint32_t time_bytes = (time_code == PACKED_TIME_ABSOLUTE) ? 4U : time_code;
+  uint32_t size = 1U + time_bytes + (((header & PACKED_ARG0) != 0) ? 1U : 0U) + (((header & PACKED_ARG1) != 0) ? 2U : 0U);
+
+  if (size > available) {
+    return 0;
+  }
+
+  uint32_t time = 0;
+  for (uint32_t i = 0; i < time_bytes; i++) {
+    time |= (uint32_t)in[1U + i] << (8U * i);
+  }
+  record->timestamp_ms = (time_code == PACKED_TIME_ABSOLUTE) ? time : (record->timestamp_ms + time);
+  record->type = header & PACKED_TYPE_MASK;
+
+  const uint8_t *args = &in[1U + time_bytes];
+  record->arg0 = ((header & PACKED_ARG0) != 0) ? *args++ : 0U;
+  record->arg1 = ((header & PACKED_ARG1) != 0) ? (uint16_t)(args[0] | (args[1] << 8)) : 0U;
+
+  return size;
+}
+
+static bool dispatch_record(const app_trace_record_t *begin, uint32_t count, app_trace_record_t *dispatch)
+{
+  if (count < 2U
+      || begin[0].type != APP_TRACE_EVENT_BEGIN
+      || begin[1].type != APP_TRACE_EVENT_END
+      || begin[1].arg0 != begin[0].arg0
+      || begin[1].timestamp_ms - begin[0].timestamp_ms > UINT16_MAX) {
+    return false;
+  }
+
+  dispatch->timestamp_ms = begin[0].timestamp_ms;
+  dispatch->type = PACKED_TYPE_DISPATCH;
+  dispatch->arg0 = begin[0].arg0;
+  dispatch->arg1 = (uint16_t)(begin[1].timestamp_ms - begin[0].timestamp_ms);
+  return true;
+}
+
+static uint32_t dump_chunk(void)
+{
+  app_trace_record_t record = { 0 };
+  uint32_t count = 0;
+  uint32_t offset = 0;
+
+  while (offset < chunk.size) {
+    uint32_t size = unpack_record(&chunk.data[offset], chunk.size - offset, &record);
+    if (size == 0) {
+      break;
+    }
+    offset += size;
+    if (record.type == PACKED_TYPE_DISPATCH) {
+      app_trace_record_t events[2] = {
+        { .timestamp_ms = record.timestamp_ms, .type = APP_TRACE_EVENT_BEGIN, .arg0 = record.arg0 },
+        { .timestamp_ms = record.timestamp_ms + record.arg1, .type = APP_TRACE_EVENT_END, .arg0 = record.arg0 },
+      };
+      dump_records(events, 2U);
+      // The next record is timed from the end
+      record = events[1];
+      count += 2U;
+    } else {
+      dump_records(&record, 1U);
+      count++;
+    }
+  }
+
+  return count;
+}
+#endif
+
+static void append(const app_trace_record_t *record)
+{
+#if APP_TRACE_PERSIST
+  if (persist && pending_count != 0
+      && (pending_count == APP_TRACE_RAM_RECORDS
+          || record->timestamp_ms - pending[0].timestamp_ms >= APP_TRACE_FLUSH_INTERVAL_MS)) {
+    // Long wake-up, write what it has so far in case it ends in a reset
+    persist_pending();
+    pending_count = 0;
+  }
+#endif
+  if (pending_count == APP_TRACE_RAM_RECORDS) {
+    // Not persisted, keep the start of the wake-up
+    dropped++;
+    return;
+  }
+
+  pending[pending_count++] = *record;
+}
+
+static void dump_records(const app_trace_record_t *records, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++) {
+    const uint8_t *bytes = (const uint8_t *)&records[i];
+    SL_SID_LOG_APP_INFO("trace: %02x%02x%02x%02x%02x%02x%02x%02x",
+                        bytes[0], bytes[1], bytes[2], bytes[3],
+                        bytes[4], bytes[5], bytes[6], bytes[7]);
+  }
+}
@@ -0,0 +1,176 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_trace.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef APP_TRACE_H
+#define APP_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Persist the trace in NVM3 so it survives EM4 and resets. The records of a
+// wake-up stay in RAM and are packed into the open chunk before EM4 or a
+// reset, so a short wake-up costs one NVM3 write. An event dispatched with no
+// record in between packs its begin and end as one record.
+#ifndef APP_TRACE_PERSIST
+#define APP_TRACE_PERSIST           (1)
+#endif
+
+// Records of the current wake-up kept in RAM. They are written to NVM3 when
+// the buffer is full, and once the oldest is this old so a watchdog, assert
+// or fault reset loses no more than that of the wake-up.
+#define APP_TRACE_RAM_RECORDS       (64U)
+#ifndef APP_TRACE_FLUSH_INTERVAL_MS
+#define APP_TRACE_FLUSH_INTERVAL_MS (60000U)
+#endif
+// Packed records per chunk, the chunk object stays below the 254 bytes NVM3
+// accepts by default
+#define APP_TRACE_CHUNK_BYTES       (240U)
+// Chunks kept in NVM3, the oldest are overwritten. A wake-up of the normal
+// battery tier packs into about 60 bytes with its events, the chunks hold
+// about two hours of them in 10 kB of NVM3 (NVM3_DEFAULT_NVM_SIZE in the slcp).
+#define APP_TRACE_NVM_CHUNKS        (40U)
+// Inputs recorded from interrupts or other tasks, waiting for the main task
+#define APP_TRACE_INPUT_SLOTS       (8U)
+
+// Record types
+typedef enum {
+  APP_TRACE_BOOT = 1,         // arg1: reset cause
+  APP_TRACE_EVENT_BEGIN,      // arg0: event type
+  APP_TRACE_EVENT_END,        // arg0: event type
+  APP_TRACE_STATUS,           // arg0: state, arg1: registration | time sync << 1 | link status << 4
+  APP_TRACE_LINK_START,       // arg1: link mask
+  APP_TRACE_LINK_STOP,        // arg1: link mask
+  APP_TRACE_MSG_SENT,         // arg0: link, arg1: message id
+  APP_TRACE_MSG_ERROR,        // arg0: error, arg1: message id
+  APP_TRACE_MSG_RECEIVED,     // arg0: link, arg1: size
+  APP_TRACE_EM4_ENTER,        // arg0: radio sleep depth, arg1: planned sleep in s
+  APP_TRACE_INPUT,            // arg0: input, arg1: argument
+} app_trace_type_t;
+
+// Inputs of the main task, the requests it gets from outside. Together with
+// the status, downlink and timing records they are enough to replay a trace
+// on the host build, see host/host_replay.c. Bench runs are not recorded.
+typedef enum {
+  APP_TRACE_INPUT_CONNECT_AND_SEND = 1,
+  APP_TRACE_INPUT_SEND_COUNTER_UPDATE,
+  APP_TRACE_INPUT_SEND_REPORT,
+  APP_TRACE_INPUT_FACTORY_RESET,
+  APP_TRACE_INPUT_LINK_SWITCH,  // Argument is the target link, 0 for the next one
+  APP_TRACE_INPUT_CONNECTION_REQUEST,
+  APP_TRACE_INPUT_GET_TIME,
+  APP_TRACE_INPUT_GET_MTU,
+  APP_TRACE_INPUT_TRACE_DUMP,
+  APP_TRACE_INPUT_AIRTIME_STATS,
+  APP_TRACE_INPUT_EM4_SLEEP,  // Inactivity timeout or button press
+  APP_TRACE_INPUT_AWAKE_LEASE,  // Lease requested from the CLI or a button, argument in s
+  APP_TRACE_INPUT_ALARM,        // Alarm raised, argument is the alarm code
+  APP_TRACE_INPUT_OUTBOX_STATS,
+  APP_TRACE_INPUT_SUPERVISOR_STATS,
+  APP_TRACE_INPUT_SEND,         // Payload sent, argument is its size
+} app_trace_input_t;
+
+// Trace record, dumped little endian
+typedef struct {
+  uint32_t timestamp_ms;      // Device time, see app_retained_now_ms()
+  uint8_t type;
+  uint8_t arg0;
+  uint16_t arg1;
+} app_trace_record_t;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to start tracing, records the boot
+ ******************************************************************************/
+void app_trace_init(void);
+
+/*******************************************************************************
+ * Function to add a record, main task only
+ *
+ * @param[in] type Record type
+ * @param[in] arg0 First argument
+ * @param[in] arg1 Second argument
+ ******************************************************************************/
+void app_trace_record(app_trace_type_t type, uint8_t arg0, uint16_t arg1);
+
+/*******************************************************************************
+ * Function to record an input, from any context including interrupts
+ *
+ * The input is staged and moved into the trace by app_trace_drain_inputs(),
+ * with the time it was recorded. Inputs are dropped if the main task falls
+ * behind by more than APP_TRACE_INPUT_SLOTS.
+ *
+ * @param[in] input Input
+ * @param[in] arg Argument
+ ******************************************************************************/
+void app_trace_input(app_trace_input_t input, uint16_t arg);
+
+/*******************************************************************************
+ * Function to move the staged inputs into the trace, main task only
+ ******************************************************************************/
+void app_trace_drain_inputs(void);
+
+/*******************************************************************************
+ * Function to persist the buffered records, before EM4 or a reset
+ ******************************************************************************/
+void app_trace_flush(void);
+
+/*******************************************************************************
+ * Function to turn the NVM3 writes of the trace on or off for this boot
+ *
+ * Without them the records of a wake-up are lost on EM4, which saves the
+ * flash write of the wake-up. No effect without APP_TRACE_PERSIST.
+ *
+ * @param[in] enable #true to persist the records, the default
+ ******************************************************************************/
+void app_trace_set_persist(bool enable);
+
+/*******************************************************************************
+ * Function to print the persisted and buffered records, oldest first
+ ******************************************************************************/
+void app_trace_dump(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_TRACE_H
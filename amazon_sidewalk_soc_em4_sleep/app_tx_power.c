@@ -0,0 +1,261 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_tx_power.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include "sid_api.h"
+#include "app_tx_power.h"
+#include "app_retained.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Retained state word: 7 bits per link, the dB below the maximum power and
+// the downlinks seen with room to lower it
+#define STATE_LINK_BITS         (7U)
+#define STATE_BACKOFF_MASK      (0x1FUL)
+#define STATE_GOOD_SHIFT        (5U)
+#define STATE_GOOD_MASK         (0x3UL)
+
+_Static_assert(APP_TX_POWER_BLE_MAX_DBM - APP_TX_POWER_BLE_MIN_DBM <= (int)STATE_BACKOFF_MASK, "BLE power range too wide");
+_Static_assert(APP_TX_POWER_SUBGHZ_MAX_DBM - APP_TX_POWER_SUBGHZ_MIN_DBM <= (int)STATE_BACKOFF_MASK, "sub-GHz power range too wide");
+_Static_assert(APP_TX_POWER_GOOD_COUNT <= STATE_GOOD_MASK + 1U, "good count does not fit the retained word");
+
+typedef enum {
+  TX_POWER_LINK_BLE = 0,
+  TX_POWER_LINK_FSK,
+  TX_POWER_LINK_CSS,
+  TX_POWER_LINK_COUNT
+} tx_power_link_t;
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to get the controller index of a link
+ *
+ * @param[in] link Link type
+ * @param[out] index Controller index
+ *
+ * @returns #false for an unknown link
+ ******************************************************************************/
+static bool link_index(uint32_t link, tx_power_link_t *index);
+
+/*******************************************************************************
+ * Function to get the power range of a link
+ *
+ * @param[in] index Controller index
+ *
+ * @returns dB between the minimum and the maximum power
+ ******************************************************************************/
+static uint32_t backoff_max(tx_power_link_t index);
+
+/*******************************************************************************
+ * Function to move the power of a link
+ *
+ * @param[in] index Controller index
+ * @param[in] backoff New dB below the maximum power, clamped to the range
+ * @param[in] good Downlinks seen with room to lower the power
+ *
+ * @returns #true if the power changed
+ ******************************************************************************/
+static bool set_backoff(tx_power_link_t index, int32_t backoff, uint32_t good);
+
+// -----------------------------------------------------------------------------
+//                                Global Variables
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+static const int8_t max_dbm[TX_POWER_LINK_COUNT] = {
+  [TX_POWER_LINK_BLE] = APP_TX_POWER_BLE_MAX_DBM,
+  [TX_POWER_LINK_FSK] = APP_TX_POWER_SUBGHZ_MAX_DBM,
+  [TX_POWER_LINK_CSS] = APP_TX_POWER_SUBGHZ_MAX_DBM,
+};
+
+static const int8_t min_dbm[TX_POWER_LINK_COUNT] = {
+  [TX_POWER_LINK_BLE] = APP_TX_POWER_BLE_MIN_DBM,
+  [TX_POWER_LINK_FSK] = APP_TX_POWER_SUBGHZ_MIN_DBM,
+  [TX_POWER_LINK_CSS] = APP_TX_POWER_SUBGHZ_MIN_DBM,
+};
+
+static app_tx_power_stats_t stats[TX_POWER_LINK_COUNT];
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+void app_tx_power_init(void)
+{
+  uint32_t state = app_retained_get(APP_RETAINED_SLOT_TX_POWER_STATE);
+
+  for (uint32_t i = 0; i < TX_POWER_LINK_COUNT; i++) {
+    uint32_t backoff = (state >> (i * STATE_LINK_BITS)) & STATE_BACKOFF_MASK;
+    if (backoff > backoff_max((tx_power_link_t)i)) {
+      // Range changed by a firmware update
+      backoff = backoff_max((tx_power_link_t)i);
+    }
+    stats[i].power_dbm = (int8_t)(max_dbm[i] - (int32_t)backoff);
+  }
+}
+
+int8_t app_tx_power_get_dbm(uint32_t link)
+{
+  tx_power_link_t index;
+
+  if (!link_index(link, &index)) {
+    return 0;
+  }
+  return stats[index].power_dbm;
+}
+
+bool app_tx_power_on_downlink(uint32_t link, int8_t rssi, int8_t snr)
+{
+  tx_power_link_t index;
+
+  if (!link_index(link, &index)) {
+    return false;
+  }
+
+  int32_t margin = 0;
+  switch (index) {
+    case TX_POWER_LINK_BLE:
+      margin = rssi - APP_TX_POWER_BLE_SENSITIVITY_DBM;
+      break;
+    case TX_POWER_LINK_FSK:
+      margin = rssi - APP_TX_POWER_FSK_SENSITIVITY_DBM;
+      break;
+    default:
+      margin = snr - APP_TX_POWER_CSS_SNR_MIN_DB;
+      break;
+  }
+
+  int32_t backoff = max_dbm[index] - stats[index].power_dbm;
+  int32_t uplink_margin = margin - backoff;
+  uint32_t state = app_retained_get(APP_RETAINED_SLOT_TX_POWER_STATE);
+  uint32_t good = (state >> ((index * STATE_LINK_BITS) + STATE_GOOD_SHIFT)) & STATE_GOOD_MASK;
+  bool changed = false;
+
+  if (uplink_margin < APP_TX_POWER_TARGET_MARGIN_DB) {
+    // Degraded, raise to the target at once
+    changed = set_backoff(index, backoff - (APP_TX_POWER_TARGET_MARGIN_DB - uplink_margin), 0);
+  } else if (uplink_margin < APP_TX_POWER_TARGET_MARGIN_DB + APP_TX_POWER_STEP_DB) {
+    changed = set_backoff(index, backoff, 0);
+  } else if (good + 1U < APP_TX_POWER_GOOD_COUNT) {
+    changed = set_backoff(index, backoff, good + 1U);
+  } else {
+    changed = set_backoff(index, backoff + APP_TX_POWER_STEP_DB, 0);
+  }
+
+  // Margin expected at the power of the next uplink
+  uplink_margin = margin - (max_dbm[index] - stats[index].power_dbm);
+  stats[index].margin_db = (int8_t)((uplink_margin < INT8_MIN) ? INT8_MIN : ((uplink_margin > INT8_MAX) ? INT8_MAX : uplink_margin));
+  stats[index].measured = true;
+  return changed;
+}
+
+bool app_tx_power_on_send_error(uint32_t link)
+{
+  tx_power_link_t index;
+
+  if (!link_index(link, &index)) {
+    return false;
+  }
+  int8_t power_dbm = stats[index].power_dbm;
+  bool changed = set_backoff(index, (max_dbm[index] - power_dbm) - APP_TX_POWER_ERROR_STEP_DB, 0);
+  stats[index].margin_db = (int8_t)(stats[index].margin_db + (stats[index].power_dbm - power_dbm));
+  return changed;
+}
+
+const app_tx_power_stats_t *app_tx_power_get_stats(uint32_t link)
+{
+  tx_power_link_t index;
+
+  if (!link_index(link, &index)) {
+    return NULL;
+  }
+  return &stats[index];
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+static bool link_index(uint32_t link, tx_power_link_t *index)
+{
+  switch (link) {
+    case SID_LINK_TYPE_1:
+      *index = TX_POWER_LINK_BLE;
+      return true;
+    case SID_LINK_TYPE_2:
+      *index = TX_POWER_LINK_FSK;
+      return true;
+    case SID_LINK_TYPE_3:
+      *index = TX_POWER_LINK_CSS;
+      return true;
+    default:
+      return false;
+  }
+}
+
+static uint32_t backoff_max(tx_power_link_t index)
+{
+  return (uint32_t)(max_dbm[index] - min_dbm[index]);
+}
+
+static bool set_backoff(tx_power_link_t index, int32_t backoff, uint32_t good)
+{
+  if (backoff < 0) {
+    backoff = 0;
+  } else if ((uint32_t)backoff > backoff_max(index)) {
+    backoff = (int32_t)backoff_max(index);
+  }
+
+  uint32_t shift = index * STATE_LINK_BITS;
+  uint32_t state = app_retained_get(APP_RETAINED_SLOT_TX_POWER_STATE);
+  state &= ~(((STATE_GOOD_MASK << STATE_GOOD_SHIFT) | STATE_BACKOFF_MASK) << shift);
+  state |= (((good & STATE_GOOD_MASK) << STATE_GOOD_SHIFT) | (uint32_t)backoff) << shift;
+  app_retained_set(APP_RETAINED_SLOT_TX_POWER_STATE, state);
+
+  int8_t power_dbm = (int8_t)(max_dbm[index] - backoff);
+  if (power_dbm == stats[index].power_dbm) {
+    return false;
+  }
+  if (power_dbm < stats[index].power_dbm) {
+    stats[index].steps_down++;
+  } else {
+    stats[index].steps_up++;
+  }
+  stats[index].power_dbm = power_dbm;
+  return true;
+}
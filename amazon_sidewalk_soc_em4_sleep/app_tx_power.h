@@ -0,0 +1,145 @@
+/***************************************************************************//**
+ * @file
+ * @brief app_tx_power.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef APP_TX_POWER_H
+#define APP_TX_POWER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// TX power range of each link. The BLE maximum is SL_BT_CONFIG_MAX_TX_POWER of
+// the slcp, the sub-GHz maximum the regional limit of the radio.
+#ifndef APP_TX_POWER_BLE_MAX_DBM
+#define APP_TX_POWER_BLE_MAX_DBM        (10)
+#endif
+#ifndef APP_TX_POWER_BLE_MIN_DBM
+#define APP_TX_POWER_BLE_MIN_DBM        (-10)
+#endif
+#ifndef APP_TX_POWER_SUBGHZ_MAX_DBM
+#define APP_TX_POWER_SUBGHZ_MAX_DBM     (20)
+#endif
+#ifndef APP_TX_POWER_SUBGHZ_MIN_DBM
+#define APP_TX_POWER_SUBGHZ_MIN_DBM     (0)
+#endif
+
+// Receive thresholds the margin is measured against: downlink RSSI for BLE
+// and FSK, downlink SNR for CSS (SF11)
+#define APP_TX_POWER_BLE_SENSITIVITY_DBM  (-94)
+#define APP_TX_POWER_FSK_SENSITIVITY_DBM  (-105)
+#define APP_TX_POWER_CSS_SNR_MIN_DB       (-17)
+
+// Uplink margin kept above the threshold, covers fading and link asymmetry
+#ifndef APP_TX_POWER_TARGET_MARGIN_DB
+#define APP_TX_POWER_TARGET_MARGIN_DB   (10)
+#endif
+// Power lowered by one step after this many downlinks with room for it
+#define APP_TX_POWER_STEP_DB            (2)
+#define APP_TX_POWER_GOOD_COUNT         (2U)
+// Power raised on a send error
+#define APP_TX_POWER_ERROR_STEP_DB      (6)
+
+typedef struct {
+  int8_t power_dbm;           // Power used by the next uplink
+  int8_t margin_db;           // Uplink margin at that power, from the last downlink
+  bool measured;              // A downlink was seen on the link since boot
+  uint32_t steps_down;        // Power decreases since boot
+  uint32_t steps_up;          // Power increases since boot
+} app_tx_power_stats_t;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to restore the power of each link
+ *
+ * The power is kept in retained memory to hold across EM4, must be called
+ * after app_retained_init(). Links start at their maximum after a power-on.
+ ******************************************************************************/
+void app_tx_power_init(void);
+
+/*******************************************************************************
+ * Function to get the power of the next uplink on a link
+ *
+ * @param[in] link Link type, SID_LINK_TYPE_x
+ *
+ * @returns TX power in dBm
+ ******************************************************************************/
+int8_t app_tx_power_get_dbm(uint32_t link);
+
+/*******************************************************************************
+ * Function to feed the controller with the quality of a downlink
+ *
+ * The path is taken as symmetric: the uplink margin is the downlink margin
+ * less the power the link runs below its maximum. The power is raised at once
+ * when that margin falls below the target, and lowered one step when it stays
+ * a step above the target for APP_TX_POWER_GOOD_COUNT downlinks.
+ *
+ * @param[in] link Link type, SID_LINK_TYPE_x
+ * @param[in] rssi Downlink RSSI in dBm
+ * @param[in] snr Downlink SNR in dB
+ *
+ * @returns #true if the power of the link changed
+ ******************************************************************************/
+bool app_tx_power_on_downlink(uint32_t link, int8_t rssi, int8_t snr);
+
+/*******************************************************************************
+ * Function to raise the power of a link after a send error
+ *
+ * @param[in] link Link type, SID_LINK_TYPE_x
+ *
+ * @returns #true if the power of the link changed
+ ******************************************************************************/
+bool app_tx_power_on_send_error(uint32_t link);
+
+/*******************************************************************************
+ * Function to get the controller state of a link
+ *
+ * @param[in] link Link type, SID_LINK_TYPE_x
+ *
+ * @returns State since boot, NULL for an unknown link
+ ******************************************************************************/
+const app_tx_power_stats_t *app_tx_power_get_stats(uint32_t link);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_TX_POWER_H
@@ -0,0 +1,192 @@
+/***************************************************************************//**
+ * @file
+ * @brief em4_clock.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+
+#include "em_device.h"
+#include "em_cmu.h"
+#include "em_rmu.h"
+#include "app_log.h"
+#include "app_retained.h"
+#include "em4_clock.h"
+#include "em4_hooks.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Retained word: offset from the nominal frequency in units of 10 ppm, a flag
+// set once calibrated and the device time of the calibration in minutes
+#define STATE_OFFSET_SHIFT      (16U)
+#define STATE_OFFSET_UNIT_PPM   (10L)
+#define STATE_CALIBRATED        (1UL << 15)
+#define STATE_MINUTE_MASK       (0x7FFFUL)
+
+#define NOMINAL_MHZ             (EM4_CLOCK_NOMINAL_HZ * 1000UL)
+
+_Static_assert(EM4_CLOCK_TOLERANCE_PPM / STATE_OFFSET_UNIT_PPM <= INT16_MAX, "offset does not fit the retained word");
+_Static_assert((EM4_CLOCK_CALIBRATION_PERIOD_MS / 60000UL) < STATE_MINUTE_MASK, "period does not fit the retained word");
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+static bool calibration_hook(void *context);
+static int32_t measure_offset_ppm(void);
+static void set_offset(int32_t offset_ppm);
+
+// -----------------------------------------------------------------------------
+//                                Global Variables
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+static uint32_t frequency_mhz = NOMINAL_MHZ;
+static int32_t offset_ppm;
+static const em4_hook_t em4_clock_hook = {
+  "calibration", EM4_HOOK_PRIORITY_CALIBRATION, calibration_hook, NULL, NULL
+};
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+
+void em4_clock_init(void)
+{
+#if defined(_CMU_CLKEN1_BURAM_MASK)
+  // Read ahead of app_retained_init(), which enables it as well
+  CMU_ClockEnable(cmuClock_BURAM, true);
+#endif
+  // Only an EM4 wake-up keeps the word, app_retained_init() clears it otherwise
+  uint32_t state = app_retained_get(APP_RETAINED_SLOT_EM4_CLOCK);
+  if ((RMU_ResetCauseGet() & EMU_RSTCAUSE_EM4) != 0 && (state & STATE_CALIBRATED) != 0) {
+    set_offset((int32_t)(int16_t)(state >> STATE_OFFSET_SHIFT) * STATE_OFFSET_UNIT_PPM);
+  } else {
+    set_offset(0);
+  }
+  (void)em4_hooks_register(&em4_clock_hook);
+}
+
+uint32_t em4_clock_ms_to_count(uint32_t ms)
+{
+  return (uint32_t)((((uint64_t)ms * frequency_mhz) + 500000ULL) / 1000000ULL);
+}
+
+uint32_t em4_clock_count_to_ms(uint32_t count)
+{
+  return (uint32_t)((((uint64_t)count * 1000000ULL) + (frequency_mhz / 2U)) / frequency_mhz);
+}
+
+bool em4_clock_calibrate(void)
+{
+#if (EM4_CLOCK_SOURCE == EM4_CLOCK_LFXO)
+  // Crystal, nothing to correct
+  return false;
+#else
+  uint32_t state = app_retained_get(APP_RETAINED_SLOT_EM4_CLOCK);
+  uint32_t minute = (app_retained_now_ms() / 60000UL) & STATE_MINUTE_MASK;
+
+  if ((state & STATE_CALIBRATED) != 0
+      && ((minute - state) & STATE_MINUTE_MASK) < (EM4_CLOCK_CALIBRATION_PERIOD_MS / 60000UL)) {
+    return false;
+  }
+#if defined(_HFXO_STATUS_RDY_MASK)
+  if ((HFXO0->STATUS & _HFXO_STATUS_RDY_MASK) == 0) {
+    // No reference, the next EM4 entry with the radio running tries again
+    return false;
+  }
+#endif
+
+  int32_t measured_ppm = measure_offset_ppm();
+  if (measured_ppm > EM4_CLOCK_TOLERANCE_PPM || measured_ppm < -EM4_CLOCK_TOLERANCE_PPM) {
+    app_log_warning("app: EM4 clock measured %ld ppm off, ignored", (long)measured_ppm);
+    return false;
+  }
+  // Smoothed, the drift follows the temperature slowly
+  set_offset(((state & STATE_CALIBRATED) != 0) ? (3L * offset_ppm + measured_ppm) / 4L : measured_ppm);
+  app_retained_set(APP_RETAINED_SLOT_EM4_CLOCK,
+                   ((uint32_t)(uint16_t)(int16_t)(offset_ppm / STATE_OFFSET_UNIT_PPM) << STATE_OFFSET_SHIFT)
+                   | STATE_CALIBRATED | minute);
+  app_log_info("app: EM4 clock calibrated, measured: %ld ppm, offset: %ld ppm",
+               (long)measured_ppm, (long)offset_ppm);
+  return true;
+#endif
+}
+
+uint32_t em4_clock_get_mhz(void)
+{
+  return frequency_mhz;
+}
+
+int32_t em4_clock_get_offset_ppm(void)
+{
+  return offset_ppm;
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+
+static bool calibration_hook(void *context)
+{
+  (void)context;
+  (void)em4_clock_calibrate();
+  // A missed calibration never holds off EM4
+  return true;
+}
+
+static int32_t measure_offset_ppm(void)
+{
+#if (EM4_CLOCK_SOURCE == EM4_CLOCK_LFRCO)
+  CMU_CalibrateConfig(EM4_CLOCK_CALIBRATION_CYCLES, cmuSelect_LFRCO, cmuSelect_HFXO);
+#else
+  CMU_CalibrateConfig(EM4_CLOCK_CALIBRATION_CYCLES, cmuSelect_ULFRCO, cmuSelect_HFXO);
+#endif
+  CMU_CalibrateStart();
+  // Waits for the end of the count, a few tens of ms
+  uint32_t hfxo_count = CMU_CalibrateCountGet();
+  if (hfxo_count == 0) {
+    return INT32_MAX;
+  }
+
+  // f = f_hfxo * cycles / count, compared to the nominal frequency in ppm
+  uint64_t measured_mhz = ((uint64_t)SystemHFXOClockGet() * EM4_CLOCK_CALIBRATION_CYCLES * 1000ULL) / hfxo_count;
+  return (int32_t)((((int64_t)measured_mhz - (int64_t)NOMINAL_MHZ) * 1000000LL) / (int64_t)NOMINAL_MHZ);
+}
+
+static void set_offset(int32_t ppm)
+{
+  offset_ppm = ppm;
+  frequency_mhz = (uint32_t)(((int64_t)NOMINAL_MHZ * (1000000LL + ppm)) / 1000000LL);
+}
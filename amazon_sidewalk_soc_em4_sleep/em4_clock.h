@@ -0,0 +1,82 @@
+/***************************************************************************//**
+ * @file
+ * @brief em4_clock.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef EM4_CLOCK_H
+#define EM4_CLOCK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Oscillators that keep the BURTC running in EM4. The LFXO needs a crystal on
+// the board and no calibration, the RC oscillators are measured against the
+// HFXO while the device is awake.
+#define EM4_CLOCK_ULFRCO              0
+#define EM4_CLOCK_LFRCO               1
+#define EM4_CLOCK_LFXO                2
+#ifndef EM4_CLOCK_SOURCE
+#define EM4_CLOCK_SOURCE              EM4_CLOCK_ULFRCO
+#endif
+
+#if (EM4_CLOCK_SOURCE == EM4_CLOCK_ULFRCO)
+#define EM4_CLOCK_NOMINAL_HZ          1000UL
+// Cycles measured per calibration, the HFXO count must fit the 20-bit counter
+#define EM4_CLOCK_CALIBRATION_CYCLES  20UL
+#else
+#define EM4_CLOCK_NOMINAL_HZ          32768UL
+#define EM4_CLOCK_CALIBRATION_CYCLES  512UL
+#endif
+// A measurement further off the nominal frequency is taken as a fault
+#define EM4_CLOCK_TOLERANCE_PPM       200000L
+// Time between two calibrations, counted in device time
+#ifndef EM4_CLOCK_CALIBRATION_PERIOD_MS
+#define EM4_CLOCK_CALIBRATION_PERIOD_MS (60UL * 60UL * 1000UL)
+#endif
+
+// Restores the calibration, before app_retained_init() as the time slept is
+// converted first. Registers the calibration hook.
+void em4_clock_init(void);
+// Conversions between BURTC counts and ms at the calibrated frequency
+uint32_t em4_clock_ms_to_count(uint32_t ms);
+uint32_t em4_clock_count_to_ms(uint32_t count);
+// Measures the oscillator against the HFXO if the period is over, returns
+// true if the calibration was updated
+bool em4_clock_calibrate(void);
+// Calibrated frequency in mHz and its offset from the nominal one in ppm
+uint32_t em4_clock_get_mhz(void);
+int32_t em4_clock_get_offset_ppm(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EM4_CLOCK_H
@@ -0,0 +1,189 @@
+/***************************************************************************//**
+ * @file
+ * @brief em4_hooks.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+
+#include <stddef.h>
+#include "em_device.h"
+#include "app_log.h"
+#include "app_retained.h"
+#include "em4_hooks.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Hook times in us, two per retained word
+#define HOOK_SLOT(index)      (APP_RETAINED_SLOT_EM4_HOOKS_US + ((index) / 2U))
+#define HOOK_SHIFT(index)     (((index) % 2U) * 16U)
+
+_Static_assert(EM4_HOOKS_REPORTED <= 2U * (APP_RETAINED_SLOT_EM4_HOOKS_US_LAST - APP_RETAINED_SLOT_EM4_HOOKS_US + 1U),
+               "not enough retained words for the hook times");
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+static void cycles_start(void);
+static uint32_t cycles_get(void);
+static uint32_t cycles_to_us(uint32_t cycles, uint32_t clock_hz);
+static uint32_t run_hook(em4_hook_fn_t fn, void *context, bool *ok);
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+// Sorted by priority, equal priorities in registration order
+static const em4_hook_t *hooks[EM4_HOOKS_MAX];
+static uint32_t hook_count;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+
+bool em4_hooks_register(const em4_hook_t *hook)
+{
+  if (hook == NULL || hook_count >= EM4_HOOKS_MAX) {
+    app_log_error("app: EM4 hook registry full");
+    return false;
+  }
+
+  uint32_t i = hook_count;
+  while (i > 0 && hooks[i - 1]->priority > hook->priority) {
+    hooks[i] = hooks[i - 1];
+    i--;
+  }
+  hooks[i] = hook;
+  hook_count++;
+
+  return true;
+}
+
+bool em4_hooks_suspend(void)
+{
+  uint32_t total_us = 0;
+
+  cycles_start();
+  for (uint32_t i = 0; i < hook_count; i++) {
+    bool ok = true;
+    uint32_t us = run_hook(hooks[i]->suspend, hooks[i]->context, &ok);
+
+    total_us += us;
+    if (i < EM4_HOOKS_REPORTED) {
+      uint32_t word = app_retained_get(HOOK_SLOT(i)) & ~(0xFFFFUL << HOOK_SHIFT(i));
+      app_retained_set(HOOK_SLOT(i), word | ((us > UINT16_MAX ? UINT16_MAX : us) << HOOK_SHIFT(i)));
+    }
+    if (!ok) {
+      app_log_error("app: EM4 entry aborted by %s", hooks[i]->name);
+      app_retained_set(APP_RETAINED_SLOT_EM4_HOOKS_RUN, 0);
+      return false;
+    }
+    // The last hooks run with the clocks and the logs off, kept for the next boot
+    app_retained_set(APP_RETAINED_SLOT_EM4_HOOKS_RUN, i + 1U);
+  }
+  app_retained_set(APP_RETAINED_SLOT_EM4_HOOKS_TOTAL_US, total_us);
+
+  return true;
+}
+
+void em4_hooks_resume(void)
+{
+  uint32_t run = app_retained_get(APP_RETAINED_SLOT_EM4_HOOKS_RUN);
+
+  if (app_retained_is_em4_wake() && run != 0) {
+    app_log_info("app: EM4 entry took %lu us",
+                 (unsigned long)app_retained_get(APP_RETAINED_SLOT_EM4_HOOKS_TOTAL_US));
+    for (uint32_t i = 0; i < run && i < hook_count && i < EM4_HOOKS_REPORTED; i++) {
+      app_log_info("app:   suspend %s: %lu us",
+                   hooks[i]->name,
+                   (unsigned long)((app_retained_get(HOOK_SLOT(i)) >> HOOK_SHIFT(i)) & 0xFFFFU));
+    }
+  }
+  app_retained_set(APP_RETAINED_SLOT_EM4_HOOKS_RUN, 0);
+
+  cycles_start();
+  for (uint32_t i = hook_count; i > 0; i--) {
+    if (hooks[i - 1]->resume == NULL) {
+      continue;
+    }
+    bool ok = true;
+    uint32_t us = run_hook(hooks[i - 1]->resume, hooks[i - 1]->context, &ok);
+    app_log_info("app:   resume %s: %lu us%s", hooks[i - 1]->name, (unsigned long)us, ok ? "" : ", failed");
+  }
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+
+static void cycles_start(void)
+{
+#if defined(DWT_CTRL_CYCCNTENA_Msk)
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+static uint32_t cycles_get(void)
+{
+#if defined(DWT_CTRL_CYCCNTENA_Msk)
+  return DWT->CYCCNT;
+#else
+  return 0;
+#endif
+}
+
+static uint32_t cycles_to_us(uint32_t cycles, uint32_t clock_hz)
+{
+  if (clock_hz == 0) {
+    return 0;
+  }
+  return (uint32_t)(((uint64_t)cycles * 1000000U) / clock_hz);
+}
+
+static uint32_t run_hook(em4_hook_fn_t fn, void *context, bool *ok)
+{
+  if (fn == NULL) {
+    return 0;
+  }
+
+  // A hook switching clocks is counted at the clock it started with
+#if defined(DWT_CTRL_CYCCNTENA_Msk)
+  uint32_t clock_hz = SystemCoreClockGet();
+#else
+  uint32_t clock_hz = 0;
+#endif
+  uint32_t start = cycles_get();
+  *ok = fn(context);
+
+  return cycles_to_us(cycles_get() - start, clock_hz);
+}
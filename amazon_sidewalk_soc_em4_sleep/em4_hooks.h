@@ -0,0 +1,80 @@
+/***************************************************************************//**
+ * @file
+ * @brief em4_hooks.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef EM4_HOOKS_H
+#define EM4_HOOKS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Registered hooks, the times of the first EM4_HOOKS_REPORTED are kept
+// across EM4
+#define EM4_HOOKS_MAX                 12
+#define EM4_HOOKS_REPORTED            8
+
+// Suspend order, low first. Resume runs the other way round.
+#define EM4_HOOK_PRIORITY_CALIBRATION 5   // Sleep clock measured while the HFXO runs
+#define EM4_HOOK_PRIORITY_STACK       10  // Sidewalk stack stopped
+#define EM4_HOOK_PRIORITY_RADIO       20  // Transceiver put to sleep
+#define EM4_HOOK_PRIORITY_STACK_DEINIT 30 // Sidewalk stack de-initialized
+#define EM4_HOOK_PRIORITY_SENSORS     40  // Sensors and other peripherals
+#define EM4_HOOK_PRIORITY_STATE       50  // State saved for the next boot
+#define EM4_HOOK_PRIORITY_PINS        80  // GPIO set for EM4
+#define EM4_HOOK_PRIORITY_CLOCKS      90  // High frequency clocks off
+#define EM4_HOOK_PRIORITY_EMU         100 // EM4 configured, nothing runs after
+
+// Hook, returns false to abort the EM4 entry, the hooks already run are not
+// undone
+typedef bool (*em4_hook_fn_t)(void *context);
+
+typedef struct {
+  const char *name;
+  uint8_t priority;
+  em4_hook_fn_t suspend;  // Before EM4, NULL if none
+  em4_hook_fn_t resume;   // At boot from em4_hooks_resume(), NULL if none
+  void *context;
+} em4_hook_t;
+
+// Adds a hook, kept by reference. Returns false when the registry is full.
+bool em4_hooks_register(const em4_hook_t *hook);
+// Runs the suspend hooks and keeps their times, returns false if one failed
+bool em4_hooks_suspend(void);
+// Runs the resume hooks and prints their times and those of the last EM4
+// entry, after app_retained_init()
+void em4_hooks_resume(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EM4_HOOKS_H
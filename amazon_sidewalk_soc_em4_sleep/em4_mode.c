@@ -36,8 +36,12 @@
 #include "em_gpio.h"
 #include "em_emu.h"
 #include "em_cmu.h"
+#include "em_rmu.h"
 #include "app_log.h"
 #include "em4_mode.h"
+#include "em4_pins.h"
+#include "em4_hooks.h"
+#include "em4_clock.h"
 #include "app_process.h"
 #include "app_gpio_config.h"
 
@@ -53,6 +57,9 @@ static void disable_HF_clocks(void);
 static void init_BURTC(void);
 static void set_burtc_clk(void);
 static void init_EM4(void);
+static bool pins_hook(void *context);
+static bool clocks_hook(void *context);
+static bool emu_hook(void *context);
 
 // -----------------------------------------------------------------------------
 //                                Global Variables
@@ -62,6 +69,17 @@ static void init_EM4(void);
 //                                Static Variables
 // -----------------------------------------------------------------------------
 
+// Time spent in EM4 before this boot
+static uint32_t last_sleep_ms;
+// A pin of the EM4 table must hold its state
+static bool pin_retention;
+// Last steps of the EM4 entry, after those of the application
+static const em4_hook_t em4_mode_hooks[] = {
+  { "pins", EM4_HOOK_PRIORITY_PINS, pins_hook, NULL, NULL },
+  { "clocks", EM4_HOOK_PRIORITY_CLOCKS, clocks_hook, NULL, NULL },
+  { "emu", EM4_HOOK_PRIORITY_EMU, emu_hook, NULL, NULL },
+};
+
 // -----------------------------------------------------------------------------
 //                          Public Function Definitions
 // -----------------------------------------------------------------------------
@@ -138,7 +156,7 @@ static void init_BURTC(void)
 
   BURTC_Stop(); // Stop the counter, we will start it when we need it
   BURTC_SyncWait(); // Wait for the stop to synchronize
-  BURTC_CompareSet(0, BURTC_COUNT_BETWEEN_WAKEUP);
+  BURTC_CompareSet(0, em4_clock_ms_to_count(WAKEUP_INTERVAL_MS) - 1);
 
   // Enable compare interrupt flag
   BURTC_IntEnable(BURTC_IF_COMP);
@@ -152,8 +170,14 @@ static void init_BURTC(void)
 static void set_burtc_clk(void)
 {
   // Select reference clock/oscillator for the desired clock branch (BURTC Clk).
-  // Reference selected for clocking: ULFRCO
+  // Reference selected for clocking: EM4_CLOCK_SOURCE, ULFRCO by default
+#if (EM4_CLOCK_SOURCE == EM4_CLOCK_LFXO)
+  CMU_ClockSelectSet(cmuClock_EM4GRPACLK, cmuSelect_LFXO);
+#elif (EM4_CLOCK_SOURCE == EM4_CLOCK_LFRCO)
+  CMU_ClockSelectSet(cmuClock_EM4GRPACLK, cmuSelect_LFRCO);
+#else
   CMU_ClockSelectSet(cmuClock_EM4GRPACLK, cmuSelect_ULFRCO);
+#endif
   // Enable BURTC Clk
   CMU_ClockEnable(cmuClock_BURTC, true);
 }
@@ -172,48 +196,84 @@ void start_burtc_timeout(void)
   BURTC_SyncWait(); // Wait for the start to synchronize
 }
 
-void init_GPIO_EM4(void)
+void set_em4_sleep_duration(uint32_t sleep_ms)
 {
-  // Configure Button PB1 as input and EM4 wake-on pin source
-  GPIO_PinModeSet(SL_SIMPLE_BUTTON_EM4WU_PORT, SL_SIMPLE_BUTTON_EM4WU_PIN, gpioModeInput, 1);
-  // Enable EM4 wake-up from GPIO pin (BTN1)
-  GPIO_EM4EnablePinWakeup(GPIO_IEN_EM4WUIEN4, 0);
-#if defined(SL_RADIO_EXTERNAL)
-  // Configure SPIDRV CS pin in pull mode so it stays high when going to EM4 (this keeps the Semtech chip in sleep mode)
-  GPIO_PinModeSet(SL_SX_CS_PIN, SL_SX_CS_PORT, gpioModeInputPull, 1);
+  // init_BURTC() restores the wake-up interval at boot
+  if (sleep_ms > EM4_SLEEP_MAX_MS) {
+    sleep_ms = EM4_SLEEP_MAX_MS;
+  }
+  uint32_t count = em4_clock_ms_to_count(sleep_ms);
+  if (count == 0) {
+    count = 1;
+  }
+  // Restart from 0 so that a shorter compare does not match right away
+  BURTC_CounterReset();
+  BURTC_SyncWait();
+  BURTC_CompareSet(0, count - 1);
+  BURTC_IntClear(BURTC_IF_COMP);
+}
 
-  GPIO_PinModeSet(SL_ANTSW_PORT, SL_ANTSW_PIN, gpioModeDisabled, 0);
-#endif
+void set_em4_awake_timeout(uint32_t awake_ms)
+{
+  // Inactivity before EM4, counted from the next start or reset of the BURTC
+  if (awake_ms > EM4_SLEEP_MAX_MS) {
+    awake_ms = EM4_SLEEP_MAX_MS;
+  }
+  uint32_t count = em4_clock_ms_to_count(awake_ms);
+  if (count == 0) {
+    count = 1;
+  }
+  BURTC_CompareSet(0, count - 1);
+}
+
+void init_GPIO_EM4(void)
+{
+  // Every pin as set in the EM4 table of the board, the wake-up button (BTN1)
+  // as EM4 wake-on pin source and the other pins disabled
+  pin_retention = em4_pins_apply();
 }
 
 static void init_EM4(void)
 {
   EMU_EM4Init_TypeDef em4Init = EMU_EM4INIT_DEFAULT;
-#if defined(SL_RADIO_EXTERNAL)
-  em4Init.pinRetentionMode = EMU_EM4CTRL_EM4IORETMODE_EM4EXIT;
-#endif
+  // Keeps the chip selects pulled high and the board power switches off
+  if (pin_retention) {
+    em4Init.pinRetentionMode = EMU_EM4CTRL_EM4IORETMODE_EM4EXIT;
+  }
   EMU_EM4Init(&em4Init);
 }
 
 void init_peripheral_for_EM4(void)
 {
-  //Select ULFRCO as the BURTC clock source.
+  //Select the BURTC clock source and restore its calibration.
   set_burtc_clk();
+  em4_clock_init();
+  // The counter was reset right before entering EM4 and wrapped on the compare
+  // match if the timer woke us up.
+  if (RMU_ResetCauseGet() & EMU_RSTCAUSE_EM4) {
+    uint32_t count = BURTC_CounterGet();
+    if (BURTC_IntGet() & BURTC_IF_COMP) {
+      count += BURTC_CompareGet(0) + 1;
+    }
+    last_sleep_ms = em4_clock_count_to_ms(count);
+  }
+  BURTC_IntClear(BURTC_IF_COMP);
   //Initialize BURTC.
   init_BURTC();
+
+  for (uint32_t i = 0; i < sizeof(em4_mode_hooks) / sizeof(em4_mode_hooks[0]); i++) {
+    (void)em4_hooks_register(&em4_mode_hooks[i]);
+  }
 }
 
-void em_EM4_ULfrcoBURTC(void)
+uint32_t em4_get_last_sleep_ms(void)
 {
-  //Enable GPIO for EM4 wake-up
-  init_GPIO_EM4();
-
-  app_log_info("app: Going to EM4");
-
-  // Make sure clocks are disabled.
-  disable_HF_clocks();
+  return last_sleep_ms;
+}
 
-  init_EM4();
+void em_EM4_ULfrcoBURTC(void)
+{
+  // The pins, clocks and EMU were set by the suspend hooks, see em4_hooks.h
 
   // Reset BURTC timer before going to sleep to ensure we start at 0.
   BURTC_CounterReset();
@@ -222,3 +282,28 @@ void em_EM4_ULfrcoBURTC(void)
   // Enter EM4.
   EMU_EnterEM4();
 }
+
+static bool pins_hook(void *context)
+{
+  (void)context;
+  app_log_info("app: Going to EM4");
+
+  //Set the pins for EM4 and enable GPIO for EM4 wake-up, after the last log
+  init_GPIO_EM4();
+  return true;
+}
+
+static bool clocks_hook(void *context)
+{
+  (void)context;
+  // Make sure clocks are disabled.
+  disable_HF_clocks();
+  return true;
+}
+
+static bool emu_hook(void *context)
+{
+  (void)context;
+  init_EM4();
+  return true;
+}
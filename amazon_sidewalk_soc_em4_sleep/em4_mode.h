@@ -37,9 +37,9 @@ extern "C" {
 //#define SL_SIMPLE_BUTTON_EM4WU_MODE       SL_SIMPLE_BUTTON_MODE_INTERRUPT
 #define SL_SIMPLE_BUTTON_EM4WU_PORT       gpioPortB
 #define SL_SIMPLE_BUTTON_EM4WU_PIN        3
-#define ULFRCO_FREQUENCY                  1000
 #define WAKEUP_INTERVAL_MS                30000 // 30 seconds
-#define BURTC_COUNT_BETWEEN_WAKEUP        (((ULFRCO_FREQUENCY * WAKEUP_INTERVAL_MS) / 1000) -1)
+// Longest EM4 sleep, the battery tiers stretch the wake-up interval up to it
+#define EM4_SLEEP_MAX_MS                  (60UL * 60UL * 1000UL)
 
 void em_EM4_ULfrcoBURTC(void);
 void init_peripheral_for_EM4(void);
@@ -47,6 +47,9 @@ void init_GPIO_EM4(void);
 void BURTC_IRQHandler(void);
 void reset_burtc_timer(void);
 void start_burtc_timeout(void);
+void set_em4_sleep_duration(uint32_t sleep_ms);
+void set_em4_awake_timeout(uint32_t awake_ms);
+uint32_t em4_get_last_sleep_ms(void);
 
 #ifdef __cplusplus
 }
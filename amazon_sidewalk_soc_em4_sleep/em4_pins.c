@@ -0,0 +1,237 @@
+/***************************************************************************//**
+ * @file
+ * @brief em4_pins.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+
+#include "em_device.h"
+#include "em_gpio.h"
+#include "em4_pins.h"
+#include "em4_mode.h"
+#include "app_gpio_config.h"
+#if defined(__has_include)
+#if __has_include("sl_board_control_config.h")
+#include "sl_board_control_config.h"
+#endif
+#if __has_include("sl_mx25_flash_shutdown_eusart_config.h")
+#include "sl_mx25_flash_shutdown_eusart_config.h"
+#elif __has_include("sl_mx25_flash_shutdown_usart_config.h")
+#include "sl_mx25_flash_shutdown_usart_config.h"
+#endif
+#endif
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// EM4WU index plus one of a pin, 0 if it is not EM4WU<n>, from the part header
+#define EM4WU_IS(n, port, pin) \
+  ((GPIO_EM4WU##n##_PORT == (port) && GPIO_EM4WU##n##_PIN == (pin)) ? ((n) + 1) : 0)
+
+#if defined(GPIO_EM4WU0_PORT)
+#define EM4WU_0(port, pin)    EM4WU_IS(0, port, pin)
+#else
+#define EM4WU_0(port, pin)    0
+#endif
+#if defined(GPIO_EM4WU1_PORT)
+#define EM4WU_1(port, pin)    EM4WU_IS(1, port, pin)
+#else
+#define EM4WU_1(port, pin)    0
+#endif
+#if defined(GPIO_EM4WU2_PORT)
+#define EM4WU_2(port, pin)    EM4WU_IS(2, port, pin)
+#else
+#define EM4WU_2(port, pin)    0
+#endif
+#if defined(GPIO_EM4WU3_PORT)
+#define EM4WU_3(port, pin)    EM4WU_IS(3, port, pin)
+#else
+#define EM4WU_3(port, pin)    0
+#endif
+#if defined(GPIO_EM4WU4_PORT)
+#define EM4WU_4(port, pin)    EM4WU_IS(4, port, pin)
+#else
+#define EM4WU_4(port, pin)    0
+#endif
+#if defined(GPIO_EM4WU5_PORT)
+#define EM4WU_5(port, pin)    EM4WU_IS(5, port, pin)
+#else
+#define EM4WU_5(port, pin)    0
+#endif
+#if defined(GPIO_EM4WU6_PORT)
+#define EM4WU_6(port, pin)    EM4WU_IS(6, port, pin)
+#else
+#define EM4WU_6(port, pin)    0
+#endif
+#if defined(GPIO_EM4WU7_PORT)
+#define EM4WU_7(port, pin)    EM4WU_IS(7, port, pin)
+#else
+#define EM4WU_7(port, pin)    0
+#endif
+#if defined(GPIO_EM4WU8_PORT)
+#define EM4WU_8(port, pin)    EM4WU_IS(8, port, pin)
+#else
+#define EM4WU_8(port, pin)    0
+#endif
+#if defined(GPIO_EM4WU9_PORT)
+#define EM4WU_9(port, pin)    EM4WU_IS(9, port, pin)
+#else
+#define EM4WU_9(port, pin)    0
+#endif
+#if defined(GPIO_EM4WU10_PORT)
+#define EM4WU_10(port, pin)   EM4WU_IS(10, port, pin)
+#else
+#define EM4WU_10(port, pin)   0
+#endif
+#if defined(GPIO_EM4WU11_PORT)
+#define EM4WU_11(port, pin)   EM4WU_IS(11, port, pin)
+#else
+#define EM4WU_11(port, pin)   0
+#endif
+
+// EM4WU index of a pin, -1 if it cannot wake the device from EM4
+#define EM4WU_INDEX(port, pin)                                            \
+  (EM4WU_0(port, pin) + EM4WU_1(port, pin) + EM4WU_2(port, pin)           \
+   + EM4WU_3(port, pin) + EM4WU_4(port, pin) + EM4WU_5(port, pin)         \
+   + EM4WU_6(port, pin) + EM4WU_7(port, pin) + EM4WU_8(port, pin)         \
+   + EM4WU_9(port, pin) + EM4WU_10(port, pin) + EM4WU_11(port, pin) - 1)
+
+// Table entry for the pin configured as <name>_PORT and <name>_PIN.
+// tools/em4_pins_check.py reads these lines, keep one entry per line.
+#define EM4_PIN(name, mode, out, flags) \
+  { name##_PORT, name##_PIN, mode, out, flags, EM4WU_INDEX(name##_PORT, name##_PIN) }
+
+_Static_assert(EM4WU_INDEX(SL_SIMPLE_BUTTON_EM4WU_PORT, SL_SIMPLE_BUTTON_EM4WU_PIN) >= 0,
+               "the EM4 wake-up button is not on an EM4WU pin");
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+static bool is_debug_pin(GPIO_Port_TypeDef port, uint8_t pin);
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+static const em4_pin_t em4_pins[] = {
+  // Button waking the device, pulled up on the board, glitch filter on
+  EM4_PIN(SL_SIMPLE_BUTTON_EM4WU, gpioModeInput, 1, EM4_PIN_WAKE | EM4_PIN_EXT_PULL),
+#if defined(SL_RADIO_EXTERNAL)
+  // SX126x chip select held high, a low level wakes the radio up
+  EM4_PIN(SL_SX_CS, gpioModeInputPull, 1, EM4_PIN_RETAIN),
+  EM4_PIN(SL_ANTSW, gpioModeDisabled, 0, 0),
+#endif
+#if defined(SL_MX25_FLASH_SHUTDOWN_CS_PORT)
+  // SPI flash chip select held high, the flash stays in deep power-down
+  EM4_PIN(SL_MX25_FLASH_SHUTDOWN_CS, gpioModeInputPull, 1, EM4_PIN_RETAIN),
+#endif
+#if defined(SL_BOARD_ENABLE_VCOM_PORT)
+  // Board power switches off
+  EM4_PIN(SL_BOARD_ENABLE_VCOM, gpioModePushPull, 0, EM4_PIN_RETAIN),
+#endif
+#if defined(SL_BOARD_ENABLE_SENSOR_RHT_PORT)
+  EM4_PIN(SL_BOARD_ENABLE_SENSOR_RHT, gpioModePushPull, 0, EM4_PIN_RETAIN),
+#endif
+#if defined(SL_BOARD_ENABLE_SENSOR_IMU_PORT)
+  EM4_PIN(SL_BOARD_ENABLE_SENSOR_IMU, gpioModePushPull, 0, EM4_PIN_RETAIN),
+#endif
+#if defined(SL_BOARD_ENABLE_SENSOR_MICROPHONE_PORT)
+  EM4_PIN(SL_BOARD_ENABLE_SENSOR_MICROPHONE, gpioModePushPull, 0, EM4_PIN_RETAIN),
+#endif
+};
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+
+const em4_pin_t *em4_pins_get(uint32_t *count)
+{
+  *count = sizeof(em4_pins) / sizeof(em4_pins[0]);
+  return em4_pins;
+}
+
+bool em4_pins_apply(void)
+{
+  uint32_t wake_mask = 0;
+  uint32_t wake_polarity = 0;
+  bool retain = false;
+
+  // Disabled pins neither float nor leak, the debug pins are left alone
+  for (uint32_t port = 0; port <= GPIO_PORT_MAX; port++) {
+    if (!GPIO_PORT_VALID(port)) {
+      continue;
+    }
+    for (uint8_t pin = 0; pin <= GPIO_PIN_MAX; pin++) {
+      if (GPIO_PORT_PIN_VALID(port, pin) && !is_debug_pin((GPIO_Port_TypeDef)port, pin)) {
+        GPIO_PinModeSet((GPIO_Port_TypeDef)port, pin, gpioModeDisabled, 0);
+      }
+    }
+  }
+
+  for (uint32_t i = 0; i < sizeof(em4_pins) / sizeof(em4_pins[0]); i++) {
+    const em4_pin_t *entry = &em4_pins[i];
+    GPIO_PinModeSet(entry->port, entry->pin, entry->mode, entry->out);
+    if ((entry->flags & EM4_PIN_WAKE) != 0 && entry->em4wu >= 0) {
+      wake_mask |= 1UL << (entry->em4wu + _GPIO_IEN_EM4WUIEN0_SHIFT);
+      if ((entry->flags & EM4_PIN_WAKE_HIGH) != 0) {
+        wake_polarity |= 1UL << (entry->em4wu + _GPIO_IEN_EM4WUIEN0_SHIFT);
+      }
+    }
+    retain |= (entry->flags & EM4_PIN_RETAIN) != 0;
+  }
+  GPIO_EM4EnablePinWakeup(wake_mask, wake_polarity);
+
+  return retain;
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+
+static bool is_debug_pin(GPIO_Port_TypeDef port, uint8_t pin)
+{
+  bool debug = false;
+
+#if defined(GPIO_SWCLK_PORT)
+  debug |= (port == GPIO_SWCLK_PORT && pin == GPIO_SWCLK_PIN);
+#endif
+#if defined(GPIO_SWDIO_PORT)
+  debug |= (port == GPIO_SWDIO_PORT && pin == GPIO_SWDIO_PIN);
+#endif
+#if defined(GPIO_SWV_PORT)
+  debug |= (port == GPIO_SWV_PORT && pin == GPIO_SWV_PIN);
+#endif
+  (void)port;
+  (void)pin;
+
+  return debug;
+}
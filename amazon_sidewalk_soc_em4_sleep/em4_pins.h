@@ -0,0 +1,67 @@
+/***************************************************************************//**
+ * @file
+ * @brief em4_pins.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef EM4_PINS_H
+#define EM4_PINS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_gpio.h"
+
+// Pin flags
+#define EM4_PIN_WAKE          (1U << 0) // EM4 wake-up source, wakes on low
+#define EM4_PIN_WAKE_HIGH     (1U << 1) // With EM4_PIN_WAKE, wakes on high
+#define EM4_PIN_RETAIN        (1U << 2) // The pin state must hold through EM4
+#define EM4_PIN_EXT_PULL      (1U << 3) // Input pulled on the board, not floating
+
+// EM4 setting of a pin, every pin not in the table is disabled
+typedef struct {
+  GPIO_Port_TypeDef port;
+  uint8_t pin;
+  GPIO_Mode_TypeDef mode;
+  uint8_t out;      // DOUT: pull direction, output level or input filter
+  uint8_t flags;
+  int8_t em4wu;     // EM4WU index of the pin, -1 if it has none
+} em4_pin_t;
+
+// Table of this board, built from its pin configuration
+const em4_pin_t *em4_pins_get(uint32_t *count);
+// Sets every pin for EM4 and the wake-up sources, returns true if pin
+// retention is needed
+bool em4_pins_apply(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EM4_PINS_H
@@ -0,0 +1,536 @@
+/***************************************************************************//**
+ * @file
+ * @brief host_fleet.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+// Runs many devices against shared gateways. The virtual clock advances in
+// epochs: the boots starting in an epoch are independent of each other and
+// run in parallel, each in a forked process, the worker threads waiting for
+// them steal boots from each other to stay busy. A boot runs to its end
+// (EM4 or reset) once started, so boots of the same epoch see each other's
+// transmissions in the order they reach the gateway model. An uplink that a
+// later transmission collides with is counted as a late collision: it was
+// reported sent to its device, it is not counted as received.
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "em_device.h"
+#include "sid_api.h"
+#include "app_airtime.h"
+#include "host_fleet.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+typedef enum {
+  TX_RECEIVED = 1,
+  TX_COLLIDED,
+  TX_OVER_CAPACITY,
+} tx_state_t;
+
+typedef struct {
+  uint64_t start_us;
+  uint64_t end_us;
+  uint8_t channel;
+  uint8_t state;
+} fleet_tx_t;
+
+// Shared by the boots of all devices, locked by the boot using it
+typedef struct {
+  atomic_flag lock;
+  uint32_t head;
+  fleet_tx_t ring[HOST_FLEET_GATEWAY_RING];
+} fleet_gateway_t;
+
+typedef struct {
+  atomic_uint_fast64_t on_air;
+  atomic_uint_fast64_t received;
+  atomic_uint_fast64_t collided;
+  atomic_uint_fast64_t over_capacity;
+  atomic_uint_fast64_t late_collisions;
+} fleet_channel_stats_t;
+
+// Boots of one worker, the owner takes from the tail and thieves from the head
+typedef struct {
+  pthread_mutex_t lock;
+  uint32_t *items;
+  uint32_t head;
+  uint32_t tail;
+} fleet_deque_t;
+
+typedef enum {
+  DEVICE_RUNNING = 0,
+  DEVICE_ENDED,
+  DEVICE_HALTED,
+  DEVICE_CRASHED,
+} device_state_t;
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Worker thread, runs the boots of an epoch until none is left
+ *
+ * @param[in] arg Worker index
+ ******************************************************************************/
+static void *worker_main(void *arg);
+
+/*******************************************************************************
+ * Function to take a boot from a worker's deque
+ *
+ * @param[in] deque Deque
+ * @param[in] own Taken by the owner, from the tail
+ * @param[out] device Device to boot
+ *
+ * @returns #false if the deque is empty
+ ******************************************************************************/
+static bool deque_take(fleet_deque_t *deque, bool own, uint32_t *device);
+
+/*******************************************************************************
+ * Function to run one boot of a device and collect its outcome
+ *
+ * @param[in] device Device
+ ******************************************************************************/
+static void run_device(uint32_t device);
+
+/*******************************************************************************
+ * Function to map the shared memory of the fleet
+ *
+ * @param[in] size Bytes
+ *
+ * @returns Zeroed memory, NULL on error
+ ******************************************************************************/
+static void *map_shared(size_t size);
+
+/*******************************************************************************
+ * Function to estimate the energy a device used
+ *
+ * @param[in] stats Device statistics
+ *
+ * @returns Energy in mJ
+ ******************************************************************************/
+static double device_energy_mj(const host_stats_t *stats);
+
+/*******************************************************************************
+ * Function to order doubles for qsort()
+ ******************************************************************************/
+static int compare_double(const void *a, const void *b);
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+static host_fleet_config_t fleet;
+static host_fleet_boot_t fleet_boot;
+static host_world_t *worlds;
+static fleet_gateway_t *gateways;
+static fleet_channel_stats_t *channel_stats;
+static uint8_t *device_state;
+static uint32_t *due;
+static fleet_deque_t *deques;
+static pthread_barrier_t epoch_start;
+static pthread_barrier_t epoch_done;
+static bool stopping;
+static atomic_uint_fast32_t boots_run;
+// Device of the boot running in this process, set after the fork
+static uint32_t current_device;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+bool host_fleet_run(const host_fleet_config_t *config, host_fleet_boot_t boot)
+{
+  fleet = *config;
+  fleet_boot = boot;
+  if (fleet.workers == 0) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    fleet.workers = (cores > 0) ? (uint32_t)cores : 1U;
+  }
+  if (fleet.gateways == 0) {
+    fleet.gateways = (fleet.devices + HOST_FLEET_DEVICES_PER_GATEWAY - 1U) / HOST_FLEET_DEVICES_PER_GATEWAY;
+  }
+  if (fleet.channels == 0 || fleet.demodulators == 0 || fleet.devices == 0) {
+    fprintf(stderr, "fleet: devices, channels and demodulators must be non zero\n");
+    return false;
+  }
+
+  worlds = map_shared(sizeof(*worlds) * fleet.devices);
+  gateways = map_shared(sizeof(*gateways) * fleet.gateways);
+  channel_stats = map_shared(sizeof(*channel_stats));
+  device_state = calloc(fleet.devices, sizeof(*device_state));
+  due = calloc(fleet.devices, sizeof(*due));
+  deques = calloc(fleet.workers, sizeof(*deques));
+  if (worlds == NULL || gateways == NULL || channel_stats == NULL
+      || device_state == NULL || due == NULL || deques == NULL) {
+    fprintf(stderr, "fleet: out of memory for %lu devices\n", (unsigned long)fleet.devices);
+    return false;
+  }
+
+  for (uint32_t device = 0; device < fleet.devices; device++) {
+    host_world_t *world = &worlds[device];
+    // Distinct and never zero, reproducible with the seed
+    world->rng = (fleet.seed * 0x9E3779B97F4A7C15ULL) ^ ((uint64_t)(device + 1U) << 1) ^ 1U;
+    world->now_ms = (uint32_t)((world->rng >> 17) % HOST_FLEET_POWER_ON_MS);
+    world->end_ms = fleet.end_ms;
+    world->reset_cause = EMU_RSTCAUSE_POR;
+    world->network_registered = fleet.registered;
+  }
+  for (uint32_t gateway = 0; gateway < fleet.gateways; gateway++) {
+    atomic_flag_clear(&gateways[gateway].lock);
+  }
+
+  pthread_t *threads = calloc(fleet.workers, sizeof(*threads));
+  if (threads == NULL) {
+    return false;
+  }
+  pthread_barrier_init(&epoch_start, NULL, fleet.workers + 1U);
+  pthread_barrier_init(&epoch_done, NULL, fleet.workers + 1U);
+  for (uint32_t i = 0; i < fleet.workers; i++) {
+    pthread_mutex_init(&deques[i].lock, NULL);
+    deques[i].items = calloc(fleet.devices, sizeof(uint32_t));
+    if (deques[i].items == NULL
+        || pthread_create(&threads[i], NULL, worker_main, (void *)(uintptr_t)i) != 0) {
+      fprintf(stderr, "fleet: cannot start worker %lu\n", (unsigned long)i);
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  // Shared virtual clock, start of the current epoch
+  uint32_t epoch_ms = 0;
+  fflush(NULL);
+  while (epoch_ms < fleet.end_ms) {
+    uint32_t count = 0;
+    uint32_t next_ms = UINT32_MAX;
+    for (uint32_t device = 0; device < fleet.devices; device++) {
+      if (device_state[device] != DEVICE_RUNNING) {
+        continue;
+      }
+      if (worlds[device].now_ms < epoch_ms + HOST_FLEET_EPOCH_MS) {
+        due[count++] = device;
+      } else if (worlds[device].now_ms < next_ms) {
+        next_ms = worlds[device].now_ms;
+      }
+    }
+    if (count == 0) {
+      if (next_ms == UINT32_MAX) {
+        break;
+      }
+      // Nothing due, jump to the epoch of the next boot
+      epoch_ms = next_ms - (next_ms % HOST_FLEET_EPOCH_MS);
+      continue;
+    }
+
+    for (uint32_t i = 0; i < fleet.workers; i++) {
+      deques[i].head = 0;
+      deques[i].tail = 0;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+      fleet_deque_t *deque = &deques[i % fleet.workers];
+      deque->items[deque->tail++] = due[i];
+    }
+    pthread_barrier_wait(&epoch_start);
+    pthread_barrier_wait(&epoch_done);
+    epoch_ms += HOST_FLEET_EPOCH_MS;
+  }
+
+  stopping = true;
+  pthread_barrier_wait(&epoch_start);
+  for (uint32_t i = 0; i < fleet.workers; i++) {
+    pthread_join(threads[i], NULL);
+    free(deques[i].items);
+  }
+  free(threads);
+  return true;
+}
+
+bool host_fleet_channel(sid_emu_link_t link, size_t size, uint16_t mtu)
+{
+  uint32_t airtime_us = app_airtime_estimate_us(1UL << link, size, mtu);
+  host_world->stats.tx_airtime_us[link] += airtime_us;
+  atomic_fetch_add(&channel_stats->on_air, 1U);
+  if (link == SID_EMU_LINK_BLE) {
+    atomic_fetch_add(&channel_stats->received, 1U);
+    return true;
+  }
+
+  fleet_gateway_t *gateway = &gateways[current_device % fleet.gateways];
+  fleet_tx_t tx = {
+    .end_us = (uint64_t)host_sim_now_ms() * 1000U,
+    .channel = (uint8_t)(host_sim_random() % fleet.channels),
+    .state = TX_RECEIVED,
+  };
+  tx.start_us = (tx.end_us > airtime_us) ? tx.end_us - airtime_us : 0U;
+
+  while (atomic_flag_test_and_set_explicit(&gateway->lock, memory_order_acquire)) {
+  }
+  uint32_t receiving = 0;
+  for (uint32_t i = 0; i < HOST_FLEET_GATEWAY_RING; i++) {
+    fleet_tx_t *other = &gateway->ring[i];
+    if (other->state == 0 || other->end_us <= tx.start_us || other->start_us >= tx.end_us) {
+      continue;
+    }
+    receiving++;
+    if (other->channel == tx.channel) {
+      tx.state = TX_COLLIDED;
+      if (other->state == TX_RECEIVED) {
+        // Already reported sent to its device
+        other->state = TX_COLLIDED;
+        atomic_fetch_sub(&channel_stats->received, 1U);
+        atomic_fetch_add(&channel_stats->late_collisions, 1U);
+      }
+    }
+  }
+  if (tx.state == TX_RECEIVED && receiving >= fleet.demodulators) {
+    tx.state = TX_OVER_CAPACITY;
+  }
+  gateway->ring[gateway->head] = tx;
+  gateway->head = (gateway->head + 1U) % HOST_FLEET_GATEWAY_RING;
+  atomic_flag_clear_explicit(&gateway->lock, memory_order_release);
+
+  switch ((tx_state_t)tx.state) {
+    case TX_RECEIVED:
+      atomic_fetch_add(&channel_stats->received, 1U);
+      return true;
+    case TX_COLLIDED:
+      atomic_fetch_add(&channel_stats->collided, 1U);
+      break;
+    case TX_OVER_CAPACITY:
+      atomic_fetch_add(&channel_stats->over_capacity, 1U);
+      break;
+  }
+  return false;
+}
+
+void host_fleet_sum(host_stats_t *total)
+{
+  memset(total, 0, sizeof(*total));
+  for (uint32_t device = 0; device < fleet.devices; device++) {
+    const host_stats_t *stats = &worlds[device].stats;
+    total->boots += stats->boots;
+    total->em4_entries += stats->em4_entries;
+    total->resets += stats->resets;
+    total->awake_ms += stats->awake_ms;
+    total->sleep_ms += stats->sleep_ms;
+    total->triggers += stats->triggers;
+    total->trigger_wakes += stats->trigger_wakes;
+    for (uint32_t link = 0; link < HOST_LINK_COUNT; link++) {
+      total->put[link] += stats->put[link];
+      total->delivered[link] += stats->delivered[link];
+      total->tx_airtime_us[link] += stats->tx_airtime_us[link];
+    }
+    total->put_errors += stats->put_errors;
+    total->delivered_bytes += stats->delivered_bytes;
+    total->sent_callbacks += stats->sent_callbacks;
+    total->error_callbacks += stats->error_callbacks;
+    total->acks_lost += stats->acks_lost;
+    total->retries += stats->retries;
+    total->start_errors += stats->start_errors;
+    total->nvm_writes += stats->nvm_writes;
+    total->below_margin += stats->below_margin;
+    total->downlinks += stats->downlinks;
+    total->first_ready_ms += stats->first_ready_ms;
+    total->ready_boots += stats->ready_boots;
+    total->latency_count += stats->latency_count;
+    total->latency_sum_ms += stats->latency_sum_ms;
+    if (stats->latency_max_ms > total->latency_max_ms) {
+      total->latency_max_ms = stats->latency_max_ms;
+    }
+    if (stats->clock_error_max_ms > total->clock_error_max_ms) {
+      total->clock_error_max_ms = stats->clock_error_max_ms;
+    }
+  }
+}
+
+void host_fleet_print_summary(void)
+{
+  uint32_t states[DEVICE_CRASHED + 1] = { 0 };
+  double *energy = malloc(sizeof(*energy) * fleet.devices);
+  double energy_sum = 0.0;
+  uint64_t time_ms = 0;
+  uint64_t on_air = atomic_load(&channel_stats->on_air);
+  uint64_t received = atomic_load(&channel_stats->received);
+
+  for (uint32_t device = 0; device < fleet.devices; device++) {
+    states[device_state[device]]++;
+    time_ms += worlds[device].stats.awake_ms + worlds[device].stats.sleep_ms;
+    if (energy != NULL) {
+      energy[device] = device_energy_mj(&worlds[device].stats);
+      energy_sum += energy[device];
+    }
+  }
+
+  printf("fleet:          %lu devices, %lu gateways (%u channels, %u demodulators), %lu workers, %lu boots run\n",
+         (unsigned long)fleet.devices,
+         (unsigned long)fleet.gateways,
+         (unsigned int)fleet.channels,
+         (unsigned int)fleet.demodulators,
+         (unsigned long)fleet.workers,
+         (unsigned long)atomic_load(&boots_run));
+  if (states[DEVICE_HALTED] != 0 || states[DEVICE_CRASHED] != 0) {
+    printf("stopped:        %lu halted, %lu crashed\n",
+           (unsigned long)states[DEVICE_HALTED],
+           (unsigned long)states[DEVICE_CRASHED]);
+  }
+  printf("on air:         %llu, received %llu (%.1f%%), collided %llu, over capacity %llu, late collisions %llu\n",
+         (unsigned long long)on_air,
+         (unsigned long long)received,
+         (on_air != 0) ? (100.0 * (double)received / (double)on_air) : 0.0,
+         (unsigned long long)atomic_load(&channel_stats->collided),
+         (unsigned long long)atomic_load(&channel_stats->over_capacity),
+         (unsigned long long)atomic_load(&channel_stats->late_collisions));
+  if (energy != NULL) {
+    qsort(energy, fleet.devices, sizeof(*energy), compare_double);
+    printf("energy/device:  %.1f mJ mean, %.1f mJ p95, %.1f mJ max, %.1f uA mean current\n",
+           energy_sum / (double)fleet.devices,
+           energy[(fleet.devices * 95U) / 100U],
+           energy[fleet.devices - 1U],
+           (time_ms != 0) ? (energy_sum * 1e9 / ((double)fleet.supply_mv * (double)time_ms)) : 0.0);
+    free(energy);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+static void *worker_main(void *arg)
+{
+  uint32_t self = (uint32_t)(uintptr_t)arg;
+
+  for (;;) {
+    pthread_barrier_wait(&epoch_start);
+    if (stopping) {
+      return NULL;
+    }
+
+    uint32_t device;
+    for (;;) {
+      bool found = deque_take(&deques[self], true, &device);
+      for (uint32_t i = 1; !found && i < fleet.workers; i++) {
+        found = deque_take(&deques[(self + i) % fleet.workers], false, &device);
+      }
+      if (!found) {
+        break;
+      }
+      run_device(device);
+    }
+    pthread_barrier_wait(&epoch_done);
+  }
+}
+
+static bool deque_take(fleet_deque_t *deque, bool own, uint32_t *device)
+{
+  bool found = false;
+
+  pthread_mutex_lock(&deque->lock);
+  if (deque->head != deque->tail) {
+    *device = own ? deque->items[--deque->tail] : deque->items[deque->head++];
+    found = true;
+  }
+  pthread_mutex_unlock(&deque->lock);
+  return found;
+}
+
+static void run_device(uint32_t device)
+{
+  pid_t pid = fork();
+  if (pid < 0) {
+    perror("fork");
+    device_state[device] = DEVICE_CRASHED;
+    return;
+  }
+  if (pid == 0) {
+    current_device = device;
+    host_world = &worlds[device];
+    fleet_boot(device);
+    _exit(EXIT_FAILURE);
+  }
+
+  int status = 0;
+  atomic_fetch_add(&boots_run, 1U);
+  if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status)) {
+    fprintf(stderr, "fleet: device %lu crashed at %lu ms\n", (unsigned long)device, (unsigned long)worlds[device].now_ms);
+    device_state[device] = DEVICE_CRASHED;
+    return;
+  }
+  switch (WEXITSTATUS(status)) {
+    case HOST_EXIT_EM4:
+    case HOST_EXIT_RESET:
+      if (worlds[device].now_ms >= fleet.end_ms) {
+        device_state[device] = DEVICE_ENDED;
+      }
+      break;
+    case HOST_EXIT_END:
+      device_state[device] = DEVICE_ENDED;
+      break;
+    case HOST_EXIT_HALT:
+      device_state[device] = DEVICE_HALTED;
+      break;
+    default:
+      device_state[device] = DEVICE_CRASHED;
+      break;
+  }
+}
+
+static void *map_shared(size_t size)
+{
+  void *memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  return (memory != MAP_FAILED) ? memory : NULL;
+}
+
+static double device_energy_mj(const host_stats_t *stats)
+{
+  double ble_s = (double)stats->tx_airtime_us[SID_EMU_LINK_BLE] / 1e6;
+  double subghz_s = (double)(stats->tx_airtime_us[SID_EMU_LINK_FSK] + stats->tx_airtime_us[SID_EMU_LINK_CSS]) / 1e6;
+  double awake_s = (double)stats->awake_ms / 1000.0;
+  double sleep_s = (double)stats->sleep_ms / 1000.0;
+  // Transmitting replaces listening for the airtime
+  double charge_uas = (HOST_FLEET_ACTIVE_UA * awake_s)
+                      + (HOST_FLEET_EM4_UA * sleep_s)
+                      + ((double)(HOST_FLEET_BLE_TX_UA - HOST_FLEET_ACTIVE_UA) * ble_s)
+                      + ((double)(HOST_FLEET_SUBGHZ_TX_UA - HOST_FLEET_ACTIVE_UA) * subghz_s);
+
+  return charge_uas * (double)fleet.supply_mv / 1e6;
+}
+
+static int compare_double(const void *a, const void *b)
+{
+  double x = *(const double *)a;
+  double y = *(const double *)b;
+  return (x > y) - (x < y);
+}
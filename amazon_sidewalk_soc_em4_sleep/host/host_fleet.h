@@ -0,0 +1,126 @@
+/***************************************************************************//**
+ * @file
+ * @brief host_fleet.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef HOST_FLEET_H
+#define HOST_FLEET_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "host_sim.h"
+#include "sid_emu.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Devices served by one gateway unless set
+#define HOST_FLEET_DEVICES_PER_GATEWAY  (500U)
+// Sub-GHz transmissions remembered per gateway to find overlaps, must cover
+// the transmissions of an epoch plus the longest boot
+#define HOST_FLEET_GATEWAY_RING         (1024U)
+// Boots starting within an epoch run in parallel
+#define HOST_FLEET_EPOCH_MS             (1000U)
+// Power-on times of the devices are spread over this window
+#define HOST_FLEET_POWER_ON_MS          (60000U)
+
+// Rough currents for the energy estimate
+#define HOST_FLEET_ACTIVE_UA            (4000U)   // Awake, radio listening
+#define HOST_FLEET_EM4_UA               (1U)      // EM4 with the BURTC running
+#define HOST_FLEET_BLE_TX_UA            (10000U)
+#define HOST_FLEET_SUBGHZ_TX_UA         (90000U)  // +20 dBm
+
+typedef struct {
+  uint32_t devices;
+  uint32_t workers;           // Worker threads, 0: one per core
+  uint32_t gateways;          // 0: one per HOST_FLEET_DEVICES_PER_GATEWAY devices
+  uint8_t channels;           // Sub-GHz channels of a gateway
+  uint8_t demodulators;       // Receptions a gateway decodes at the same time
+  uint64_t seed;
+  uint32_t end_ms;
+  bool registered;            // The devices start registered
+  uint16_t supply_mv;         // For the energy estimate
+} host_fleet_config_t;
+
+// Runs one boot of a device in a forked process, does not return
+typedef void (*host_fleet_boot_t)(uint32_t device);
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to run a fleet of devices sharing the gateways
+ *
+ * Every device has its own world (backup RAM, NVM3, clock). The boots due in
+ * an epoch of the shared virtual clock are spread over the worker threads,
+ * which steal from each other once their own boots are done. Each boot runs
+ * in a forked process, as for a single device.
+ *
+ * @param[in] config Fleet configuration
+ * @param[in] boot Boot of one device
+ *
+ * @returns #false if the fleet could not be set up
+ ******************************************************************************/
+bool host_fleet_run(const host_fleet_config_t *config, host_fleet_boot_t boot);
+
+/*******************************************************************************
+ * Shared channel of sid_emu_config_t, see sid_emu.h
+ *
+ * A sub-GHz uplink is lost if it overlaps another one on the same channel of
+ * its gateway (both are lost), or if the gateway already receives as many
+ * uplinks as it has demodulators. BLE connections are not shared.
+ ******************************************************************************/
+bool host_fleet_channel(sid_emu_link_t link, size_t size, uint16_t mtu);
+
+/*******************************************************************************
+ * Function to sum the statistics of the devices
+ *
+ * @param[out] total Sum of the statistics
+ ******************************************************************************/
+void host_fleet_sum(host_stats_t *total);
+
+/*******************************************************************************
+ * Function to print the gateway, delivery and energy figures of the fleet
+ ******************************************************************************/
+void host_fleet_print_summary(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_FLEET_H
@@ -0,0 +1,400 @@
+/***************************************************************************//**
+ * @file
+ * @brief host_hal.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// Hardware used by the application modules: backup RAM, reset cause, IADC,
+// NVM3 and the EM4 entry of em4_mode.c, backed by the shared host world.
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <string.h>
+
+#include "em_device.h"
+#include "em_cmu.h"
+#include "em_rmu.h"
+#include "em_iadc.h"
+#include "nvm3_default.h"
+#include "sl_sidewalk_utils.h"
+#include "app_ble_config.h"
+#include "app_subghz_config.h"
+#include "em4_mode.h"
+#include "em4_clock.h"
+#include "app_process.h"
+#include "host_hal.h"
+#include "host_sim.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Matches the IADC setup of app_supply.c
+#define IADC_VREF_MV            (1210UL)
+#define IADC_FULL_SCALE         (0xFFFUL)
+#define IADC_AVDD_DIVIDER       (4UL)
+
+// Reference of the EM4 clock calibration
+#define HOST_HFXO_HZ            (39000000UL)
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * BURTC compare match, the inactivity timeout elapsed
+ *
+ * @param[in] arg Unused
+ ******************************************************************************/
+static void burtc_timeout(void *arg);
+
+/*******************************************************************************
+ * Function to get the actual EM4 clock frequency
+ *
+ * @returns Frequency in mHz
+ ******************************************************************************/
+static uint64_t em4_clock_actual_mhz(void);
+
+/*******************************************************************************
+ * Function to find an NVM3 object
+ *
+ * @param[in] key Object key
+ *
+ * @returns Object or NULL
+ ******************************************************************************/
+static host_nvm_object_t *nvm_find(nvm3_ObjectKey_t key);
+
+// -----------------------------------------------------------------------------
+//                                Global Variables
+// -----------------------------------------------------------------------------
+
+BURAM_TypeDef *BURAM;
+IADC_TypeDef *IADC0;
+nvm3_Handle_t *nvm3_defaultHandle;
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+static host_hal_config_t hal_config;
+static IADC_TypeDef iadc;
+static bool burtc_running;
+static uint32_t burtc_event;
+static uint32_t em4_sleep_count;
+static uint32_t awake_ms;
+static uint32_t calibration_cycles;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+void host_hal_boot(const host_hal_config_t *config)
+{
+  hal_config = *config;
+  BURAM = (BURAM_TypeDef *)host_world->buram;
+  IADC0 = &iadc;
+  iadc.STATUS = IADC_STATUS_SINGLEFIFODV;
+}
+
+void NVIC_SystemReset(void)
+{
+  host_world->reset_cause = EMU_RSTCAUSE_SYSREQ;
+  host_world->stats.resets++;
+  host_sim_exit(HOST_EXIT_RESET);
+}
+
+uint32_t RMU_ResetCauseGet(void)
+{
+  return host_world->reset_cause;
+}
+
+void RMU_ResetCauseClear(void)
+{
+  // Kept until the next boot, em4_mode.c reads it after app_retained.c
+}
+
+void CMU_ClockEnable(CMU_Clock_TypeDef clock, bool enable)
+{
+  (void)clock;
+  (void)enable;
+}
+
+void CMU_ClockSelectSet(CMU_Clock_TypeDef clock, CMU_Select_TypeDef ref)
+{
+  (void)clock;
+  (void)ref;
+}
+
+uint8_t IADC_calcSrcClkPrescale(IADC_TypeDef *iadc_periph, uint32_t src_clk_freq, uint32_t cmu_clk_freq)
+{
+  (void)iadc_periph;
+  (void)src_clk_freq;
+  (void)cmu_clk_freq;
+  return 0;
+}
+
+uint8_t IADC_calcAdcClkPrescale(IADC_TypeDef *iadc_periph, uint32_t adc_clk_freq, uint32_t cmu_clk_freq, IADC_CfgMode_t mode, uint8_t src_clk_prescale)
+{
+  (void)iadc_periph;
+  (void)adc_clk_freq;
+  (void)cmu_clk_freq;
+  (void)mode;
+  (void)src_clk_prescale;
+  return 0;
+}
+
+void IADC_reset(IADC_TypeDef *iadc_periph)
+{
+  (void)iadc_periph;
+}
+
+void IADC_init(IADC_TypeDef *iadc_periph, const IADC_Init_t *init, const IADC_AllConfigs_t *all_configs)
+{
+  (void)iadc_periph;
+  (void)init;
+  (void)all_configs;
+}
+
+void IADC_initSingle(IADC_TypeDef *iadc_periph, const IADC_InitSingle_t *init, const IADC_SingleInput_t *input)
+{
+  (void)iadc_periph;
+  (void)init;
+  (void)input;
+}
+
+void IADC_command(IADC_TypeDef *iadc_periph, IADC_Cmd_t cmd)
+{
+  (void)iadc_periph;
+  (void)cmd;
+}
+
+IADC_Result_t IADC_readSingleResult(IADC_TypeDef *iadc_periph)
+{
+  (void)iadc_periph;
+  uint64_t drain_mv = ((uint64_t)hal_config.supply_drain_mv_h * host_world->now_ms) / (3600UL * 1000UL);
+  uint32_t supply_mv = (drain_mv < hal_config.supply_mv) ? hal_config.supply_mv - (uint32_t)drain_mv : 0U;
+  IADC_Result_t result = {
+    .data = (uint32_t)((supply_mv * IADC_FULL_SCALE) / (IADC_VREF_MV * IADC_AVDD_DIVIDER)),
+    .id = 0,
+  };
+  return result;
+}
+
+Ecode_t nvm3_readData(nvm3_Handle_t *handle, nvm3_ObjectKey_t key, void *value, size_t len)
+{
+  return nvm3_readPartialData(handle, key, value, 0, len);
+}
+
+Ecode_t nvm3_readPartialData(nvm3_Handle_t *handle, nvm3_ObjectKey_t key, void *value, size_t offset, size_t len)
+{
+  (void)handle;
+  host_nvm_object_t *object = nvm_find(key);
+  if (object == NULL) {
+    return ECODE_NVM3_ERR_KEY_NOT_FOUND;
+  }
+  if (offset + len > object->size) {
+    return ECODE_NVM3_ERR_READ_DATA_SIZE;
+  }
+  memcpy(value, &object->data[offset], len);
+  return ECODE_NVM3_OK;
+}
+
+Ecode_t nvm3_writeData(nvm3_Handle_t *handle, nvm3_ObjectKey_t key, const void *value, size_t len)
+{
+  (void)handle;
+  host_nvm_object_t *object = nvm_find(key);
+  if (len > HOST_NVM_MAX_OBJECT_SIZE) {
+    return ECODE_NVM3_ERR_STORAGE_FULL;
+  }
+  for (uint32_t i = 0; object == NULL && i < HOST_NVM_MAX_OBJECTS; i++) {
+    if (!host_world->nvm[i].used) {
+      object = &host_world->nvm[i];
+    }
+  }
+  if (object == NULL) {
+    return ECODE_NVM3_ERR_STORAGE_FULL;
+  }
+  object->key = key;
+  object->size = (uint16_t)len;
+  object->used = true;
+  memcpy(object->data, value, len);
+  host_world->stats.nvm_writes++;
+  return ECODE_NVM3_OK;
+}
+
+Ecode_t nvm3_getObjectInfo(nvm3_Handle_t *handle, nvm3_ObjectKey_t key, uint32_t *type, size_t *len)
+{
+  (void)handle;
+  host_nvm_object_t *object = nvm_find(key);
+  if (object == NULL) {
+    return ECODE_NVM3_ERR_KEY_NOT_FOUND;
+  }
+  *type = 0;
+  *len = object->size;
+  return ECODE_NVM3_OK;
+}
+
+Ecode_t nvm3_deleteObject(nvm3_Handle_t *handle, nvm3_ObjectKey_t key)
+{
+  (void)handle;
+  host_nvm_object_t *object = nvm_find(key);
+  if (object == NULL) {
+    return ECODE_NVM3_ERR_KEY_NOT_FOUND;
+  }
+  object->used = false;
+  return ECODE_NVM3_OK;
+}
+
+bool sl_sidewalk_utils_is_data_ascii(const char *data, size_t len)
+{
+  for (size_t i = 0; i < len; i++) {
+    if (data[i] < 0x20 || data[i] > 0x7E) {
+      return false;
+    }
+  }
+  return true;
+}
+
+const struct sid_ble_link_config *app_get_ble_config(void)
+{
+  return NULL;
+}
+
+struct sid_sub_ghz_links_config *app_get_sub_ghz_config(void)
+{
+  return NULL;
+}
+
+void init_peripheral_for_EM4(void)
+{
+  burtc_running = false;
+  burtc_event = 0;
+  em4_clock_init();
+  em4_sleep_count = em4_clock_ms_to_count(WAKEUP_INTERVAL_MS);
+  awake_ms = WAKEUP_INTERVAL_MS;
+}
+
+uint32_t em4_get_last_sleep_ms(void)
+{
+  return (host_world->reset_cause & EMU_RSTCAUSE_EM4) ? em4_clock_count_to_ms(host_world->last_sleep_count) : 0U;
+}
+
+void start_burtc_timeout(void)
+{
+  burtc_running = hal_config.em4_enabled;
+  reset_burtc_timer();
+}
+
+void reset_burtc_timer(void)
+{
+  host_sim_cancel(burtc_event);
+  burtc_event = 0;
+  if (burtc_running) {
+    burtc_event = host_sim_schedule(awake_ms, burtc_timeout, NULL);
+  }
+}
+
+void set_em4_sleep_duration(uint32_t sleep_ms)
+{
+  // Counted by the BURTC, converted at the calibrated frequency
+  uint32_t count = em4_clock_ms_to_count((sleep_ms > EM4_SLEEP_MAX_MS) ? EM4_SLEEP_MAX_MS : sleep_ms);
+  em4_sleep_count = (count == 0U) ? 1U : count;
+}
+
+void set_em4_awake_timeout(uint32_t timeout_ms)
+{
+  uint32_t count = em4_clock_ms_to_count((timeout_ms > EM4_SLEEP_MAX_MS) ? EM4_SLEEP_MAX_MS : timeout_ms);
+  awake_ms = (uint32_t)(((uint64_t)((count == 0U) ? 1U : count) * 1000000ULL) / em4_clock_actual_mhz());
+}
+
+void CMU_CalibrateConfig(uint32_t downCycles, CMU_Select_TypeDef downSel, CMU_Select_TypeDef upSel)
+{
+  (void)downSel;
+  (void)upSel;
+  calibration_cycles = downCycles;
+}
+
+void CMU_CalibrateStart(void)
+{
+}
+
+uint32_t CMU_CalibrateCountGet(void)
+{
+  return (uint32_t)(((uint64_t)HOST_HFXO_HZ * calibration_cycles * 1000ULL) / em4_clock_actual_mhz());
+}
+
+uint32_t SystemHFXOClockGet(void)
+{
+  return HOST_HFXO_HZ;
+}
+
+void em_EM4_ULfrcoBURTC(void)
+{
+  uint32_t sleep_ms = (uint32_t)(((uint64_t)em4_sleep_count * 1000000ULL) / em4_clock_actual_mhz());
+  uint32_t wake_ms = (hal_config.next_wake_ms != NULL) ? hal_config.next_wake_ms() : UINT32_MAX;
+
+  // A button press wakes the device before the BURTC does
+  if (wake_ms > host_world->now_ms && wake_ms - host_world->now_ms < sleep_ms) {
+    sleep_ms = wake_ms - host_world->now_ms;
+  }
+  if (host_world->now_ms + sleep_ms > host_world->end_ms) {
+    sleep_ms = host_world->end_ms - host_world->now_ms;
+  }
+  host_world->stats.awake_ms += host_world->now_ms - host_world->boot_ms;
+  host_world->stats.sleep_ms += sleep_ms;
+  host_world->stats.em4_entries++;
+  host_world->now_ms += sleep_ms;
+  host_world->boot_ms = host_world->now_ms;
+  host_world->last_sleep_count = (uint32_t)(((uint64_t)sleep_ms * em4_clock_actual_mhz()) / 1000000ULL);
+  host_world->reset_cause = EMU_RSTCAUSE_EM4;
+  host_sim_exit(HOST_EXIT_EM4);
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+static void burtc_timeout(void *arg)
+{
+  (void)arg;
+  burtc_event = 0;
+  app_trigger_em4_sleep();
+}
+
+static uint64_t em4_clock_actual_mhz(void)
+{
+  return ((uint64_t)EM4_CLOCK_NOMINAL_HZ * (uint64_t)(1000000LL + hal_config.em4_clock_ppm)) / 1000ULL;
+}
+
+static host_nvm_object_t *nvm_find(nvm3_ObjectKey_t key)
+{
+  for (uint32_t i = 0; i < HOST_NVM_MAX_OBJECTS; i++) {
+    if (host_world->nvm[i].used && host_world->nvm[i].key == key) {
+      return &host_world->nvm[i];
+    }
+  }
+  return NULL;
+}
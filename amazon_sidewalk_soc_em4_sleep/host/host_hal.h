@@ -0,0 +1,70 @@
+/***************************************************************************//**
+ * @file
+ * @brief host_hal.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef HOST_HAL_H
+#define HOST_HAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+typedef struct {
+  bool em4_enabled;           // Enter EM4 on inactivity as on the device
+  uint16_t supply_mv;         // Supply voltage returned by the IADC at time 0
+  uint16_t supply_drain_mv_h; // Supply lost per hour of simulated time
+  int32_t em4_clock_ppm;      // Actual EM4 clock frequency off the nominal one
+  uint32_t (*next_wake_ms)(void); // Time of the next GPIO wake-up, UINT32_MAX: none
+} host_hal_config_t;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to set the emulated hardware up at the start of a boot
+ *
+ * @param[in] config Hardware configuration
+ ******************************************************************************/
+void host_hal_boot(const host_hal_config_t *config);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_HAL_H
@@ -0,0 +1,644 @@
+/***************************************************************************//**
+ * @file
+ * @brief host_main.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+// Runs the application of this example on Linux against the emulated Sidewalk
+// network of sid_emu.c, on a virtual clock. Each boot of the device is a
+// forked process sharing the retained state (backup RAM, NVM3, clock) with
+// the parent, so EM4 and resets go through the same code as on the device.
+//
+// Build from the example directory:
+//   cc -std=gnu11 -O2 -pthread -Ihost/include -Ihost -I. -DSL_BLE_SUPPORTED -DSL_FSK_SUPPORTED
+//      -DSL_RADIO_EXTERNAL
+//      host/*.c app_process.c app_link_router.c app_segment.c app_report.c
+//      app_series_codec.c app_nvm.c app_trace.c app_retained.c app_diag.c
+//      app_airtime.c app_bench.c app_supply.c app_sample_ring.c app_schedule.c
+//      app_connect.c app_rendezvous.c app_radio_sleep.c app_tx_power.c em4_hooks.c
+//      app_outbox.c app_ack_policy.c app_supervisor.c app_battery.c em4_clock.c app_payload.c
+//      -o sid_host
+//
+// Example, one hour of counter updates every 20 s with 10% FSK uplink loss:
+//   ./sid_host --duration 3600 --send-every 20 --link fsk:loss=10 -q
+//
+// Example, replay of a trace dumped by a device in the field:
+//   ./sid_host --replay rtt.log -q
+//
+// Example, 10000 devices for an hour, built with -DAPP_TRACE_PERSIST=0
+// -DHOST_NVM_MAX_OBJECTS=4 -DHOST_NVM_MAX_OBJECT_SIZE=16 to keep one world
+// per device small:
+//   ./sid_host --fleet 10000 --send-every 900 -q
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "em_device.h"
+#include "em4_mode.h"
+#include "em4_clock.h"
+#include "app_process.h"
+#include "app_retained.h"
+#include "app_diag.h"
+#include "app_supply.h"
+#include "app_battery.h"
+#include "app_trace.h"
+#include "app_airtime.h"
+#include "app_schedule.h"
+#include "app_rendezvous.h"
+#include "app_radio_sleep.h"
+#include "app_tx_power.h"
+#include "app_ack_policy.h"
+#include "app_supervisor.h"
+#include "sl_sidewalk_log_app.h"
+#include "host_hal.h"
+#include "host_sim.h"
+#include "host_replay.h"
+#include "host_fleet.h"
+#include "sid_emu.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+#define HOST_DEFAULT_DURATION_S     (3600UL)
+#define HOST_DEFAULT_SEND_EVERY_S   (60UL)
+#define HOST_DEFAULT_SUPPLY_MV      (3000U)
+#define HOST_DEFAULT_SEED           (1ULL)
+#define HOST_DEFAULT_DEVICE_ID      "host-0001"
+// Simulated past the end of a replayed recording
+#define HOST_REPLAY_TAIL_S          (60UL)
+
+typedef struct {
+  uint32_t period_ms;         // 0: disabled
+  void (*trigger)(void);
+  bool send;                  // Measures the latency to the next sent callback
+} host_script_t;
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to run one boot of the device, does not return
+ ******************************************************************************/
+static void run_boot(void);
+
+/*******************************************************************************
+ * Function to run one boot of a fleet device, does not return
+ *
+ * @param[in] device Device index
+ ******************************************************************************/
+static void fleet_boot(uint32_t device);
+
+/*******************************************************************************
+ * Function to get the first time a script fires at or after a time
+ *
+ * @param[in] script Script
+ * @param[in] from_ms Absolute time in ms
+ *
+ * @returns Absolute time in ms
+ ******************************************************************************/
+static uint32_t script_at_ms(const host_script_t *script, uint32_t from_ms);
+
+/*******************************************************************************
+ * Scripted trigger, calls the application and schedules the next one
+ *
+ * @param[in] arg Script
+ ******************************************************************************/
+static void script_fire(void *arg);
+
+/*******************************************************************************
+ * Scripted alarm, always code 1
+ ******************************************************************************/
+static void script_alarm(void);
+
+/*******************************************************************************
+ * Function to get the next scripted trigger, wakes the device from EM4
+ *
+ * @returns Absolute time in ms, UINT32_MAX if none
+ ******************************************************************************/
+static uint32_t script_next_ms(void);
+
+/*******************************************************************************
+ * Function to print the statistics of the simulation
+ ******************************************************************************/
+static void print_summary(void);
+
+/*******************************************************************************
+ * Function to print the command line usage
+ *
+ * @param[in] name Program name
+ ******************************************************************************/
+static void usage(const char *name);
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+static sid_emu_config_t emu_config;
+// Stands for the SMSN, seeds the uplink schedule
+static const char *device_id = HOST_DEFAULT_DEVICE_ID;
+static host_hal_config_t hal_config = {
+  .em4_enabled = true,
+  .supply_mv = HOST_DEFAULT_SUPPLY_MV,
+  .next_wake_ms = script_next_ms,
+};
+static host_script_t scripts[] = {
+  { HOST_DEFAULT_SEND_EVERY_S * 1000UL, app_trigger_connect_and_send, true },
+  { 0, app_trigger_send_report, true },
+  { 0, app_trigger_trace_dump, false },
+  { 0, script_alarm, true },
+};
+static bool replay;
+// Offsets the scripts of fleet devices so they do not all fire together
+static uint32_t script_phase;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+  static const struct option options[] = {
+    { "seed", required_argument, NULL, 's' },
+    { "device-id", required_argument, NULL, 'i' },
+    { "duration", required_argument, NULL, 'd' },
+    { "send-every", required_argument, NULL, 'e' },
+    { "report-every", required_argument, NULL, 'r' },
+    { "dump-every", required_argument, NULL, 't' },
+    { "alarm-every", required_argument, NULL, 'a' },
+    { "replay", required_argument, NULL, 'R' },
+    { "fleet", required_argument, NULL, 'F' },
+    { "workers", required_argument, NULL, 'W' },
+    { "gateways", required_argument, NULL, 'G' },
+    { "channels", required_argument, NULL, 'C' },
+    { "demodulators", required_argument, NULL, 'M' },
+    { "link", required_argument, NULL, 'l' },
+    { "downlink-every", required_argument, NULL, 'D' },
+    { "uplink-log", required_argument, NULL, 'u' },
+    { "supply", required_argument, NULL, 'v' },
+    { "supply-drain", required_argument, NULL, 'V' },
+    { "em4-clock-ppm", required_argument, NULL, 'P' },
+    { "stack-init", required_argument, NULL, 'I' },
+    { "unregistered", no_argument, NULL, 'U' },
+    { "no-time-sync", no_argument, NULL, 'T' },
+    { "no-sleep", no_argument, NULL, 'S' },
+    { "quiet", no_argument, NULL, 'q' },
+    { "help", no_argument, NULL, 'h' },
+    { NULL, 0, NULL, 0 },
+  };
+  static const char *const link_names[HOST_LINK_COUNT] = { "ble", "fsk", "css" };
+  unsigned long long seed = HOST_DEFAULT_SEED;
+  unsigned long duration_s = 0;
+  bool registered = true;
+  host_fleet_config_t fleet = {
+    .channels = 8U,
+    .demodulators = 8U,
+  };
+
+  sid_emu_default_config(&emu_config);
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "qh", options, NULL)) != -1) {
+    switch (opt) {
+      case 's':
+        seed = strtoull(optarg, NULL, 0);
+        break;
+      case 'i':
+        device_id = optarg;
+        break;
+      case 'd':
+        duration_s = strtoul(optarg, NULL, 0);
+        break;
+      case 'e':
+        scripts[0].period_ms = (uint32_t)(strtoul(optarg, NULL, 0) * 1000UL);
+        break;
+      case 'r':
+        scripts[1].period_ms = (uint32_t)(strtoul(optarg, NULL, 0) * 1000UL);
+        break;
+      case 't':
+        scripts[2].period_ms = (uint32_t)(strtoul(optarg, NULL, 0) * 1000UL);
+        break;
+      case 'a':
+        scripts[3].period_ms = (uint32_t)(strtoul(optarg, NULL, 0) * 1000UL);
+        break;
+      case 'R':
+        if (!host_replay_load(optarg)) {
+          return EXIT_FAILURE;
+        }
+        replay = true;
+        break;
+      case 'F':
+        fleet.devices = (uint32_t)strtoul(optarg, NULL, 0);
+        break;
+      case 'W':
+        fleet.workers = (uint32_t)strtoul(optarg, NULL, 0);
+        break;
+      case 'G':
+        fleet.gateways = (uint32_t)strtoul(optarg, NULL, 0);
+        break;
+      case 'C':
+        fleet.channels = (uint8_t)strtoul(optarg, NULL, 0);
+        break;
+      case 'M':
+        fleet.demodulators = (uint8_t)strtoul(optarg, NULL, 0);
+        break;
+      case 'D':
+        emu_config.downlink_every_ms = (uint32_t)(strtoul(optarg, NULL, 0) * 1000UL);
+        break;
+      case 'v':
+        hal_config.supply_mv = (uint16_t)strtoul(optarg, NULL, 0);
+        break;
+      case 'V':
+        hal_config.supply_drain_mv_h = (uint16_t)strtoul(optarg, NULL, 0);
+        break;
+      case 'P':
+        hal_config.em4_clock_ppm = (int32_t)strtol(optarg, NULL, 0);
+        break;
+      case 'I':
+        emu_config.init_ms = (uint32_t)strtoul(optarg, NULL, 0);
+        break;
+      case 'U':
+        registered = false;
+        break;
+      case 'T':
+        emu_config.time_sync = false;
+        break;
+      case 'S':
+        hal_config.em4_enabled = false;
+        break;
+      case 'q':
+        host_log_enabled = false;
+        break;
+      case 'u':
+        emu_config.uplink_log = fopen(optarg, "w");
+        if (emu_config.uplink_log == NULL) {
+          perror(optarg);
+          return EXIT_FAILURE;
+        }
+        break;
+      case 'l': {
+        char *spec = strchr(optarg, ':');
+        uint32_t link = 0;
+        if (spec != NULL) {
+          *spec++ = '\0';
+        }
+        while (link < HOST_LINK_COUNT && strcmp(optarg, link_names[link]) != 0) {
+          link++;
+        }
+        if (link == HOST_LINK_COUNT || spec == NULL || !sid_emu_parse_link(&emu_config.links[link], spec)) {
+          fprintf(stderr, "invalid link description: %s\n", optarg);
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      default:
+        usage(argv[0]);
+        return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+  if (replay) {
+    // The recording replaces the scripted sends and decides the registration
+    scripts[0].period_ms = 0;
+    scripts[1].period_ms = 0;
+    scripts[3].period_ms = 0;
+    registered = host_replay_registered();
+    if (duration_s == 0) {
+      duration_s = host_replay_get_recorded()->span_ms / 1000UL + HOST_REPLAY_TAIL_S;
+    }
+  } else if (duration_s == 0) {
+    duration_s = HOST_DEFAULT_DURATION_S;
+  }
+  if (seed == 0 || duration_s == 0 || duration_s > UINT32_MAX / 1000UL) {
+    fprintf(stderr, "seed and duration must be non zero\n");
+    return EXIT_FAILURE;
+  }
+  if (fleet.devices != 0) {
+    if (replay) {
+      fprintf(stderr, "a fleet cannot replay a recording\n");
+      return EXIT_FAILURE;
+    }
+    fleet.seed = seed;
+    fleet.end_ms = (uint32_t)(duration_s * 1000UL);
+    fleet.registered = registered;
+    fleet.supply_mv = hal_config.supply_mv;
+    emu_config.channel = host_fleet_channel;
+    sid_emu_configure(&emu_config);
+    // Device logs would interleave
+    host_log_enabled = false;
+    if (!host_fleet_run(&fleet, fleet_boot)) {
+      return EXIT_FAILURE;
+    }
+
+    static host_world_t total;
+    host_world = &total;
+    total.now_ms = fleet.end_ms;
+    host_fleet_sum(&total.stats);
+    print_summary();
+    host_fleet_print_summary();
+    return EXIT_SUCCESS;
+  }
+  sid_emu_configure(&emu_config);
+
+  host_world = mmap(NULL, sizeof(*host_world), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (host_world == MAP_FAILED) {
+    perror("mmap");
+    return EXIT_FAILURE;
+  }
+  memset(host_world, 0, sizeof(*host_world));
+  host_world->end_ms = (uint32_t)(duration_s * 1000UL);
+  host_world->rng = seed;
+  host_world->reset_cause = EMU_RSTCAUSE_POR;
+  host_world->network_registered = registered;
+
+  bool running = true;
+  while (running && host_world->now_ms < host_world->end_ms) {
+    fflush(NULL);
+    pid_t pid = fork();
+    if (pid < 0) {
+      perror("fork");
+      return EXIT_FAILURE;
+    }
+    if (pid == 0) {
+      run_boot();
+    }
+
+    int status = 0;
+    if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status)) {
+      fprintf(stderr, "boot %lu crashed at %lu ms\n", (unsigned long)host_world->stats.boots, (unsigned long)host_world->now_ms);
+      return EXIT_FAILURE;
+    }
+    switch (WEXITSTATUS(status)) {
+      case HOST_EXIT_EM4:
+      case HOST_EXIT_RESET:
+        break;
+      case HOST_EXIT_END:
+        running = false;
+        break;
+      case HOST_EXIT_HALT:
+        fprintf(stderr, "main task ended at %lu ms\n", (unsigned long)host_world->now_ms);
+        running = false;
+        break;
+      default:
+        fprintf(stderr, "boot %lu failed, exit code %d\n", (unsigned long)host_world->stats.boots, WEXITSTATUS(status));
+        return EXIT_FAILURE;
+    }
+  }
+
+  print_summary();
+  if (emu_config.uplink_log != NULL) {
+    fclose(emu_config.uplink_log);
+  }
+  return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+static void run_boot(void)
+{
+  host_world->boot_ms = host_world->now_ms;
+  host_world->stats.boots++;
+  host_hal_boot(&hal_config);
+
+  // Same order as app_init()
+  init_peripheral_for_EM4();
+  app_retained_init(em4_get_last_sleep_ms());
+  host_world->stats.clock_error_ms = (int32_t)(app_retained_now_ms() - host_world->now_ms);
+  host_world->stats.clock_offset_ppm = em4_clock_get_offset_ppm();
+  uint32_t clock_error_ms = (uint32_t)abs(host_world->stats.clock_error_ms);
+  if (clock_error_ms > host_world->stats.clock_error_max_ms) {
+    host_world->stats.clock_error_max_ms = clock_error_ms;
+  }
+  app_diag_init();
+  uint16_t supply_mv = app_supply_measure_mv();
+  app_diag_set(APP_DIAG_SUPPLY_MV, supply_mv);
+  if (app_battery_init(supply_mv)) {
+    SL_SID_LOG_APP_WARNING("battery tier changed: %s", app_battery_get_mode()->name);
+  }
+  SL_SID_LOG_APP_INFO("supply: %u mV, battery tier: %s", (unsigned int)supply_mv, app_battery_get_mode()->name);
+  app_diag_set(APP_DIAG_BATTERY_TIER, (uint32_t)app_battery_get_tier());
+  app_airtime_init();
+  app_schedule_init(app_schedule_seed(device_id));
+  app_schedule_set_stride(app_battery_get_mode()->schedule_stride);
+  app_trace_set_persist(app_battery_get_mode()->trace_persist);
+  set_em4_awake_timeout(app_battery_get_mode()->awake_ms);
+  app_rendezvous_init();
+  app_radio_sleep_init();
+  app_tx_power_init();
+  app_ack_policy_init();
+  app_supervisor_init();
+
+  for (uint32_t i = 0; i < sizeof(scripts) / sizeof(scripts[0]); i++) {
+    if (scripts[i].period_ms == 0) {
+      continue;
+    }
+    uint32_t next_ms = script_at_ms(&scripts[i], host_world->now_ms);
+    if (next_ms == 0) {
+      next_ms = scripts[i].period_ms;
+    }
+    if (next_ms == host_world->now_ms && host_world->reset_cause == EMU_RSTCAUSE_EM4) {
+      host_world->stats.trigger_wakes++;
+    }
+    host_sim_schedule(next_ms - host_world->now_ms, script_fire, &scripts[i]);
+  }
+  if (replay) {
+    host_replay_arm();
+  }
+
+  main_thread(NULL);
+  host_sim_exit(HOST_EXIT_HALT);
+}
+
+static void fleet_boot(uint32_t device)
+{
+  static char id[16];
+
+  snprintf(id, sizeof(id), "host-%05lu", (unsigned long)(device + 1U));
+  device_id = id;
+  script_phase = app_schedule_seed(id);
+  run_boot();
+}
+
+static uint32_t script_at_ms(const host_script_t *script, uint32_t from_ms)
+{
+  uint32_t phase_ms = script_phase % script->period_ms;
+
+  if (from_ms <= phase_ms) {
+    return phase_ms;
+  }
+  return phase_ms + (((from_ms - phase_ms + script->period_ms - 1U) / script->period_ms) * script->period_ms);
+}
+
+static void script_fire(void *arg)
+{
+  host_script_t *script = (host_script_t *)arg;
+  host_world->stats.triggers++;
+  host_sim_schedule(script->period_ms, script_fire, script);
+  if (script->send) {
+    host_sim_note_send();
+  }
+  script->trigger();
+}
+
+static void script_alarm(void)
+{
+  app_trigger_alarm(1U);
+}
+
+static uint32_t script_next_ms(void)
+{
+  uint32_t next_ms = UINT32_MAX;
+  for (uint32_t i = 0; i < sizeof(scripts) / sizeof(scripts[0]); i++) {
+    if (scripts[i].period_ms == 0) {
+      continue;
+    }
+    uint32_t at_ms = script_at_ms(&scripts[i], host_world->now_ms + 1U);
+    if (at_ms < next_ms) {
+      next_ms = at_ms;
+    }
+  }
+  if (replay && host_replay_next_ms() < next_ms) {
+    next_ms = host_replay_next_ms();
+  }
+  return next_ms;
+}
+
+static void print_summary(void)
+{
+  const host_stats_t *stats = &host_world->stats;
+  uint64_t total_ms = stats->awake_ms + stats->sleep_ms;
+  uint32_t put = stats->put[0] + stats->put[1] + stats->put[2];
+  uint32_t delivered = stats->delivered[0] + stats->delivered[1] + stats->delivered[2];
+
+  printf("simulated:      %lu s\n", (unsigned long)(host_world->now_ms / 1000U));
+  printf("boots:          %lu (em4 wake-ups %lu, resets %lu)\n",
+         (unsigned long)stats->boots,
+         (unsigned long)stats->em4_entries,
+         (unsigned long)stats->resets);
+  printf("awake:          %llu ms (%.1f%%)\n",
+         (unsigned long long)stats->awake_ms,
+         (total_ms != 0) ? (100.0 * (double)stats->awake_ms / (double)total_ms) : 0.0);
+  printf("time to ready:  %lu ms mean over %lu boots\n",
+         (unsigned long)((stats->ready_boots != 0) ? stats->first_ready_ms / stats->ready_boots : 0U),
+         (unsigned long)stats->ready_boots);
+  printf("triggers:       %lu (%lu woke the device)\n", (unsigned long)stats->triggers, (unsigned long)stats->trigger_wakes);
+  printf("uplinks put:    %lu (ble %lu, fsk %lu, css %lu), rejected %lu\n",
+         (unsigned long)put,
+         (unsigned long)stats->put[0],
+         (unsigned long)stats->put[1],
+         (unsigned long)stats->put[2],
+         (unsigned long)stats->put_errors);
+  printf("delivered:      %lu (ble %lu, fsk %lu, css %lu), %lu bytes\n",
+         (unsigned long)delivered,
+         (unsigned long)stats->delivered[0],
+         (unsigned long)stats->delivered[1],
+         (unsigned long)stats->delivered[2],
+         (unsigned long)stats->delivered_bytes);
+  printf("stack:          start errors %lu\n", (unsigned long)stats->start_errors);
+  printf("nvm3 writes:    %lu\n", (unsigned long)stats->nvm_writes);
+  printf("device time:    %ld ms off at the last boot, %lu ms max, EM4 clock calibrated to %ld ppm\n",
+         (long)stats->clock_error_ms,
+         (unsigned long)stats->clock_error_max_ms,
+         (long)stats->clock_offset_ppm);
+  printf("callbacks:      sent %lu, error %lu, acks lost %lu, retries %lu, below margin %lu\n",
+         (unsigned long)stats->sent_callbacks,
+         (unsigned long)stats->error_callbacks,
+         (unsigned long)stats->acks_lost,
+         (unsigned long)stats->retries,
+         (unsigned long)stats->below_margin);
+  printf("downlinks:      %lu\n", (unsigned long)stats->downlinks);
+  printf("send latency:   %lu ms mean, %lu ms max over %lu sends\n",
+         (unsigned long)((stats->latency_count != 0) ? stats->latency_sum_ms / stats->latency_count : 0U),
+         (unsigned long)stats->latency_max_ms,
+         (unsigned long)stats->latency_count);
+
+  if (replay) {
+    const host_replay_summary_t *recorded = host_replay_get_recorded();
+    printf("field trace:    %lu records over %lu s, %lu boots, %lu inputs, %lu downlinks, %lu outages\n",
+           (unsigned long)recorded->records,
+           (unsigned long)(recorded->span_ms / 1000U),
+           (unsigned long)recorded->boots,
+           (unsigned long)recorded->inputs,
+           (unsigned long)recorded->downlinks,
+           (unsigned long)recorded->outages);
+    printf("field awake:    %llu ms (%.1f%%)\n",
+           (unsigned long long)recorded->awake_ms,
+           (recorded->span_ms != 0) ? (100.0 * (double)recorded->awake_ms / (double)recorded->span_ms) : 0.0);
+    printf("field latency:  %lu ms mean, %lu ms max over %lu sends\n",
+           (unsigned long)((recorded->latency_count != 0) ? recorded->latency_sum_ms / recorded->latency_count : 0U),
+           (unsigned long)recorded->latency_max_ms,
+           (unsigned long)recorded->latency_count);
+  }
+}
+
+static void usage(const char *name)
+{
+  printf("usage: %s [options]\n"
+         "  --seed N               random seed (%llu)\n"
+         "  --device-id ID         device identifier seeding the schedule (%s)\n"
+         "  --duration S           simulated time in s (%lu, replay: recording + %lu)\n"
+         "  --send-every S         counter update period in s, 0: none (%lu)\n"
+         "  --report-every S       report period in s, 0: none\n"
+         "  --dump-every S         trace dump period in s, 0: none\n"
+         "  --alarm-every S        alarm period in s, 0: none\n"
+         "  --replay FILE          replay the last trace dump of a device log,\n"
+         "                         replaces the scripted sends\n"
+         "  --link L:K=V,...       link ble|fsk|css, keys mtu, ready, latency=MIN-MAX,\n"
+         "                         loss, ack_loss, flap=UP/DOWN, queue,\n"
+         "                         margin (dB at full power), fade, start_fail, off\n"
+         "  --downlink-every S     cloud downlink period in s\n"
+         "  --uplink-log FILE      write delivered uplinks to FILE\n"
+         "  --supply MV            supply voltage (%u)\n"
+         "  --supply-drain MV      supply lost per simulated hour, 0: none\n"
+         "  --em4-clock-ppm N      actual EM4 clock frequency off the nominal one\n"
+         "  --stack-init MS        time sid_init() takes, 0: none\n"
+         "  --unregistered         start with a device not registered\n"
+         "  --no-time-sync         the network never provides time\n"
+         "  --no-sleep             never enter EM4\n"
+         "  --fleet N              run N devices sharing gateways, scripts get a\n"
+         "                         per-device phase\n"
+         "  --workers N            fleet worker threads, 0: one per core (0)\n"
+         "  --gateways N           fleet gateways, 0: one per %u devices (0)\n"
+         "  --channels N           sub-GHz channels per gateway (8)\n"
+         "  --demodulators N       uplinks a gateway receives at once (8)\n"
+         "  -q, --quiet            only print the summary\n",
+         name,
+         HOST_DEFAULT_SEED,
+         HOST_DEFAULT_DEVICE_ID,
+         HOST_DEFAULT_DURATION_S,
+         HOST_REPLAY_TAIL_S,
+         HOST_DEFAULT_SEND_EVERY_S,
+         HOST_DEFAULT_SUPPLY_MV,
+         HOST_FLEET_DEVICES_PER_GATEWAY);
+}
@@ -0,0 +1,514 @@
+/***************************************************************************//**
+ * @file
+ * @brief host_replay.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+// Replays a trace recorded on a device (app_trace.c) against the emulated
+// network. The recorded inputs (buttons, CLI, timers) are fed to the
+// application at their recorded times, the recorded downlinks are sent by the
+// cloud and the link drops seen in the field become gateway outages. Message
+// outcomes, EM4 entries and everything else come from the application and
+// the network model, so a change of the application shows in the awake time
+// and the latencies of the replay.
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "sid_api.h"
+#include "em_device.h"
+#include "app_process.h"
+#include "app_trace.h"
+#include "host_replay.h"
+#include "host_sim.h"
+#include "sid_emu.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+#define REPLAY_LINE_MAX         (512U)
+#define REPLAY_RECORD_HEX       (16U)
+
+typedef enum {
+  REPLAY_INPUT,
+  REPLAY_DOWNLINK,
+  REPLAY_OUTAGE_BEGIN,
+  REPLAY_OUTAGE_END,
+} replay_kind_t;
+
+typedef struct {
+  uint32_t at_ms;
+  uint8_t kind;
+  uint8_t arg0;               // Input or link index
+  uint16_t arg1;              // Input argument or downlink size
+} replay_step_t;
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to decode a dumped record from a log line
+ *
+ * @param[in] line Log line
+ * @param[out] record Record
+ *
+ * @returns #true if the line holds a record
+ ******************************************************************************/
+static bool parse_record(const char *line, app_trace_record_t *record);
+
+/*******************************************************************************
+ * Function to turn the records into replay steps and the recorded summary
+ *
+ * @param[in] records Records, oldest first
+ * @param[in] count Number of records
+ *
+ * @returns #false if out of memory
+ ******************************************************************************/
+static bool build_steps(const app_trace_record_t *records, uint32_t count);
+
+/*******************************************************************************
+ * Function to append a replay step
+ *
+ * @returns #false if out of memory
+ ******************************************************************************/
+static bool add_step(uint32_t at_ms, replay_kind_t kind, uint8_t arg0, uint16_t arg1);
+
+/*******************************************************************************
+ * Function to run the steps that are due and schedule the next one
+ *
+ * @param[in] arg Unused
+ ******************************************************************************/
+static void replay_fire(void *arg);
+
+/*******************************************************************************
+ * Function to feed a recorded input to the application
+ *
+ * @param[in] input Input
+ * @param[in] arg Input argument
+ ******************************************************************************/
+static void replay_input(app_trace_input_t input, uint16_t arg);
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+static replay_step_t *steps;
+static uint32_t step_count;
+static host_replay_summary_t recorded;
+static bool recorded_registered = true;
+// Next step to run, shared by the boots
+static uint32_t *cursor;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+bool host_replay_load(const char *path)
+{
+  FILE *file = fopen(path, "r");
+  if (file == NULL) {
+    perror(path);
+    return false;
+  }
+
+  char line[REPLAY_LINE_MAX];
+  app_trace_record_t *records = NULL;
+  uint32_t count = 0;
+  uint32_t capacity = 0;
+  bool ok = true;
+
+  while (ok && fgets(line, sizeof(line), file) != NULL) {
+    app_trace_record_t record;
+    if (strstr(line, "trace: begin") != NULL) {
+      // Only the last dump of the log is replayed
+      count = 0;
+    } else if (parse_record(line, &record)) {
+      if (count == capacity) {
+        capacity = (capacity != 0) ? capacity * 2U : 256U;
+        app_trace_record_t *grown = realloc(records, capacity * sizeof(*records));
+        if (grown == NULL) {
+          ok = false;
+          break;
+        }
+        records = grown;
+      }
+      records[count++] = record;
+    }
+  }
+  fclose(file);
+
+  if (ok && count == 0) {
+    fprintf(stderr, "%s: no trace records found\n", path);
+    ok = false;
+  }
+  if (ok) {
+    cursor = mmap(NULL, sizeof(*cursor), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    ok = (cursor != MAP_FAILED) && build_steps(records, count);
+    if (cursor != MAP_FAILED) {
+      *cursor = 0;
+    }
+  }
+  free(records);
+  return ok;
+}
+
+const host_replay_summary_t *host_replay_get_recorded(void)
+{
+  return &recorded;
+}
+
+bool host_replay_registered(void)
+{
+  return recorded_registered;
+}
+
+void host_replay_arm(void)
+{
+  uint32_t now_ms = host_sim_now_ms();
+  bool outage[HOST_LINK_COUNT] = { false };
+
+  // Outages in effect now, from the start since the boot lost them
+  for (uint32_t i = 0; i < step_count && steps[i].at_ms <= now_ms; i++) {
+    if (steps[i].kind == REPLAY_OUTAGE_BEGIN || steps[i].kind == REPLAY_OUTAGE_END) {
+      outage[steps[i].arg0] = (steps[i].kind == REPLAY_OUTAGE_BEGIN);
+    }
+  }
+  for (uint32_t link = 0; link < HOST_LINK_COUNT; link++) {
+    sid_emu_set_outage((sid_emu_link_t)link, outage[link]);
+  }
+
+  // Downlinks sent while the device slept are lost, as in the field
+  while (*cursor < step_count && steps[*cursor].at_ms < now_ms && steps[*cursor].kind != REPLAY_INPUT) {
+    (*cursor)++;
+  }
+  if (*cursor == step_count) {
+    return;
+  }
+  if (steps[*cursor].at_ms == now_ms && steps[*cursor].kind == REPLAY_INPUT
+      && host_world->reset_cause == EMU_RSTCAUSE_EM4) {
+    host_world->stats.trigger_wakes++;
+  }
+  host_sim_schedule((steps[*cursor].at_ms > now_ms) ? steps[*cursor].at_ms - now_ms : 0U, replay_fire, NULL);
+}
+
+uint32_t host_replay_next_ms(void)
+{
+  if (cursor == NULL) {
+    return UINT32_MAX;
+  }
+  for (uint32_t i = *cursor; i < step_count; i++) {
+    if (steps[i].kind == REPLAY_INPUT) {
+      return steps[i].at_ms;
+    }
+  }
+  return UINT32_MAX;
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+static bool parse_record(const char *line, app_trace_record_t *record)
+{
+  const char *hex = strstr(line, "trace: ");
+  uint8_t bytes[sizeof(*record)];
+
+  if (hex == NULL) {
+    return false;
+  }
+  hex += strlen("trace: ");
+  for (uint32_t i = 0; i < REPLAY_RECORD_HEX; i++) {
+    if (strchr("0123456789abcdefABCDEF", hex[i]) == NULL || hex[i] == '\0') {
+      return false;
+    }
+  }
+  if (hex[REPLAY_RECORD_HEX] != '\0' && strchr(" \t\r\n", hex[REPLAY_RECORD_HEX]) == NULL) {
+    return false;
+  }
+  for (uint32_t i = 0; i < sizeof(bytes); i++) {
+    unsigned int byte;
+    if (sscanf(&hex[i * 2U], "%2x", &byte) != 1) {
+      return false;
+    }
+    bytes[i] = (uint8_t)byte;
+  }
+
+  // Dumped little endian, as the host
+  memcpy(record, bytes, sizeof(*record));
+  return true;
+}
+
+static bool build_steps(const app_trace_record_t *records, uint32_t count)
+{
+  uint32_t first_ms = records[0].timestamp_ms;
+  uint32_t offset_ms = 0;
+  uint32_t last_ms = 0;
+  // The dump may begin in the middle of a boot, with the links started
+  uint32_t awake_since = 0;
+  bool awake = true;
+  uint32_t started = (1UL << HOST_LINK_COUNT) - 1U;
+  uint32_t up = 0;
+  uint32_t in_outage = 0;
+  bool status_seen = false;
+  bool send_pending = false;
+  uint32_t send_ms = 0;
+
+  recorded.records = count;
+  for (uint32_t i = 0; i < count; i++) {
+    const app_trace_record_t *record = &records[i];
+    // Device time restarts after a power loss, keep the replay monotonic
+    if (record->timestamp_ms + offset_ms < first_ms + last_ms) {
+      offset_ms = first_ms + last_ms - record->timestamp_ms;
+    }
+    uint32_t at_ms = record->timestamp_ms + offset_ms - first_ms;
+    last_ms = at_ms;
+
+    switch (record->type) {
+      case APP_TRACE_BOOT:
+        if (awake) {
+          recorded.awake_ms += at_ms - awake_since;
+        }
+        recorded.boots++;
+        awake = true;
+        awake_since = at_ms;
+        started = 0;
+        up = 0;
+        // Links start from scratch, the gateway is assumed back
+        for (uint32_t link = 0; link < HOST_LINK_COUNT; link++) {
+          if ((in_outage & (1UL << link)) != 0 && !add_step(at_ms, REPLAY_OUTAGE_END, (uint8_t)link, 0)) {
+            return false;
+          }
+        }
+        in_outage = 0;
+        break;
+
+      case APP_TRACE_EM4_ENTER:
+        if (awake) {
+          recorded.awake_ms += at_ms - awake_since;
+        }
+        awake = false;
+        break;
+
+      case APP_TRACE_LINK_START:
+        started |= record->arg1;
+        break;
+
+      case APP_TRACE_LINK_STOP:
+        started &= ~(uint32_t)record->arg1;
+        break;
+
+      case APP_TRACE_STATUS: {
+        uint32_t now_up = (uint32_t)record->arg1 >> 4;
+        if (!status_seen) {
+          status_seen = true;
+          recorded_registered = (record->arg1 & 0x1U) == (SID_STATUS_REGISTERED & 0x1U);
+        }
+        for (uint32_t link = 0; link < HOST_LINK_COUNT; link++) {
+          uint32_t bit = 1UL << link;
+          if ((up & bit) != 0 && (now_up & bit) == 0 && (started & bit) != 0 && (in_outage & bit) == 0) {
+            in_outage |= bit;
+            recorded.outages++;
+            if (!add_step(at_ms, REPLAY_OUTAGE_BEGIN, (uint8_t)link, 0)) {
+              return false;
+            }
+          } else if ((now_up & bit) != 0 && (in_outage & bit) != 0) {
+            in_outage &= ~bit;
+            if (!add_step(at_ms, REPLAY_OUTAGE_END, (uint8_t)link, 0)) {
+              return false;
+            }
+          }
+        }
+        up = now_up;
+        break;
+      }
+
+      case APP_TRACE_MSG_SENT:
+        if (send_pending) {
+          uint32_t latency_ms = at_ms - send_ms;
+          send_pending = false;
+          recorded.latency_count++;
+          recorded.latency_sum_ms += latency_ms;
+          if (latency_ms > recorded.latency_max_ms) {
+            recorded.latency_max_ms = latency_ms;
+          }
+        }
+        break;
+
+      case APP_TRACE_MSG_RECEIVED: {
+        uint8_t link = 0;
+        while (link < HOST_LINK_COUNT && record->arg0 != (1U << link)) {
+          link++;
+        }
+        if (link < HOST_LINK_COUNT) {
+          recorded.downlinks++;
+          if (!add_step(at_ms, REPLAY_DOWNLINK, link, record->arg1)) {
+            return false;
+          }
+        }
+        break;
+      }
+
+      case APP_TRACE_INPUT:
+        if (record->arg0 == APP_TRACE_INPUT_EM4_SLEEP) {
+          // The host models the inactivity timeout itself
+          break;
+        }
+        if ((record->arg0 == APP_TRACE_INPUT_CONNECT_AND_SEND || record->arg0 == APP_TRACE_INPUT_SEND_COUNTER_UPDATE
+             || record->arg0 == APP_TRACE_INPUT_SEND_REPORT) && !send_pending) {
+          send_pending = true;
+          send_ms = at_ms;
+        }
+        recorded.inputs++;
+        if (!add_step(at_ms, REPLAY_INPUT, record->arg0, record->arg1)) {
+          return false;
+        }
+        break;
+
+      default:
+        break;
+    }
+  }
+  if (awake) {
+    recorded.awake_ms += last_ms - awake_since;
+  }
+  recorded.span_ms = last_ms;
+  return true;
+}
+
+static bool add_step(uint32_t at_ms, replay_kind_t kind, uint8_t arg0, uint16_t arg1)
+{
+  static uint32_t capacity;
+
+  if (step_count == capacity) {
+    capacity = (capacity != 0) ? capacity * 2U : 64U;
+    replay_step_t *grown = realloc(steps, capacity * sizeof(*steps));
+    if (grown == NULL) {
+      return false;
+    }
+    steps = grown;
+  }
+  steps[step_count++] = (replay_step_t){ at_ms, (uint8_t)kind, arg0, arg1 };
+  return true;
+}
+
+static void replay_fire(void *arg)
+{
+  (void)arg;
+  uint32_t now_ms = host_sim_now_ms();
+
+  while (*cursor < step_count && steps[*cursor].at_ms <= now_ms) {
+    const replay_step_t *step = &steps[(*cursor)++];
+    switch ((replay_kind_t)step->kind) {
+      case REPLAY_INPUT:
+        replay_input((app_trace_input_t)step->arg0, step->arg1);
+        break;
+      case REPLAY_DOWNLINK:
+        sid_emu_downlink((sid_emu_link_t)step->arg0, step->arg1);
+        break;
+      case REPLAY_OUTAGE_BEGIN:
+      case REPLAY_OUTAGE_END:
+        sid_emu_set_outage((sid_emu_link_t)step->arg0, step->kind == REPLAY_OUTAGE_BEGIN);
+        break;
+    }
+  }
+  if (*cursor < step_count) {
+    host_sim_schedule(steps[*cursor].at_ms - now_ms, replay_fire, NULL);
+  }
+}
+
+static void replay_input(app_trace_input_t input, uint16_t arg)
+{
+  host_world->stats.triggers++;
+  switch (input) {
+    case APP_TRACE_INPUT_CONNECT_AND_SEND:
+      host_sim_note_send();
+      app_trigger_connect_and_send();
+      break;
+    case APP_TRACE_INPUT_SEND_COUNTER_UPDATE:
+      host_sim_note_send();
+      app_trigger_send_counter_update();
+      break;
+    case APP_TRACE_INPUT_SEND_REPORT:
+      host_sim_note_send();
+      app_trigger_send_report();
+      break;
+    case APP_TRACE_INPUT_FACTORY_RESET:
+      app_trigger_factory_reset();
+      break;
+    case APP_TRACE_INPUT_LINK_SWITCH:
+      app_trigger_link_switch(arg);
+      break;
+#if defined(SL_BLE_SUPPORTED)
+    case APP_TRACE_INPUT_CONNECTION_REQUEST:
+      app_trigger_connection_request();
+      break;
+#endif
+    case APP_TRACE_INPUT_GET_TIME:
+      app_trigger_get_time();
+      break;
+    case APP_TRACE_INPUT_GET_MTU:
+      app_trigger_get_mtu();
+      break;
+    case APP_TRACE_INPUT_TRACE_DUMP:
+      app_trigger_trace_dump();
+      break;
+    case APP_TRACE_INPUT_AIRTIME_STATS:
+      app_trigger_airtime_stats();
+      break;
+    case APP_TRACE_INPUT_AWAKE_LEASE:
+      app_trigger_awake_lease(arg);
+      break;
+    case APP_TRACE_INPUT_ALARM:
+      app_trigger_alarm((uint8_t)arg);
+      break;
+    case APP_TRACE_INPUT_OUTBOX_STATS:
+      app_trigger_outbox_stats();
+      break;
+    case APP_TRACE_INPUT_SUPERVISOR_STATS:
+      app_trigger_supervisor_stats();
+      break;
+    case APP_TRACE_INPUT_SEND:
+    {
+      // The trace keeps the size only, the bytes are zeros
+      app_payload_handle_t payload = app_payload_claim();
+      if (payload != APP_PAYLOAD_NONE) {
+        app_payload_set_size(payload, arg);
+        memset(app_payload_data(payload), 0, app_payload_get_size(payload));
+        host_sim_note_send();
+        (void)app_trigger_send(payload);
+      }
+      break;
+    }
+    default:
+      host_world->stats.triggers--;
+      break;
+  }
+}
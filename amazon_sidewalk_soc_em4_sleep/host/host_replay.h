@@ -0,0 +1,109 @@
+/***************************************************************************//**
+ * @file
+ * @brief host_replay.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef HOST_REPLAY_H
+#define HOST_REPLAY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// What the recording says about the device in the field
+typedef struct {
+  uint32_t records;
+  uint32_t boots;
+  uint32_t span_ms;           // First to last record
+  uint64_t awake_ms;          // Boot to EM4 entry, summed over boots
+  uint32_t inputs;
+  uint32_t downlinks;
+  uint32_t outages;           // Link drops while the link was started
+  uint32_t latency_count;     // Send inputs followed by a sent message
+  uint32_t latency_max_ms;
+  uint64_t latency_sum_ms;
+} host_replay_summary_t;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to load a recording, the log holding a `trace` CLI dump
+ *
+ * The last dump of the log is used, its first record is at virtual time zero.
+ *
+ * @param[in] path Log file
+ *
+ * @returns #false if the file cannot be read or holds no records
+ ******************************************************************************/
+bool host_replay_load(const char *path);
+
+/*******************************************************************************
+ * Function to get the recorded behavior, to compare with the replay
+ *
+ * @returns Summary of the loaded recording
+ ******************************************************************************/
+const host_replay_summary_t *host_replay_get_recorded(void);
+
+/*******************************************************************************
+ * Function to get the registration state at the start of the recording
+ *
+ * @returns #true unless the first recorded status is not registered
+ ******************************************************************************/
+bool host_replay_registered(void);
+
+/*******************************************************************************
+ * Function to schedule the recording for the current boot
+ *
+ * Restores the link outages in effect at the time of the boot and schedules
+ * the recorded inputs, downlinks and outages still to come.
+ ******************************************************************************/
+void host_replay_arm(void);
+
+/*******************************************************************************
+ * Function to get the next recorded input, wakes the device from EM4
+ *
+ * @returns Absolute time in ms, UINT32_MAX if none
+ ******************************************************************************/
+uint32_t host_replay_next_ms(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_REPLAY_H
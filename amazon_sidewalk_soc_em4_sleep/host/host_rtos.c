@@ -0,0 +1,253 @@
+/***************************************************************************//**
+ * @file
+ * @brief host_rtos.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// FreeRTOS calls used by the application, run on the virtual clock of
+// host_sim.c. The main task is the only task: a receive on an empty queue
+// runs the scheduled events until one of them queues something.
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdlib.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "timers.h"
+#include "host_sim.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+struct host_queue {
+  uint8_t *items;
+  UBaseType_t length;
+  UBaseType_t item_size;
+  UBaseType_t head;
+  UBaseType_t count;
+};
+
+struct host_timer {
+  TickType_t period;
+  bool auto_reload;
+  void *timer_id;
+  TimerCallbackFunction_t callback;
+  uint32_t event_id;
+  uint32_t expiry_ms;
+};
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Scheduled event of a timer
+ *
+ * @param[in] arg Timer
+ ******************************************************************************/
+static void timer_expired(void *arg);
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+BaseType_t xPortIsInsideInterrupt(void)
+{
+  return pdFALSE;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t function,
+                       const char *name,
+                       uint32_t stack_depth,
+                       void *parameters,
+                       UBaseType_t priority,
+                       TaskHandle_t *created_task)
+{
+  (void)function;
+  (void)name;
+  (void)stack_depth;
+  (void)parameters;
+  (void)priority;
+  (void)created_task;
+  // The emulator calls main_thread() itself
+  return pdFAIL;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+  (void)task;
+  host_sim_exit(HOST_EXIT_HALT);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+  uint32_t until_ms = host_sim_now_ms() + ticks;
+
+  while (host_sim_now_ms() < until_ms && host_sim_run_next()) {
+  }
+  if (host_sim_now_ms() < until_ms) {
+    host_world->now_ms = until_ms;
+  }
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+  return (TickType_t)(host_sim_now_ms() - host_world->boot_ms);
+}
+
+TickType_t xTaskGetTickCountFromISR(void)
+{
+  return xTaskGetTickCount();
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+  QueueHandle_t queue = calloc(1, sizeof(*queue));
+  if (queue == NULL) {
+    return NULL;
+  }
+  queue->items = calloc(length, item_size);
+  if (queue->items == NULL) {
+    free(queue);
+    return NULL;
+  }
+  queue->length = length;
+  queue->item_size = item_size;
+  return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait)
+{
+  (void)ticks_to_wait;
+  if (queue->count >= queue->length) {
+    return pdFALSE;
+  }
+  UBaseType_t tail = (queue->head + queue->count) % queue->length;
+  memcpy(&queue->items[tail * queue->item_size], item, queue->item_size);
+  queue->count++;
+  return pdTRUE;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void *item, BaseType_t *task_woken)
+{
+  if (task_woken != NULL) {
+    *task_woken = pdFALSE;
+  }
+  return xQueueSend(queue, item, 0);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *buffer, TickType_t ticks_to_wait)
+{
+  uint32_t until_ms = host_sim_now_ms() + ticks_to_wait;
+
+  while (queue->count == 0) {
+    if (ticks_to_wait != portMAX_DELAY && host_sim_now_ms() >= until_ms) {
+      return pdFALSE;
+    }
+    if (!host_sim_run_next()) {
+      host_sim_exit(HOST_EXIT_END);
+    }
+  }
+  memcpy(buffer, &queue->items[queue->head * queue->item_size], queue->item_size);
+  queue->head = (queue->head + 1U) % queue->length;
+  queue->count--;
+  return pdTRUE;
+}
+
+TimerHandle_t xTimerCreate(const char *name,
+                           TickType_t period,
+                           UBaseType_t auto_reload,
+                           void *timer_id,
+                           TimerCallbackFunction_t callback)
+{
+  (void)name;
+  TimerHandle_t timer = calloc(1, sizeof(*timer));
+  if (timer == NULL) {
+    return NULL;
+  }
+  timer->period = period;
+  timer->auto_reload = auto_reload != pdFALSE;
+  timer->timer_id = timer_id;
+  timer->callback = callback;
+  return timer;
+}
+
+BaseType_t xTimerStart(TimerHandle_t timer, TickType_t ticks_to_wait)
+{
+  (void)ticks_to_wait;
+  host_sim_cancel(timer->event_id);
+  timer->expiry_ms = host_sim_now_ms() + timer->period;
+  timer->event_id = host_sim_schedule(timer->period, timer_expired, timer);
+  return (timer->event_id != 0) ? pdPASS : pdFAIL;
+}
+
+BaseType_t xTimerStop(TimerHandle_t timer, TickType_t ticks_to_wait)
+{
+  (void)ticks_to_wait;
+  host_sim_cancel(timer->event_id);
+  timer->event_id = 0;
+  return pdPASS;
+}
+
+BaseType_t xTimerChangePeriod(TimerHandle_t timer, TickType_t period, TickType_t ticks_to_wait)
+{
+  timer->period = period;
+  return xTimerStart(timer, ticks_to_wait);
+}
+
+BaseType_t xTimerIsTimerActive(TimerHandle_t timer)
+{
+  return (timer->event_id != 0) ? pdTRUE : pdFALSE;
+}
+
+TickType_t xTimerGetExpiryTime(TimerHandle_t timer)
+{
+  return (TickType_t)(timer->expiry_ms - host_world->boot_ms);
+}
+
+void *pvTimerGetTimerID(TimerHandle_t timer)
+{
+  return timer->timer_id;
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+static void timer_expired(void *arg)
+{
+  TimerHandle_t timer = (TimerHandle_t)arg;
+
+  timer->event_id = 0;
+  if (timer->auto_reload) {
+    (void)xTimerStart(timer, 0);
+  }
+  timer->callback(timer);
+}
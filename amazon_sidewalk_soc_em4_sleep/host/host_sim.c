@@ -0,0 +1,190 @@
+/***************************************************************************//**
+ * @file
+ * @brief host_sim.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdio.h>
+#include <unistd.h>
+
+#include "host_sim.h"
+#include "sl_sidewalk_log_app.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+#define HOST_SIM_MAX_EVENTS     (128U)
+
+typedef struct {
+  uint32_t id;
+  uint32_t at_ms;
+  host_sim_fn_t fn;
+  void *arg;
+} sim_event_t;
+
+// -----------------------------------------------------------------------------
+//                                Global Variables
+// -----------------------------------------------------------------------------
+
+host_world_t *host_world;
+bool host_log_enabled = true;
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+static sim_event_t events[HOST_SIM_MAX_EVENTS];
+static uint32_t next_id = 1;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+uint32_t host_sim_now_ms(void)
+{
+  return host_world->now_ms;
+}
+
+uint32_t host_log_time_ms(void)
+{
+  return host_world->now_ms;
+}
+
+uint32_t host_sim_schedule(uint32_t delay_ms, host_sim_fn_t fn, void *arg)
+{
+  for (uint32_t i = 0; i < HOST_SIM_MAX_EVENTS; i++) {
+    if (events[i].id == 0) {
+      events[i].id = next_id++;
+      events[i].at_ms = host_world->now_ms + delay_ms;
+      events[i].fn = fn;
+      events[i].arg = arg;
+      return events[i].id;
+    }
+  }
+  fprintf(stderr, "host: event table full\n");
+  return 0;
+}
+
+void host_sim_cancel(uint32_t id)
+{
+  if (id == 0) {
+    return;
+  }
+  for (uint32_t i = 0; i < HOST_SIM_MAX_EVENTS; i++) {
+    if (events[i].id == id) {
+      events[i].id = 0;
+      return;
+    }
+  }
+}
+
+bool host_sim_run_next(void)
+{
+  sim_event_t *next = NULL;
+
+  // Earliest first, ties in scheduling order
+  for (uint32_t i = 0; i < HOST_SIM_MAX_EVENTS; i++) {
+    if (events[i].id != 0
+        && (next == NULL
+            || events[i].at_ms < next->at_ms
+            || (events[i].at_ms == next->at_ms && events[i].id < next->id))) {
+      next = &events[i];
+    }
+  }
+  if (next == NULL || next->at_ms >= host_world->end_ms) {
+    return false;
+  }
+
+  sim_event_t event = *next;
+  next->id = 0;
+  if (event.at_ms > host_world->now_ms) {
+    host_world->now_ms = event.at_ms;
+  }
+  event.fn(event.arg);
+  return true;
+}
+
+void host_sim_exit(host_exit_t code)
+{
+  if (code == HOST_EXIT_END && host_world->now_ms < host_world->end_ms) {
+    // Nothing left to happen, the device would idle until the end
+    host_world->now_ms = host_world->end_ms;
+  }
+  host_world->stats.awake_ms += host_world->now_ms - host_world->boot_ms;
+  fflush(NULL);
+  _exit((int)code);
+}
+
+void host_sim_note_send(void)
+{
+  if (!host_world->send_pending) {
+    host_world->send_pending = true;
+    host_world->send_trigger_ms = host_world->now_ms;
+  }
+}
+
+void host_sim_note_sent(void)
+{
+  if (!host_world->send_pending) {
+    return;
+  }
+
+  uint32_t latency_ms = host_world->now_ms - host_world->send_trigger_ms;
+  host_world->send_pending = false;
+  host_world->stats.latency_count++;
+  host_world->stats.latency_sum_ms += latency_ms;
+  if (latency_ms > host_world->stats.latency_max_ms) {
+    host_world->stats.latency_max_ms = latency_ms;
+  }
+}
+
+uint32_t host_sim_random(void)
+{
+  // xorshift64*
+  uint64_t x = host_world->rng;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  host_world->rng = x;
+  return (uint32_t)((x * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+uint32_t host_sim_random_range(uint32_t min, uint32_t max)
+{
+  if (max <= min) {
+    return min;
+  }
+  return min + (host_sim_random() % (max - min + 1U));
+}
+
+bool host_sim_chance(uint8_t percent)
+{
+  return (host_sim_random() % 100U) < percent;
+}
@@ -0,0 +1,218 @@
+/***************************************************************************//**
+ * @file
+ * @brief host_sim.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef HOST_SIM_H
+#define HOST_SIM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Every boot of the application runs in a child process, so that RAM is lost
+// on EM4 and resets as on the device. The world below is shared between the
+// boots: virtual clock, backup RAM, NVM3 and the statistics.
+
+// Fleet runs keep one world per device, build them with smaller NVM3 areas
+#ifndef HOST_NVM_MAX_OBJECTS
+#define HOST_NVM_MAX_OBJECTS        (64U)
+#endif
+#ifndef HOST_NVM_MAX_OBJECT_SIZE
+#define HOST_NVM_MAX_OBJECT_SIZE    (256U)
+#endif
+#define HOST_BURAM_WORDS            (32U)
+#define HOST_LINK_COUNT             (3U)
+
+// Exit codes of a boot
+typedef enum {
+  HOST_EXIT_EM4 = 10,         // Entered EM4, wakes up with the next boot
+  HOST_EXIT_RESET,            // Software reset
+  HOST_EXIT_END,              // Simulated time is over
+  HOST_EXIT_HALT,             // Main task deleted itself after an error
+} host_exit_t;
+
+typedef struct {
+  uint32_t key;
+  uint16_t size;
+  bool used;
+  uint8_t data[HOST_NVM_MAX_OBJECT_SIZE];
+} host_nvm_object_t;
+
+typedef struct {
+  uint32_t boots;
+  uint32_t em4_entries;
+  uint32_t resets;
+  uint64_t awake_ms;
+  uint64_t sleep_ms;
+  uint32_t triggers;            // Scripted sends
+  uint32_t trigger_wakes;       // Scripted sends that woke the device from EM4
+  uint32_t put[HOST_LINK_COUNT];
+  uint32_t put_errors;
+  uint32_t start_errors;        // Failed sid_start() calls
+  uint32_t nvm_writes;
+  uint32_t delivered[HOST_LINK_COUNT];
+  uint32_t delivered_bytes;
+  uint32_t sent_callbacks;
+  uint32_t error_callbacks;
+  uint32_t acks_lost;
+  uint32_t retries;             // Acked uplinks sent again by the stack
+  uint32_t below_margin;        // Uplinks lost for being sent too far below full power
+  uint32_t downlinks;
+  uint32_t first_ready_ms;      // Boot to first ready, summed over boots
+  uint32_t ready_boots;
+  int32_t clock_error_ms;       // Device time less simulated time at the last boot
+  uint32_t clock_error_max_ms;  // Largest error at a boot, either way
+  int32_t clock_offset_ppm;     // EM4 clock calibration at the last boot
+  uint32_t latency_count;       // Send triggers followed by a sent callback
+  uint32_t latency_max_ms;
+  uint64_t latency_sum_ms;
+  uint64_t tx_airtime_us[HOST_LINK_COUNT]; // Uplink airtime, counted by the fleet channel model
+} host_stats_t;
+
+typedef struct {
+  uint32_t now_ms;
+  uint32_t end_ms;
+  uint32_t boot_ms;
+  uint64_t rng;
+  uint32_t reset_cause;
+  uint32_t last_sleep_count;    // BURTC counts of the last EM4 sleep
+  uint32_t buram[HOST_BURAM_WORDS];
+  host_nvm_object_t nvm[HOST_NVM_MAX_OBJECTS];
+  bool network_registered;
+  bool send_pending;            // A send trigger waits for its sent callback
+  uint32_t send_trigger_ms;
+  host_stats_t stats;
+} host_world_t;
+
+typedef void (*host_sim_fn_t)(void *arg);
+
+// -----------------------------------------------------------------------------
+//                                Global Variables
+// -----------------------------------------------------------------------------
+
+extern host_world_t *host_world;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to get the virtual time
+ *
+ * @returns Time since the start of the simulation in ms
+ ******************************************************************************/
+uint32_t host_sim_now_ms(void);
+
+/*******************************************************************************
+ * Function to schedule a callback in virtual time
+ *
+ * Scheduled callbacks belong to the current boot and are dropped with it.
+ *
+ * @param[in] delay_ms Delay from now
+ * @param[in] fn Callback
+ * @param[in] arg Callback argument
+ *
+ * @returns Event id for host_sim_cancel(), 0 if the event table is full
+ ******************************************************************************/
+uint32_t host_sim_schedule(uint32_t delay_ms, host_sim_fn_t fn, void *arg);
+
+/*******************************************************************************
+ * Function to cancel a scheduled callback
+ *
+ * @param[in] id Event id, 0 is ignored
+ ******************************************************************************/
+void host_sim_cancel(uint32_t id);
+
+/*******************************************************************************
+ * Function to advance the virtual time to the next event and run it
+ *
+ * @returns #false if no event is due before the end of the simulation
+ ******************************************************************************/
+bool host_sim_run_next(void);
+
+/*******************************************************************************
+ * Function to end the current boot
+ *
+ * @param[in] code Reason
+ ******************************************************************************/
+void host_sim_exit(host_exit_t code);
+
+/*******************************************************************************
+ * Function to note a send trigger, the latency runs to the next sent callback
+ *
+ * A trigger while another one waits does not restart the latency.
+ ******************************************************************************/
+void host_sim_note_send(void);
+
+/*******************************************************************************
+ * Function to note a sent callback, ends the latency of a waiting trigger
+ ******************************************************************************/
+void host_sim_note_sent(void);
+
+/*******************************************************************************
+ * Function to draw a pseudo random number, reproducible with the seed
+ *
+ * @returns Random number
+ ******************************************************************************/
+uint32_t host_sim_random(void);
+
+/*******************************************************************************
+ * Function to draw a pseudo random number in a range
+ *
+ * @param[in] min Lower bound
+ * @param[in] max Upper bound, included
+ *
+ * @returns Random number
+ ******************************************************************************/
+uint32_t host_sim_random_range(uint32_t min, uint32_t max);
+
+/*******************************************************************************
+ * Function to draw a random event
+ *
+ * @param[in] percent Probability in %
+ *
+ * @returns #true with the given probability
+ ******************************************************************************/
+bool host_sim_chance(uint8_t percent);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_SIM_H
@@ -0,0 +1,61 @@
+/***************************************************************************//**
+ * @file
+ * @brief FreeRTOS.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef FREERTOS_H
+#define FREERTOS_H
+
+// Host stand-in for the FreeRTOS kernel, see host/host_rtos.c. Time is
+// virtual, one tick per ms.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// FreeRTOSConfig.h pulls the device header in on the target
+#include "em_device.h"
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void *TaskHandle_t;
+
+#define pdTRUE                  (1)
+#define pdFALSE                 (0)
+#define pdPASS                  (pdTRUE)
+#define pdFAIL                  (pdFALSE)
+#define portMAX_DELAY           ((TickType_t)0xFFFFFFFFUL)
+#define configTICK_RATE_HZ      (1000U)
+#define portTICK_PERIOD_MS      ((TickType_t)1000U / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(ms))
+#define portYIELD_FROM_ISR(x)   (void)(x)
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+
+BaseType_t xPortIsInsideInterrupt(void);
+
+#endif // FREERTOS_H
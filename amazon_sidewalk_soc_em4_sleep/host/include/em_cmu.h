@@ -0,0 +1,55 @@
+/***************************************************************************//**
+ * @file
+ * @brief em_cmu.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef EM_CMU_H
+#define EM_CMU_H
+
+#include "em_device.h"
+
+typedef enum {
+  cmuClock_IADC0,
+  cmuClock_IADCCLK,
+  cmuClock_BURAM,
+  cmuClock_BURTC,
+} CMU_Clock_TypeDef;
+
+typedef enum {
+  cmuSelect_FSRCO,
+  cmuSelect_ULFRCO,
+  cmuSelect_LFRCO,
+  cmuSelect_HFXO,
+} CMU_Select_TypeDef;
+
+void CMU_ClockEnable(CMU_Clock_TypeDef clock, bool enable);
+void CMU_ClockSelectSet(CMU_Clock_TypeDef clock, CMU_Select_TypeDef ref);
+void CMU_CalibrateConfig(uint32_t downCycles, CMU_Select_TypeDef downSel, CMU_Select_TypeDef upSel);
+void CMU_CalibrateStart(void);
+uint32_t CMU_CalibrateCountGet(void);
+
+#endif // EM_CMU_H
@@ -0,0 +1,62 @@
+/***************************************************************************//**
+ * @file
+ * @brief em_device.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef EM_DEVICE_H
+#define EM_DEVICE_H
+
+// Host stand-in for the device registers used by the application, see
+// host/host_hal.c
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define EMU_RSTCAUSE_POR        (1UL << 0)
+#define EMU_RSTCAUSE_PIN        (1UL << 1)
+#define EMU_RSTCAUSE_EM4        (1UL << 2)
+#define EMU_RSTCAUSE_WDOG0      (1UL << 3)
+#define EMU_RSTCAUSE_LOCKUP     (1UL << 5)
+#define EMU_RSTCAUSE_SYSREQ     (1UL << 6)
+#define EMU_RSTCAUSE_DVDDBOD    (1UL << 7)
+#define EMU_RSTCAUSE_DECBOD     (1UL << 9)
+#define EMU_RSTCAUSE_AVDDBOD    (1UL << 10)
+
+typedef struct {
+  volatile uint32_t REG;
+} BURAM_RET_TypeDef;
+
+typedef struct {
+  BURAM_RET_TypeDef RET[32];
+} BURAM_TypeDef;
+
+extern BURAM_TypeDef *BURAM;
+
+void NVIC_SystemReset(void);
+uint32_t SystemHFXOClockGet(void);
+
+#endif // EM_DEVICE_H
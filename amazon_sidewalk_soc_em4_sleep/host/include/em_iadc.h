@@ -0,0 +1,97 @@
+/***************************************************************************//**
+ * @file
+ * @brief em_iadc.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef EM_IADC_H
+#define EM_IADC_H
+
+// Host stand-in for the IADC, a single conversion returns the supply voltage
+// set on the emulator command line
+
+#include "em_device.h"
+
+typedef struct {
+  volatile uint32_t STATUS;
+} IADC_TypeDef;
+
+extern IADC_TypeDef *IADC0;
+
+#define _IADC_STATUS_CONVERTING_MASK    (1UL << 0)
+#define _IADC_STATUS_SINGLEFIFODV_MASK  (1UL << 1)
+#define IADC_STATUS_SINGLEFIFODV        (1UL << 1)
+
+typedef enum { iadcCfgReferenceInt1V2 } IADC_CfgReference_t;
+typedef enum { iadcCfgAnalogGain1x } IADC_CfgAnalogGain_t;
+typedef enum { iadcCfgModeNormal } IADC_CfgMode_t;
+typedef enum { iadcPosInputAvdd } IADC_PosInput_t;
+typedef enum { iadcNegInputGnd } IADC_NegInput_t;
+typedef enum { iadcCmdStartSingle } IADC_Cmd_t;
+
+typedef struct {
+  uint8_t srcClkPrescale;
+} IADC_Init_t;
+
+typedef struct {
+  IADC_CfgReference_t reference;
+  uint32_t vRef;
+  IADC_CfgAnalogGain_t analogGain;
+  uint8_t adcClkPrescale;
+} IADC_Config_t;
+
+typedef struct {
+  IADC_Config_t configs[2];
+} IADC_AllConfigs_t;
+
+typedef struct {
+  bool start;
+} IADC_InitSingle_t;
+
+typedef struct {
+  IADC_PosInput_t posInput;
+  IADC_NegInput_t negInput;
+} IADC_SingleInput_t;
+
+typedef struct {
+  uint32_t data;
+  uint8_t id;
+} IADC_Result_t;
+
+#define IADC_INIT_DEFAULT           { 0 }
+#define IADC_ALLCONFIGS_DEFAULT     { { { 0 } } }
+#define IADC_INITSINGLE_DEFAULT     { 0 }
+#define IADC_SINGLEINPUT_DEFAULT    { 0 }
+
+uint8_t IADC_calcSrcClkPrescale(IADC_TypeDef *iadc, uint32_t src_clk_freq, uint32_t cmu_clk_freq);
+uint8_t IADC_calcAdcClkPrescale(IADC_TypeDef *iadc, uint32_t adc_clk_freq, uint32_t cmu_clk_freq, IADC_CfgMode_t mode, uint8_t src_clk_prescale);
+void IADC_reset(IADC_TypeDef *iadc);
+void IADC_init(IADC_TypeDef *iadc, const IADC_Init_t *init, const IADC_AllConfigs_t *all_configs);
+void IADC_initSingle(IADC_TypeDef *iadc, const IADC_InitSingle_t *init, const IADC_SingleInput_t *input);
+void IADC_command(IADC_TypeDef *iadc, IADC_Cmd_t cmd);
+IADC_Result_t IADC_readSingleResult(IADC_TypeDef *iadc);
+
+#endif // EM_IADC_H
@@ -0,0 +1,56 @@
+/***************************************************************************//**
+ * @file
+ * @brief nvm3_default.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef NVM3_DEFAULT_H
+#define NVM3_DEFAULT_H
+
+// Host stand-in for NVM3, objects are kept in memory shared across the
+// emulated boots, see host/host_hal.c
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint32_t nvm3_ObjectKey_t;
+typedef uint32_t Ecode_t;
+typedef struct nvm3_Handle nvm3_Handle_t;
+
+#define ECODE_NVM3_OK                   (0U)
+#define ECODE_NVM3_ERR_KEY_NOT_FOUND    (0xF00E0001U)
+#define ECODE_NVM3_ERR_STORAGE_FULL     (0xF00E0002U)
+#define ECODE_NVM3_ERR_READ_DATA_SIZE   (0xF00E0003U)
+
+extern nvm3_Handle_t *nvm3_defaultHandle;
+
+Ecode_t nvm3_readData(nvm3_Handle_t *handle, nvm3_ObjectKey_t key, void *value, size_t len);
+Ecode_t nvm3_readPartialData(nvm3_Handle_t *handle, nvm3_ObjectKey_t key, void *value, size_t offset, size_t len);
+Ecode_t nvm3_writeData(nvm3_Handle_t *handle, nvm3_ObjectKey_t key, const void *value, size_t len);
+Ecode_t nvm3_getObjectInfo(nvm3_Handle_t *handle, nvm3_ObjectKey_t key, uint32_t *type, size_t *len);
+Ecode_t nvm3_deleteObject(nvm3_Handle_t *handle, nvm3_ObjectKey_t key);
+
+#endif // NVM3_DEFAULT_H
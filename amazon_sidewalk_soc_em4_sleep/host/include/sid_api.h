@@ -0,0 +1,209 @@
+/***************************************************************************//**
+ * @file
+ * @brief sid_api.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef SID_API_H
+#define SID_API_H
+
+// Host copy of the part of the Sidewalk API used by the application, the
+// calls are served by the network emulator in host/sid_emu.c
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <limits.h>
+
+#include "sid_error.h"
+
+#define SID_SDK_VERSION_STRING  "host"
+
+enum sid_link_type {
+  SID_LINK_TYPE_1 = 1 << 0,   // BLE
+  SID_LINK_TYPE_2 = 1 << 1,   // FSK
+  SID_LINK_TYPE_3 = 1 << 2,   // CSS
+  SID_LINK_TYPE_ANY = INT_MAX,
+};
+
+enum sid_msg_type {
+  SID_MSG_TYPE_GET = 0,
+  SID_MSG_TYPE_SET = 1,
+  SID_MSG_TYPE_NOTIFY = 2,
+  SID_MSG_TYPE_RESPONSE = 3,
+};
+
+enum sid_link_mode {
+  SID_LINK_MODE_CLOUD = 1,
+  SID_LINK_MODE_MOBILE = 2,
+};
+
+enum sid_msg_desc_tx_additional_attr {
+  SID_MSG_DESC_TX_ADDITIONAL_ATTRIBUTES_NONE = 0,
+};
+
+enum sid_state {
+  SID_STATE_READY = 0,
+  SID_STATE_NOT_READY = 1,
+  SID_STATE_ERROR = 2,
+  SID_STATE_SECURE_CHANNEL_READY = 3,
+};
+
+enum sid_registration_status {
+  SID_STATUS_REGISTERED = 0,
+  SID_STATUS_NOT_REGISTERED = 1,
+};
+
+enum sid_time_sync_status {
+  SID_STATUS_TIME_SYNCED = 0,
+  SID_STATUS_NO_TIME = 1,
+};
+
+enum sid_time_format {
+  SID_GET_GPS_TIME = 0,
+  SID_GET_UTC_TIME = 1,
+  SID_GET_LOCAL_TIME = 2,
+};
+
+enum sid_end_device_type {
+  SID_END_DEVICE_TYPE_STATIC = 1,
+};
+
+enum sid_end_device_power_type {
+  SID_END_DEVICE_POWERED_BY_BATTERY = 1,
+  SID_END_DEVICE_POWERED_BY_LINE_POWER_ONLY = 2,
+};
+
+enum sid_option {
+  SID_OPTION_SET_LINK_CONNECTION_POLICY = 1,
+  SID_OPTION_SET_LINK_POLICY_MULTI_LINK_POLICY = 2,
+};
+
+enum sid_link_connection_policy {
+  SID_LINK_CONNECTION_POLICY_NONE = 0,
+  SID_LINK_CONNECTION_POLICY_MULTI_LINK_MANAGER = 1,
+};
+
+enum sid_link_multi_link_policy {
+  SID_LINK_MULTI_LINK_POLICY_DEFAULT = 0,
+  SID_LINK_MULTI_LINK_POLICY_POWER_SAVE = 1,
+  SID_LINK_MULTI_LINK_POLICY_PERFORMANCE = 2,
+  SID_LINK_MULTI_LINK_POLICY_LATENCY = 3,
+  SID_LINK_MULTI_LINK_POLICY_RELIABILITY = 4,
+};
+
+struct sid_handle;
+
+struct sid_msg {
+  void *data;
+  size_t size;
+};
+
+struct sid_msg_desc_tx_additional_attributes {
+  bool request_ack;
+  uint8_t num_retries;
+  uint16_t ttl_in_seconds;
+  enum sid_msg_desc_tx_additional_attr additional_attr;
+};
+
+struct sid_msg_desc_rx_additional_attributes {
+  bool ack_requested;
+  bool is_msg_ack;
+  bool is_msg_duplicate;
+  int8_t rssi;
+  int8_t snr;
+};
+
+struct sid_msg_desc {
+  enum sid_link_type link_type;
+  enum sid_msg_type type;
+  enum sid_link_mode link_mode;
+  uint16_t id;
+  union {
+    struct sid_msg_desc_tx_additional_attributes tx_attr;
+    struct sid_msg_desc_rx_additional_attributes rx_attr;
+  } msg_desc_attr;
+};
+
+struct sid_status_detail {
+  enum sid_registration_status registration_status;
+  enum sid_time_sync_status time_sync_status;
+  uint32_t link_status_mask;
+};
+
+struct sid_status {
+  enum sid_state state;
+  struct sid_status_detail detail;
+};
+
+struct sid_timespec {
+  uint32_t tv_sec;
+  uint32_t tv_nsec;
+};
+
+struct sid_event_callbacks {
+  void *context;
+  void (*on_event)(bool in_isr, void *context);
+  void (*on_msg_received)(const struct sid_msg_desc *msg_desc, const struct sid_msg *msg, void *context);
+  void (*on_msg_sent)(const struct sid_msg_desc *msg_desc, void *context);
+  void (*on_send_error)(sid_error_t error, const struct sid_msg_desc *msg_desc, void *context);
+  void (*on_status_changed)(const struct sid_status *status, void *context);
+  void (*on_factory_reset)(void *context);
+};
+
+struct sid_device_characteristics {
+  enum sid_end_device_type type;
+  enum sid_end_device_power_type power_type;
+  uint16_t qualification_id;
+};
+
+struct sid_ble_link_config;
+struct sid_sub_ghz_links_config;
+
+struct sid_config {
+  uint32_t link_mask;
+  struct sid_device_characteristics dev_ch;
+  struct sid_event_callbacks *callbacks;
+  const struct sid_ble_link_config *link_config;
+  struct sid_sub_ghz_links_config *sub_ghz_link_config;
+};
+
+sid_error_t sid_init(const struct sid_config *config, struct sid_handle **handle);
+sid_error_t sid_deinit(struct sid_handle *handle);
+sid_error_t sid_start(struct sid_handle *handle, uint32_t link_mask);
+sid_error_t sid_stop(struct sid_handle *handle, uint32_t link_mask);
+sid_error_t sid_process(struct sid_handle *handle);
+sid_error_t sid_put_msg(struct sid_handle *handle, const struct sid_msg *msg, struct sid_msg_desc *msg_desc);
+sid_error_t sid_get_mtu(struct sid_handle *handle, enum sid_link_type link_type, size_t *mtu);
+sid_error_t sid_get_time(struct sid_handle *handle, enum sid_time_format format, struct sid_timespec *curr_time);
+sid_error_t sid_get_status(struct sid_handle *handle, struct sid_status *current_status);
+sid_error_t sid_set_factory_reset(struct sid_handle *handle);
+sid_error_t sid_option(struct sid_handle *handle, enum sid_option option, void *data, size_t len);
+sid_error_t sid_ble_bcn_connection_request(struct sid_handle *handle, bool set);
+sid_error_t sid_get_error(struct sid_handle *handle);
+sid_error_t sid_platform_deinit(void);
+
+#endif // SID_API_H
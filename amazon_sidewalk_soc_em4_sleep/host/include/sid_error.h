@@ -0,0 +1,60 @@
+/***************************************************************************//**
+ * @file
+ * @brief sid_error.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef SID_ERROR_H
+#define SID_ERROR_H
+
+// Host copy of the Sidewalk error codes
+
+typedef enum {
+  SID_ERROR_NONE = 0,
+  SID_ERROR_GENERIC = -1,
+  SID_ERROR_TIMEOUT = -2,
+  SID_ERROR_OUT_OF_RESOURCES = -3,
+  SID_ERROR_OOM = -4,
+  SID_ERROR_OUT_OF_HANDLES = -5,
+  SID_ERROR_NOSUPPORT = -6,
+  SID_ERROR_NO_PERMISSION = -7,
+  SID_ERROR_NOT_FOUND = -8,
+  SID_ERROR_NULL_POINTER = -9,
+  SID_ERROR_PARAM_OUT_OF_RANGE = -10,
+  SID_ERROR_INVALID_ARGS = -11,
+  SID_ERROR_INCOMPATIBLE_PARAMS = -12,
+  SID_ERROR_IO_ERROR = -13,
+  SID_ERROR_TRY_AGAIN = -14,
+  SID_ERROR_BUSY = -15,
+  SID_ERROR_DEAD_LOCK = -16,
+  SID_ERROR_DATA_NOT_AVAILABLE = -17,
+  SID_ERROR_INVALID_STATE = -18,
+  SID_ERROR_UNINITIALIZED = -20,
+  SID_ERROR_PORT_NOT_OPEN = -23,
+  SID_ERROR_STOPPED = -24,
+} sid_error_t;
+
+#endif // SID_ERROR_H
@@ -0,0 +1,45 @@
+/***************************************************************************//**
+ * @file
+ * @brief sid_pal_radio_ifc.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef SID_PAL_RADIO_IFC_H
+#define SID_PAL_RADIO_IFC_H
+
+#include <stdint.h>
+
+// Sub-GHz radio PAL, only the TX power and the sleep before EM4 are used on
+// the host
+
+#define RADIO_ERROR_NONE  (0)
+
+// Implemented by host/sid_emu.c
+int32_t sid_pal_radio_set_tx_power(int8_t power);
+// Warm start sleep, the host PAL has no cold start sleep
+int32_t sid_pal_radio_sleep(uint32_t sleep_ms);
+
+#endif // SID_PAL_RADIO_IFC_H
@@ -0,0 +1,44 @@
+/***************************************************************************//**
+ * @file
+ * @brief sl_bt_api.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef SL_BT_API_H
+#define SL_BT_API_H
+
+#include <stdint.h>
+
+// BLE stack API, only the TX power is used on the host
+
+typedef uint32_t sl_status_t;
+
+#define SL_STATUS_OK  ((sl_status_t)0x0000)
+
+// Implemented by host/sid_emu.c, powers in 0.1 dBm
+sl_status_t sl_bt_system_set_tx_power(int16_t min_power, int16_t max_power, int16_t *set_min, int16_t *set_max);
+
+#endif // SL_BT_API_H
@@ -0,0 +1,53 @@
+/***************************************************************************//**
+ * @file
+ * @brief sl_sidewalk_common_config.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef SL_SIDEWALK_COMMON_CONFIG_H
+#define SL_SIDEWALK_COMMON_CONFIG_H
+
+// Host copy of config/sl_sidewalk_common_config.h, FSK by default. Override
+// the link types with -D on the compiler command line.
+
+#define SL_SIDEWALK_LINK_BLE    (0)
+#define SL_SIDEWALK_LINK_FSK    (1)
+#define SL_SIDEWALK_LINK_CSS    (2)
+
+#ifndef SL_SIDEWALK_COMMON_DEFAULT_LINK_TYPE
+#define SL_SIDEWALK_COMMON_DEFAULT_LINK_TYPE        SL_SIDEWALK_LINK_FSK
+#endif
+
+#ifndef SL_SIDEWALK_COMMON_REGISTRATION_LINK
+#define SL_SIDEWALK_COMMON_REGISTRATION_LINK        SL_SIDEWALK_LINK_FSK
+#endif
+
+#define SL_SIDEWALK_LINK_TO_USE                     SL_SIDEWALK_COMMON_DEFAULT_LINK_TYPE
+
+#define SL_SIDEWALK_COMMON_DEFAULT_LINK_CONNECTION_POLICY   SID_LINK_CONNECTION_POLICY_MULTI_LINK_MANAGER
+#define SL_SIDEWALK_COMMON_DEFAULT_MULTI_LINK_POLICY        SID_LINK_MULTI_LINK_POLICY_DEFAULT
+
+#endif // SL_SIDEWALK_COMMON_CONFIG_H
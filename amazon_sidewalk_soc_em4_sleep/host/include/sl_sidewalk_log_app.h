@@ -0,0 +1,65 @@
+/***************************************************************************//**
+ * @file
+ * @brief sl_sidewalk_log_app.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef SL_SIDEWALK_LOG_APP_H
+#define SL_SIDEWALK_LOG_APP_H
+
+// Host logging, each line is prefixed by the virtual time. host_log_enabled
+// is cleared by the -q option of the emulator.
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+extern bool host_log_enabled;
+uint32_t host_log_time_ms(void);
+
+#define HOST_LOG(level, ...)                                                   \
+  do {                                                                         \
+    if (host_log_enabled) {                                                    \
+      uint32_t host_log_ms = host_log_time_ms();                               \
+      printf("[%6lu.%03lu] <" level "> ",                                      \
+             (unsigned long)(host_log_ms / 1000U),                             \
+             (unsigned long)(host_log_ms % 1000U));                            \
+      printf(__VA_ARGS__);                                                     \
+      printf("\n");                                                           \
+    }                                                                          \
+  } while (0)
+
+#define SL_SID_LOG_APP_ERROR(...)           HOST_LOG("error", __VA_ARGS__)
+#define SL_SID_LOG_APP_WARNING(...)         HOST_LOG("warning", __VA_ARGS__)
+#define SL_SID_LOG_APP_INFO(...)            HOST_LOG("info", __VA_ARGS__)
+#define SL_SID_LOG_APP_DEBUG(...)           do {} while (0)
+#define SL_SID_LOG_APP_HEXDUMP_INFO(p, n)   do { (void)(p); (void)(n); } while (0)
+
+#define app_log_error(...)                  HOST_LOG("error", __VA_ARGS__)
+#define app_log_warning(...)                HOST_LOG("warning", __VA_ARGS__)
+#define app_log_info(...)                   HOST_LOG("info", __VA_ARGS__)
+
+#endif // SL_SIDEWALK_LOG_APP_H
@@ -0,0 +1,857 @@
+/***************************************************************************//**
+ * @file
+ * @brief sid_emu.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+// Sidewalk stack emulation for the host build. Links come up after a
+// configurable delay, uplinks complete after a random latency and may be lost,
+// and every callback is delivered from sid_process() like the real stack.
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sid_api.h"
+#include "sid_emu.h"
+#include "host_sim.h"
+#include "sl_sidewalk_log_app.h"
+#include "sl_bt_api.h"
+#include "sid_pal_radio_ifc.h"
+#include "app_tx_power.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+#define EMU_MAX_PENDING         (32U)
+#define EMU_MAX_IN_FLIGHT       (16U)
+#define EMU_MAX_DOWNLINK_SIZE   (UINT8_MAX + 1U)
+// GPS epoch offset of the emulated network time at virtual time zero
+#define EMU_TIME_BASE_S         (1400000000UL)
+// Downlink RSSI of CSS at zero margin, its margin is reported as SNR
+#define EMU_CSS_SENSITIVITY_DBM (-127)
+
+typedef enum {
+  EMU_CB_STATUS,
+  EMU_CB_SENT,
+  EMU_CB_ERROR,
+  EMU_CB_RECEIVED,
+  EMU_CB_FACTORY_RESET,
+} emu_cb_type_t;
+
+// Callback waiting for sid_process()
+typedef struct {
+  emu_cb_type_t type;
+  struct sid_msg_desc desc;
+  struct sid_status status;
+  sid_error_t error;
+  uint8_t data[EMU_MAX_DOWNLINK_SIZE];
+  size_t size;
+} emu_pending_t;
+
+typedef struct {
+  bool used;
+  uint32_t link;
+  uint32_t event;
+  struct sid_msg_desc desc;
+  uint8_t data[UINT8_MAX + 1U];
+  size_t size;
+  int32_t backoff_db;
+  uint8_t retries_left;       // Attempts left to an acked uplink
+  bool delivered;             // Reached the cloud on an earlier attempt
+} emu_in_flight_t;
+
+struct sid_handle {
+  bool initialized;
+  struct sid_config config;
+  uint32_t started_mask;
+  uint32_t up_mask;
+  bool time_synced;
+  bool connection_request;
+  uint16_t next_id;
+  uint8_t queued[HOST_LINK_COUNT];
+  uint32_t link_event[HOST_LINK_COUNT];
+  uint32_t registration_event;
+  uint32_t time_sync_event;
+  uint32_t downlink_event;
+  uint32_t downlink_count;
+  struct sid_status reported;
+  bool reported_valid;
+  emu_pending_t pending[EMU_MAX_PENDING];
+  uint32_t pending_head;
+  uint32_t pending_count;
+  emu_in_flight_t in_flight[EMU_MAX_IN_FLIGHT];
+  // dB below full power set by the application, the radio restarts at full power
+  int32_t backoff_db[HOST_LINK_COUNT];
+};
+
+// -----------------------------------------------------------------------------
+//                          Static Function Declarations
+// -----------------------------------------------------------------------------
+
+static void emu_link_up(void *arg);
+static void emu_link_down(void *arg);
+static void emu_registered(void *arg);
+static void emu_time_synced(void *arg);
+static void emu_downlink(void *arg);
+static void emu_uplink_done(void *arg);
+
+/*******************************************************************************
+ * Function to queue a callback for sid_process() and signal the application
+ *
+ * @param[in] pending Callback, copied
+ ******************************************************************************/
+static void emu_post(const emu_pending_t *pending);
+
+/*******************************************************************************
+ * Function to post a status callback if the status changed
+ ******************************************************************************/
+static void emu_update_status(void);
+
+/*******************************************************************************
+ * Function to schedule the next link up or down transition
+ *
+ * @param[in] link Link index
+ * @param[in] up Next transition is link up
+ * @param[in] delay_ms Delay of the transition
+ ******************************************************************************/
+static void emu_schedule_link(uint32_t link, bool up, uint32_t delay_ms);
+
+/*******************************************************************************
+ * Function to stop links and drop their uplinks
+ *
+ * @param[in] link_mask Links to stop
+ ******************************************************************************/
+static void emu_stop_links(uint32_t link_mask);
+
+/*******************************************************************************
+ * Function to draw the margin of a message at full TX power
+ *
+ * @param[in] link Link index
+ *
+ * @returns Margin in dB
+ ******************************************************************************/
+static int32_t emu_margin(uint32_t link);
+
+/*******************************************************************************
+ * Function to fill the RSSI and SNR of a downlink from the link margin
+ *
+ * @param[in] link Link index
+ * @param[out] desc Downlink descriptor
+ ******************************************************************************/
+static void emu_rx_quality(uint32_t link, struct sid_msg_desc *desc);
+
+// -----------------------------------------------------------------------------
+//                                Global Variables
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+//                                Static Variables
+// -----------------------------------------------------------------------------
+
+static const sid_emu_config_t *emu_config;
+static struct sid_handle emu;
+static const char *const emu_link_names[HOST_LINK_COUNT] = { "ble", "fsk", "css" };
+static bool emu_outage[HOST_LINK_COUNT];
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+
+void sid_emu_default_config(sid_emu_config_t *config)
+{
+  static const sid_emu_link_config_t defaults[HOST_LINK_COUNT] = {
+    { true, 255U, 2000U, 50U, 200U, 0U, 0U, 0U, 0U, 4U, 0U, 0U, 0U },
+    { true, 200U, 3000U, 300U, 1500U, 0U, 0U, 0U, 0U, 4U, 0U, 0U, 0U },
+    { true, 19U, 5000U, 1500U, 6000U, 0U, 0U, 0U, 0U, 2U, 0U, 0U, 0U },
+  };
+
+  memset(config, 0, sizeof(*config));
+  memcpy(config->links, defaults, sizeof(defaults));
+  config->registration_ms = 4000U;
+  config->time_sync = true;
+  config->time_sync_ms = 1000U;
+}
+
+void sid_emu_configure(const sid_emu_config_t *config)
+{
+  emu_config = config;
+}
+
+bool sid_emu_parse_link(sid_emu_link_config_t *link, const char *spec)
+{
+  char buffer[128];
+  if (strlen(spec) >= sizeof(buffer)) {
+    return false;
+  }
+  strcpy(buffer, spec);
+
+  for (char *save = NULL, *item = strtok_r(buffer, ",", &save); item != NULL; item = strtok_r(NULL, ",", &save)) {
+    char *value = strchr(item, '=');
+    if (strcmp(item, "off") == 0) {
+      link->available = false;
+      continue;
+    }
+    if (value == NULL) {
+      return false;
+    }
+    *value++ = '\0';
+
+    char *end = NULL;
+    unsigned long first = strtoul(value, &end, 10);
+    unsigned long second = first;
+    if (end == value) {
+      return false;
+    }
+    if (*end == '-' || *end == '/') {
+      char *rest = end + 1;
+      second = strtoul(rest, &end, 10);
+      if (end == rest) {
+        return false;
+      }
+    }
+    if (*end != '\0') {
+      return false;
+    }
+
+    if (strcmp(item, "mtu") == 0 && first > 0U && first <= UINT8_MAX) {
+      link->mtu = (uint16_t)first;
+    } else if (strcmp(item, "ready") == 0) {
+      link->ready_ms = (uint32_t)first;
+    } else if (strcmp(item, "latency") == 0 && first <= second) {
+      link->latency_min_ms = (uint32_t)first;
+      link->latency_max_ms = (uint32_t)second;
+    } else if (strcmp(item, "loss") == 0 && first <= 100U) {
+      link->loss_pct = (uint8_t)first;
+    } else if (strcmp(item, "ack_loss") == 0 && first <= 100U) {
+      link->ack_loss_pct = (uint8_t)first;
+    } else if (strcmp(item, "flap") == 0) {
+      link->up_ms = (uint32_t)first;
+      link->down_ms = (uint32_t)second;
+    } else if (strcmp(item, "queue") == 0 && first > 0U && first <= EMU_MAX_IN_FLIGHT) {
+      link->queue_len = (uint8_t)first;
+    } else if (strcmp(item, "margin") == 0 && first <= 100U) {
+      link->margin_db = (uint8_t)first;
+    } else if (strcmp(item, "fade") == 0 && first <= 30U) {
+      link->fade_db = (uint8_t)first;
+    } else if (strcmp(item, "start_fail") == 0 && first <= 100U) {
+      link->start_fail_pct = (uint8_t)first;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+void sid_emu_set_outage(sid_emu_link_t link, bool outage)
+{
+  uint32_t bit = 1UL << link;
+
+  if (emu_outage[link] == outage) {
+    return;
+  }
+  emu_outage[link] = outage;
+  HOST_LOG("info", "emu: %s gateway %s", emu_link_names[link], outage ? "out of range" : "back in range");
+  if (!emu.initialized || (emu.started_mask & bit) == 0U) {
+    return;
+  }
+
+  host_sim_cancel(emu.link_event[link]);
+  emu.link_event[link] = 0U;
+  if (outage) {
+    emu.up_mask &= ~bit;
+    emu_update_status();
+  } else if (bit != SID_LINK_TYPE_1 || emu.connection_request) {
+    emu_schedule_link(link, true, emu_config->links[link].ready_ms);
+  }
+}
+
+void sid_emu_downlink(sid_emu_link_t link, uint16_t size)
+{
+  uint32_t bit = 1UL << link;
+
+  if (!emu.initialized || (emu.up_mask & emu.started_mask & bit) == 0U || emu.reported.state != SID_STATE_READY) {
+    HOST_LOG("info", "emu: %s downlink of %u bytes dropped, link not up", emu_link_names[link], (unsigned int)size);
+    return;
+  }
+
+  emu_pending_t pending = {
+    .type = EMU_CB_RECEIVED,
+    .desc = {
+      .link_type = (enum sid_link_type)bit,
+      .type = SID_MSG_TYPE_NOTIFY,
+      .link_mode = SID_LINK_MODE_CLOUD,
+      .id = (uint16_t)(++emu.downlink_count),
+    },
+    .size = (size <= EMU_MAX_DOWNLINK_SIZE) ? size : EMU_MAX_DOWNLINK_SIZE,
+  };
+  emu_rx_quality(link, &pending.desc);
+  host_world->stats.downlinks++;
+  emu_post(&pending);
+}
+
+sid_error_t sid_init(const struct sid_config *config, struct sid_handle **handle)
+{
+  if (config == NULL || handle == NULL || emu_config == NULL) {
+    return SID_ERROR_NULL_POINTER;
+  }
+  if (emu.initialized) {
+    return SID_ERROR_INVALID_STATE;
+  }
+  memset(&emu, 0, sizeof(emu));
+  emu.initialized = true;
+  emu.config = *config;
+  emu.next_id = 1U;
+  *handle = &emu;
+  // Blocking, the events falling due meanwhile run once it returns
+  host_world->now_ms += emu_config->init_ms;
+  return SID_ERROR_NONE;
+}
+
+sid_error_t sid_deinit(struct sid_handle *handle)
+{
+  if (handle != &emu || !emu.initialized) {
+    return SID_ERROR_UNINITIALIZED;
+  }
+  emu_stop_links(emu.started_mask);
+  host_sim_cancel(emu.downlink_event);
+  emu.initialized = false;
+  return SID_ERROR_NONE;
+}
+
+sid_error_t sid_start(struct sid_handle *handle, uint32_t link_mask)
+{
+  if (handle != &emu || !emu.initialized) {
+    return SID_ERROR_UNINITIALIZED;
+  }
+  if ((link_mask & ~emu.config.link_mask) != 0U || link_mask == 0U) {
+    return SID_ERROR_INVALID_ARGS;
+  }
+  for (uint32_t link = 0U; link < HOST_LINK_COUNT; link++) {
+    if ((link_mask & (1UL << link)) != 0U && host_sim_chance(emu_config->links[link].start_fail_pct)) {
+      // Radio that does not come up, the stack stays initialized
+      host_world->stats.start_errors++;
+      return SID_ERROR_GENERIC;
+    }
+  }
+
+  for (uint32_t link = 0U; link < HOST_LINK_COUNT; link++) {
+    uint32_t bit = 1UL << link;
+    if ((link_mask & bit) == 0U || (emu.started_mask & bit) != 0U) {
+      continue;
+    }
+    emu.started_mask |= bit;
+    // BLE waits for a connection request, sub-GHz gateways beacon on their own
+    if (bit != SID_LINK_TYPE_1 || emu.connection_request) {
+      emu_schedule_link(link, true, emu_config->links[link].ready_ms);
+    }
+  }
+
+  if (emu_config->downlink_every_ms != 0U && emu.downlink_event == 0U) {
+    emu.downlink_event = host_sim_schedule(emu_config->downlink_every_ms, emu_downlink, NULL);
+  }
+  emu_update_status();
+  return SID_ERROR_NONE;
+}
+
+sid_error_t sid_stop(struct sid_handle *handle, uint32_t link_mask)
+{
+  if (handle != &emu || !emu.initialized) {
+    return SID_ERROR_UNINITIALIZED;
+  }
+  emu_stop_links(link_mask & emu.started_mask);
+  emu_update_status();
+  return SID_ERROR_NONE;
+}
+
+sid_error_t sid_process(struct sid_handle *handle)
+{
+  if (handle != &emu || !emu.initialized) {
+    return SID_ERROR_UNINITIALIZED;
+  }
+
+  struct sid_event_callbacks *callbacks = emu.config.callbacks;
+  // Callbacks may post more work, only drain what was there on entry
+  uint32_t count = emu.pending_count;
+  while (count-- > 0U && emu.initialized) {
+    emu_pending_t pending = emu.pending[emu.pending_head];
+    emu.pending_head = (emu.pending_head + 1U) % EMU_MAX_PENDING;
+    emu.pending_count--;
+
+    switch (pending.type) {
+      case EMU_CB_STATUS:
+        callbacks->on_status_changed(&pending.status, callbacks->context);
+        break;
+      case EMU_CB_SENT:
+        host_world->stats.sent_callbacks++;
+        host_sim_note_sent();
+        callbacks->on_msg_sent(&pending.desc, callbacks->context);
+        break;
+      case EMU_CB_ERROR:
+        host_world->stats.error_callbacks++;
+        callbacks->on_send_error(pending.error, &pending.desc, callbacks->context);
+        break;
+      case EMU_CB_RECEIVED: {
+        struct sid_msg msg = { .data = pending.data, .size = pending.size };
+        callbacks->on_msg_received(&pending.desc, &msg, callbacks->context);
+        break;
+      }
+      case EMU_CB_FACTORY_RESET:
+        callbacks->on_factory_reset(callbacks->context);
+        break;
+    }
+  }
+  return SID_ERROR_NONE;
+}
+
+sid_error_t sid_put_msg(struct sid_handle *handle, const struct sid_msg *msg, struct sid_msg_desc *msg_desc)
+{
+  if (handle != &emu || !emu.initialized) {
+    return SID_ERROR_UNINITIALIZED;
+  }
+  if (msg == NULL || msg_desc == NULL || msg->data == NULL || msg->size == 0U) {
+    return SID_ERROR_NULL_POINTER;
+  }
+
+  uint32_t ready = emu.up_mask & emu.started_mask;
+  uint32_t bit = (uint32_t)msg_desc->link_type;
+  if (msg_desc->link_type == SID_LINK_TYPE_ANY) {
+    bit = ready & (~ready + 1U);
+  }
+  uint32_t link = 0U;
+  while (link < HOST_LINK_COUNT && bit != (1UL << link)) {
+    link++;
+  }
+  if (link == HOST_LINK_COUNT || (emu.started_mask & bit) == 0U) {
+    host_world->stats.put_errors++;
+    return SID_ERROR_INVALID_ARGS;
+  }
+  if ((ready & bit) == 0U || emu.reported.state != SID_STATE_READY) {
+    host_world->stats.put_errors++;
+    return SID_ERROR_PORT_NOT_OPEN;
+  }
+  const sid_emu_link_config_t *link_config = &emu_config->links[link];
+  if (msg->size > link_config->mtu) {
+    host_world->stats.put_errors++;
+    return SID_ERROR_PARAM_OUT_OF_RANGE;
+  }
+
+  emu_in_flight_t *slot = NULL;
+  for (uint32_t i = 0U; i < EMU_MAX_IN_FLIGHT && slot == NULL; i++) {
+    if (!emu.in_flight[i].used) {
+      slot = &emu.in_flight[i];
+    }
+  }
+  if (slot == NULL || emu.queued[link] >= link_config->queue_len) {
+    host_world->stats.put_errors++;
+    return SID_ERROR_OUT_OF_RESOURCES;
+  }
+
+  msg_desc->link_type = (enum sid_link_type)bit;
+  msg_desc->id = emu.next_id++;
+  if (emu.next_id == 0U) {
+    emu.next_id = 1U;
+  }
+
+  slot->used = true;
+  slot->link = link;
+  slot->desc = *msg_desc;
+  slot->size = msg->size;
+  slot->backoff_db = emu.backoff_db[link];
+  slot->retries_left = msg_desc->msg_desc_attr.tx_attr.request_ack ? msg_desc->msg_desc_attr.tx_attr.num_retries : 0U;
+  slot->delivered = false;
+  memcpy(slot->data, msg->data, msg->size);
+  slot->event = host_sim_schedule(host_sim_random_range(link_config->latency_min_ms, link_config->latency_max_ms),
+                                  emu_uplink_done,
+                                  slot);
+  emu.queued[link]++;
+  host_world->stats.put[link]++;
+  return SID_ERROR_NONE;
+}
+
+sid_error_t sid_get_mtu(struct sid_handle *handle, enum sid_link_type link_type, size_t *mtu)
+{
+  if (handle != &emu || !emu.initialized) {
+    return SID_ERROR_UNINITIALIZED;
+  }
+  for (uint32_t link = 0U; link < HOST_LINK_COUNT; link++) {
+    if ((uint32_t)link_type == (1UL << link)) {
+      *mtu = emu_config->links[link].mtu;
+      return SID_ERROR_NONE;
+    }
+  }
+  return SID_ERROR_INVALID_ARGS;
+}
+
+sid_error_t sid_get_time(struct sid_handle *handle, enum sid_time_format format, struct sid_timespec *curr_time)
+{
+  (void)format;
+  if (handle != &emu || !emu.initialized) {
+    return SID_ERROR_UNINITIALIZED;
+  }
+  if (!emu.time_synced) {
+    return SID_ERROR_UNINITIALIZED;
+  }
+  uint32_t now_ms = host_sim_now_ms();
+  curr_time->tv_sec = EMU_TIME_BASE_S + now_ms / 1000U;
+  curr_time->tv_nsec = (now_ms % 1000U) * 1000000UL;
+  return SID_ERROR_NONE;
+}
+
+sid_error_t sid_get_status(struct sid_handle *handle, struct sid_status *current_status)
+{
+  if (handle != &emu || !emu.initialized) {
+    return SID_ERROR_UNINITIALIZED;
+  }
+  emu_update_status();
+  *current_status = emu.reported;
+  return SID_ERROR_NONE;
+}
+
+sid_error_t sid_set_factory_reset(struct sid_handle *handle)
+{
+  if (handle != &emu || !emu.initialized) {
+    return SID_ERROR_UNINITIALIZED;
+  }
+  // The cloud forgets the device with its keys
+  host_world->network_registered = false;
+  emu_post(&(emu_pending_t){ .type = EMU_CB_FACTORY_RESET });
+  return SID_ERROR_NONE;
+}
+
+sid_error_t sid_option(struct sid_handle *handle, enum sid_option option, void *data, size_t len)
+{
+  (void)option;
+  (void)data;
+  (void)len;
+  if (handle != &emu || !emu.initialized) {
+    return SID_ERROR_UNINITIALIZED;
+  }
+  return SID_ERROR_NONE;
+}
+
+sid_error_t sid_ble_bcn_connection_request(struct sid_handle *handle, bool set)
+{
+  if (handle != &emu || !emu.initialized) {
+    return SID_ERROR_UNINITIALIZED;
+  }
+  if ((emu.started_mask & SID_LINK_TYPE_1) == 0U) {
+    return SID_ERROR_INVALID_STATE;
+  }
+  // Clearing the request stops beaconing, the connection itself stays
+  if (set && !emu.connection_request && (emu.up_mask & SID_LINK_TYPE_1) == 0U) {
+    emu_schedule_link(SID_EMU_LINK_BLE, true, emu_config->links[SID_EMU_LINK_BLE].ready_ms);
+  }
+  emu.connection_request = set;
+  return SID_ERROR_NONE;
+}
+
+sid_error_t sid_get_error(struct sid_handle *handle)
+{
+  (void)handle;
+  return SID_ERROR_NONE;
+}
+
+sid_error_t sid_platform_deinit(void)
+{
+  return SID_ERROR_NONE;
+}
+
+int32_t sid_pal_radio_set_tx_power(int8_t power)
+{
+  // FSK and CSS share the radio
+  int32_t backoff = APP_TX_POWER_SUBGHZ_MAX_DBM - power;
+  emu.backoff_db[SID_EMU_LINK_FSK] = (backoff > 0) ? backoff : 0;
+  emu.backoff_db[SID_EMU_LINK_CSS] = emu.backoff_db[SID_EMU_LINK_FSK];
+  return RADIO_ERROR_NONE;
+}
+
+int32_t sid_pal_radio_sleep(uint32_t sleep_ms)
+{
+  // The emulated links come back up the same way after any sleep
+  (void)sleep_ms;
+  return RADIO_ERROR_NONE;
+}
+
+sl_status_t sl_bt_system_set_tx_power(int16_t min_power, int16_t max_power, int16_t *set_min, int16_t *set_max)
+{
+  int32_t backoff = APP_TX_POWER_BLE_MAX_DBM - (max_power / 10);
+  emu.backoff_db[SID_EMU_LINK_BLE] = (backoff > 0) ? backoff : 0;
+  *set_min = min_power;
+  *set_max = max_power;
+  return SL_STATUS_OK;
+}
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+
+static void emu_link_up(void *arg)
+{
+  uint32_t link = (uint32_t)(uintptr_t)arg;
+  const sid_emu_link_config_t *link_config = &emu_config->links[link];
+  emu.link_event[link] = 0U;
+  if (!link_config->available || emu_outage[link]) {
+    return;
+  }
+
+  emu.up_mask |= 1UL << link;
+  HOST_LOG("info", "emu: %s link up", emu_link_names[link]);
+  if (link_config->up_ms != 0U) {
+    emu_schedule_link(link, false, host_sim_random_range(link_config->up_ms / 2U, link_config->up_ms * 3U / 2U));
+  }
+  // CSS cannot carry the registration exchange
+  if (!host_world->network_registered && link != SID_EMU_LINK_CSS && emu.registration_event == 0U) {
+    emu.registration_event = host_sim_schedule(emu_config->registration_ms, emu_registered, NULL);
+  }
+  if (emu_config->time_sync && !emu.time_synced && emu.time_sync_event == 0U) {
+    emu.time_sync_event = host_sim_schedule(emu_config->time_sync_ms, emu_time_synced, NULL);
+  }
+  emu_update_status();
+}
+
+static void emu_link_down(void *arg)
+{
+  uint32_t link = (uint32_t)(uintptr_t)arg;
+  emu.link_event[link] = 0U;
+  emu.up_mask &= ~(1UL << link);
+  HOST_LOG("info", "emu: %s link down", emu_link_names[link]);
+  emu_schedule_link(link,
+                    true,
+                    host_sim_random_range(emu_config->links[link].down_ms / 2U, emu_config->links[link].down_ms * 3U / 2U));
+  emu_update_status();
+}
+
+static void emu_registered(void *arg)
+{
+  (void)arg;
+  emu.registration_event = 0U;
+  if ((emu.up_mask & emu.started_mask & (SID_LINK_TYPE_1 | SID_LINK_TYPE_2)) == 0U) {
+    return;
+  }
+  host_world->network_registered = true;
+  HOST_LOG("info", "emu: device registered");
+  emu_update_status();
+}
+
+static void emu_time_synced(void *arg)
+{
+  (void)arg;
+  emu.time_sync_event = 0U;
+  if ((emu.up_mask & emu.started_mask) == 0U) {
+    return;
+  }
+  emu.time_synced = true;
+  emu_update_status();
+}
+
+static void emu_downlink(void *arg)
+{
+  (void)arg;
+  emu.downlink_event = host_sim_schedule(emu_config->downlink_every_ms, emu_downlink, NULL);
+  uint32_t ready = emu.up_mask & emu.started_mask;
+  if (ready == 0U || emu.reported.state != SID_STATE_READY) {
+    return;
+  }
+
+  emu_pending_t pending = {
+    .type = EMU_CB_RECEIVED,
+    .desc = {
+      .link_type = (enum sid_link_type)(ready & (~ready + 1U)),
+      .type = SID_MSG_TYPE_NOTIFY,
+      .link_mode = SID_LINK_MODE_CLOUD,
+      .id = (uint16_t)(++emu.downlink_count),
+    },
+  };
+  pending.size = (size_t)snprintf((char *)pending.data, sizeof(pending.data), "downlink %lu", (unsigned long)emu.downlink_count);
+  emu_rx_quality((uint32_t)__builtin_ctz(ready), &pending.desc);
+  host_world->stats.downlinks++;
+  emu_post(&pending);
+}
+
+static void emu_uplink_done(void *arg)
+{
+  emu_in_flight_t *slot = (emu_in_flight_t *)arg;
+  const sid_emu_link_config_t *link_config = &emu_config->links[slot->link];
+  emu_pending_t pending = { .type = EMU_CB_SENT, .desc = slot->desc };
+  bool request_ack = slot->desc.msg_desc_attr.tx_attr.request_ack;
+
+  bool link_up = (emu.up_mask & (1UL << slot->link)) != 0U;
+  bool received = link_up && (emu_config->channel == NULL
+                              || emu_config->channel((sid_emu_link_t)slot->link, slot->size, link_config->mtu));
+  if (received && link_config->margin_db != 0U && emu_margin(slot->link) < slot->backoff_db) {
+    // Sent too far below full power to reach the gateway
+    host_world->stats.below_margin++;
+    received = false;
+  }
+
+  bool acked = false;
+  if (received && !host_sim_chance(link_config->loss_pct)) {
+    acked = !request_ack || !host_sim_chance(link_config->ack_loss_pct);
+    if (!acked) {
+      host_world->stats.acks_lost++;
+    }
+  } else {
+    received = false;
+  }
+  if (received && !slot->delivered) {
+    slot->delivered = true;
+    host_world->stats.delivered[slot->link]++;
+    host_world->stats.delivered_bytes += (uint32_t)slot->size;
+    if (emu_config->uplink_log != NULL) {
+      fprintf(emu_config->uplink_log, "%lu %s ", (unsigned long)host_sim_now_ms(), emu_link_names[slot->link]);
+      for (size_t i = 0U; i < slot->size; i++) {
+        fprintf(emu_config->uplink_log, "%02x", slot->data[i]);
+      }
+      fputc('\n', emu_config->uplink_log);
+    }
+  }
+
+  if (request_ack && !acked && link_up && slot->retries_left != 0U) {
+    // No ack, the stack sends it again
+    slot->retries_left--;
+    host_world->stats.retries++;
+    slot->event = host_sim_schedule(host_sim_random_range(link_config->latency_min_ms, link_config->latency_max_ms),
+                                    emu_uplink_done,
+                                    slot);
+    return;
+  }
+  slot->used = false;
+  emu.queued[slot->link]--;
+
+  // Without ack the stack cannot tell an uplink lost on air from a delivered one
+  if (!link_up || (request_ack && !acked)) {
+    pending.type = EMU_CB_ERROR;
+    pending.error = SID_ERROR_TIMEOUT;
+  }
+  emu_post(&pending);
+}
+
+static int32_t emu_margin(uint32_t link)
+{
+  const sid_emu_link_config_t *link_config = &emu_config->links[link];
+
+  if (link_config->fade_db == 0U) {
+    return link_config->margin_db;
+  }
+  return (int32_t)link_config->margin_db - link_config->fade_db
+         + (int32_t)host_sim_random_range(0U, 2U * link_config->fade_db);
+}
+
+static void emu_rx_quality(uint32_t link, struct sid_msg_desc *desc)
+{
+  if (emu_config->links[link].margin_db == 0U) {
+    return;
+  }
+
+  int32_t margin = emu_margin(link);
+  switch (link) {
+    case SID_EMU_LINK_BLE:
+      desc->msg_desc_attr.rx_attr.rssi = (int8_t)(APP_TX_POWER_BLE_SENSITIVITY_DBM + margin);
+      break;
+    case SID_EMU_LINK_FSK:
+      desc->msg_desc_attr.rx_attr.rssi = (int8_t)(APP_TX_POWER_FSK_SENSITIVITY_DBM + margin);
+      break;
+    default:
+      desc->msg_desc_attr.rx_attr.rssi = (int8_t)(EMU_CSS_SENSITIVITY_DBM + margin);
+      desc->msg_desc_attr.rx_attr.snr = (int8_t)(APP_TX_POWER_CSS_SNR_MIN_DB + margin);
+      break;
+  }
+}
+
+static void emu_post(const emu_pending_t *pending)
+{
+  if (emu.pending_count == EMU_MAX_PENDING) {
+    HOST_LOG("error", "emu: callback queue full, dropped type %d", (int)pending->type);
+    return;
+  }
+  emu.pending[(emu.pending_head + emu.pending_count) % EMU_MAX_PENDING] = *pending;
+  emu.pending_count++;
+  emu.config.callbacks->on_event(false, emu.config.callbacks->context);
+}
+
+static void emu_update_status(void)
+{
+  struct sid_status status = {
+    .detail = {
+      .registration_status = host_world->network_registered ? SID_STATUS_REGISTERED : SID_STATUS_NOT_REGISTERED,
+      .time_sync_status = emu.time_synced ? SID_STATUS_TIME_SYNCED : SID_STATUS_NO_TIME,
+      .link_status_mask = emu.up_mask & emu.started_mask,
+    },
+  };
+  bool ready = status.detail.link_status_mask != 0U
+               && status.detail.registration_status == SID_STATUS_REGISTERED
+               && status.detail.time_sync_status == SID_STATUS_TIME_SYNCED;
+  status.state = ready ? SID_STATE_READY : SID_STATE_NOT_READY;
+
+  if (emu.reported_valid && memcmp(&status, &emu.reported, sizeof(status)) == 0) {
+    return;
+  }
+  if (ready && (!emu.reported_valid || emu.reported.state != SID_STATE_READY)
+      && host_world->stats.ready_boots < host_world->stats.boots) {
+    host_world->stats.first_ready_ms += host_sim_now_ms() - host_world->boot_ms;
+    host_world->stats.ready_boots++;
+  }
+  emu.reported = status;
+  emu.reported_valid = true;
+  emu_post(&(emu_pending_t){ .type = EMU_CB_STATUS, .status = status });
+}
+
+static void emu_schedule_link(uint32_t link, bool up, uint32_t delay_ms)
+{
+  host_sim_cancel(emu.link_event[link]);
+  emu.link_event[link] = host_sim_schedule(delay_ms, up ? emu_link_up : emu_link_down, (void *)(uintptr_t)link);
+}
+
+static void emu_stop_links(uint32_t link_mask)
+{
+  for (uint32_t link = 0U; link < HOST_LINK_COUNT; link++) {
+    if ((link_mask & (1UL << link)) == 0U) {
+      continue;
+    }
+    host_sim_cancel(emu.link_event[link]);
+    emu.link_event[link] = 0U;
+    for (uint32_t i = 0U; i < EMU_MAX_IN_FLIGHT; i++) {
+      if (emu.in_flight[i].used && emu.in_flight[i].link == link) {
+        host_sim_cancel(emu.in_flight[i].event);
+        emu.in_flight[i].used = false;
+      }
+    }
+    emu.queued[link] = 0U;
+  }
+  emu.started_mask &= ~link_mask;
+  emu.up_mask &= ~link_mask;
+  if (emu.started_mask == 0U) {
+    host_sim_cancel(emu.registration_event);
+    host_sim_cancel(emu.time_sync_event);
+    emu.registration_event = 0U;
+    emu.time_sync_event = 0U;
+  }
+}
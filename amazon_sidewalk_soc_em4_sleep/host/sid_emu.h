@@ -0,0 +1,144 @@
+/***************************************************************************//**
+ * @file
+ * @brief sid_emu.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef SID_EMU_H
+#define SID_EMU_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "host_sim.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+// Link indexes of the configuration
+typedef enum {
+  SID_EMU_LINK_BLE = 0,
+  SID_EMU_LINK_FSK,
+  SID_EMU_LINK_CSS,
+} sid_emu_link_t;
+
+// Behavior of the network on one link
+typedef struct {
+  bool available;             // A gateway is in range
+  uint16_t mtu;
+  uint32_t ready_ms;          // Start to link up, BLE: connection request to link up
+  uint32_t latency_min_ms;    // Put to sent callback, drawn uniformly
+  uint32_t latency_max_ms;
+  uint8_t loss_pct;           // Uplinks that never reach the cloud
+  uint8_t ack_loss_pct;       // Acks lost, the uplink still reached the cloud
+  uint32_t up_ms;             // Mean time up before the link drops, 0: never drops
+  uint32_t down_ms;           // Mean time down before the link is back
+  uint8_t queue_len;          // Uplinks the stack holds at the same time
+  uint8_t margin_db;          // Margin at full TX power, downlinks report it and uplinks sent
+                              // further below full power are lost, 0: not modeled
+  uint8_t fade_db;            // Margin of each message drawn within +/- fade
+  uint8_t start_fail_pct;     // sid_start() calls on the link that fail
+} sid_emu_link_config_t;
+
+typedef struct {
+  sid_emu_link_config_t links[HOST_LINK_COUNT];
+  uint32_t init_ms;           // Time sid_init() takes, the caller is blocked
+  uint32_t registration_ms;   // Registration link up to registered
+  bool time_sync;             // The network provides time, the stack is ready only once synced
+  uint32_t time_sync_ms;      // Link up to time synced
+  uint32_t downlink_every_ms; // Period of the cloud downlinks, 0: none
+  FILE *uplink_log;           // Delivered uplinks as "<time ms> <link> <hex>", NULL: none
+  // Channel shared with other devices, called when an uplink ends on a link
+  // that is up. Returns #false if the uplink was lost. NULL: none.
+  bool (*channel)(sid_emu_link_t link, size_t size, uint16_t mtu);
+} sid_emu_config_t;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/*******************************************************************************
+ * Function to get the default network, every link available and lossless
+ *
+ * @param[out] config Network configuration
+ ******************************************************************************/
+void sid_emu_default_config(sid_emu_config_t *config);
+
+/*******************************************************************************
+ * Function to set the network used by the next sid_init()
+ *
+ * @param[in] config Network configuration, kept by reference
+ ******************************************************************************/
+void sid_emu_configure(const sid_emu_config_t *config);
+
+/*******************************************************************************
+ * Function to update a link from a "key=value,..." description
+ *
+ * Keys: mtu, ready, latency (min-max ms), loss, ack_loss (%), flap (up/down
+ * ms), queue, margin, fade (dB), start_fail (%), off.
+ *
+ * @param[in,out] link Link configuration
+ * @param[in] spec Description
+ *
+ * @returns #false on a malformed description
+ ******************************************************************************/
+bool sid_emu_parse_link(sid_emu_link_config_t *link, const char *spec);
+
+/*******************************************************************************
+ * Function to force a link out of range, on top of its configuration
+ *
+ * Holds for the current boot, a started link comes back up after its ready
+ * time once the outage ends.
+ *
+ * @param[in] link Link index
+ * @param[in] outage The gateway is out of range
+ ******************************************************************************/
+void sid_emu_set_outage(sid_emu_link_t link, bool outage);
+
+/*******************************************************************************
+ * Function to send a downlink from the cloud now
+ *
+ * Dropped unless the link is up and the stack ready.
+ *
+ * @param[in] link Link index
+ * @param[in] size Payload size, zero filled
+ ******************************************************************************/
+void sid_emu_downlink(sid_emu_link_t link, uint16_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SID_EMU_H
@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Zlib
+# Copyright 2023 Silicon Laboratories Inc. www.silabs.com
+"""Decode the diagnostic fields appended by app_diag.c.
+
+Each input line holds one uplink payload in hex, optionally prefixed by a
+device identifier. Counter updates carry the diagnostics after the 10 byte
+counter string, alarms after the 4 byte alarm header, reports right after
+the series block. Fields are printed as CSV:
+
+    device,field,value
+
+Usage: diag_decode.py [FILE]   (stdin when FILE is omitted)
+"""
+
+import sys
+
+from series_decode import SERIES_TYPE, decode_block
+
+DIAG_MARKER = 0xDA
+COUNTER_SIZE = 10
+ALARM_MARKER = 0x02
+ALARM_SIZE = 4
+
+# id: (name, size, signed)
+FIELDS = {
+    1: ("wake_count", 2, False),
+    2: ("reset_cause", 4, False),
+    3: ("supply_mv", 2, False),
+    4: ("last_error", 1, True),
+    5: ("link_status", 1, False),
+    6: ("rendezvous", 4, False),
+    7: ("tx_power_dbm", 1, True),
+    8: ("stack_restarts", 2, False),
+    9: ("recovery_s", 2, False),
+    10: ("battery_tier", 1, False),
+}
+
+
+def decode(payload):
+    """Return the diagnostic fields of one uplink as a list of (name, value)."""
+    if payload and payload[0] == SERIES_TYPE:
+        offset = decode_block(payload)[1]
+    elif payload and payload[0] == ALARM_MARKER:
+        offset = ALARM_SIZE
+    else:
+        offset = COUNTER_SIZE
+    if offset >= len(payload) or payload[offset] != DIAG_MARKER:
+        return []
+
+    fields = []
+    pos = offset + 1
+    while pos < len(payload):
+        if payload[pos] not in FIELDS:
+            raise ValueError("unknown field %d" % payload[pos])
+        name, size, signed = FIELDS[payload[pos]]
+        raw = payload[pos + 1:pos + 1 + size]
+        if len(raw) != size:
+            raise ValueError("truncated field %s" % name)
+        fields.append((name, int.from_bytes(raw, "big", signed=signed)))
+        pos += 1 + size
+    return fields
+
+
+def main():
+    stream = open(sys.argv[1]) if len(sys.argv) > 1 else sys.stdin
+    print("device,field,value")
+    for line in stream:
+        items = line.split()
+        if not items:
+            continue
+        device = items[0] if len(items) > 1 else ""
+        try:
+            fields = decode(bytes.fromhex(items[-1]))
+        except ValueError as error:
+            print("skipped %s: %s" % (items[-1], error), file=sys.stderr)
+            continue
+        for name, value in fields:
+            print("%s,%s,%d" % (device, name, value))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Zlib
+# Copyright 2023 Silicon Laboratories Inc. www.silabs.com
+"""Check the EM4 pin table of em4_pins.c against a board pin configuration.
+
+The table entries name pins by their configuration prefix, <name>_PORT and
+<name>_PIN. They are resolved from the headers of a generated project (the
+config/ and autogen/ directories for one board of templates.xml) and em4_mode.h:
+
+    em4_pins_check.py [--family xg24|xg28] [--part-header FILE] DIR|FILE...
+
+Errors, exit status 1:
+    floating     input without pull that is not pulled on the board
+    conflict     two entries on one pin
+    wake         wake-up source that is not an EM4WU pin or not an input
+    range        pin that does not exist on the part
+Warnings:
+    retention    pulled or driven pin without EM4_PIN_RETAIN, it floats in EM4
+    shared       entry on a pin the board also uses for something else
+    unlisted     chip select, enable or reset line left to the disabled default
+
+EM4WU pins come from the part header when given (GPIO_EM4WUn_PORT/PIN), from
+the family otherwise.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+TABLE = os.path.join(HERE, "..", "em4_pins.c")
+EM4_MODE = os.path.join(HERE, "..", "em4_mode.h")
+
+# Pins per port, A to D
+PORT_WIDTH = {"xg24": (10, 6, 10, 6), "xg28": (10, 7, 12, 6)}
+# EM4WU index: (port, pin)
+EM4WU = {
+    "xg24": {0: (0, 5), 3: (1, 1), 4: (1, 3), 6: (2, 0), 7: (2, 5), 8: (2, 7), 9: (3, 2)},
+    "xg28": {0: (0, 5), 3: (1, 1), 4: (1, 3), 6: (2, 0), 7: (2, 5), 8: (2, 7), 9: (3, 2)},
+}
+
+DEFINE_RE = re.compile(r"^\s*#\s*define\s+(\w+?)_(PORT|PIN)\s+\(?\s*([\w]+)\s*\)?")
+PORT_RE = re.compile(r"^(?:gpioPort|SL_GPIO_PORT_|GPIO_P)([A-D])(?:_INDEX)?$")
+ENTRY_RE = re.compile(r"^\s*EM4_PIN\((\w+),\s*(\w+),\s*(\d+),\s*([\w |]+)\)")
+WU_RE = re.compile(r"^\s*#\s*define\s+GPIO_EM4WU(\d+)_(PORT|PIN)\s+\(?\s*(\w+?)U?\s*\)?\s*(?:/|$)")
+ATTENTION_RE = re.compile(r"(_CS|_EN|ENABLE|RESET|_SD|SHUTDOWN)")
+
+
+def parse_port(value):
+    match = PORT_RE.match(value)
+    if match:
+        return ord(match.group(1)) - ord("A")
+    if value.isdigit():
+        return int(value)
+    return None
+
+
+def pin_name(pin):
+    return "P%s%02d" % (chr(ord("A") + pin[0]), pin[1])
+
+
+def read_pins(paths):
+    """Return {prefix: (port, pin)} from the headers."""
+    values = {}
+    files = []
+    for path in paths:
+        if os.path.isdir(path):
+            files += [os.path.join(root, name) for root, _, names in os.walk(path)
+                      for name in names if name.endswith(".h")]
+        else:
+            files.append(path)
+    for path in files:
+        with open(path, errors="replace") as stream:
+            for line in stream:
+                match = DEFINE_RE.match(line)
+                if match:
+                    values.setdefault(match.group(1), {})[match.group(2)] = match.group(3).rstrip("U")
+    pins = {}
+    for prefix, fields in values.items():
+        if "PORT" not in fields or "PIN" not in fields:
+            continue
+        port = parse_port(fields["PORT"])
+        if port is not None and fields["PIN"].isdigit():
+            pins[prefix] = (port, int(fields["PIN"]))
+    return pins
+
+
+def read_em4wu(path):
+    found = {}
+    with open(path, errors="replace") as stream:
+        for line in stream:
+            match = WU_RE.match(line)
+            if match:
+                value = parse_port(match.group(3)) if match.group(2) == "PORT" else int(match.group(3))
+                found.setdefault(int(match.group(1)), {})[match.group(2)] = value
+    return {index: (f["PORT"], f["PIN"]) for index, f in found.items() if len(f) == 2}
+
+
+def read_table():
+    entries = []
+    with open(TABLE) as stream:
+        for number, line in enumerate(stream, 1):
+            match = ENTRY_RE.match(line)
+            if match:
+                flags = {flag.strip() for flag in match.group(4).split("|")}
+                entries.append((number, match.group(1), match.group(2), int(match.group(3)), flags))
+    return entries
+
+
+def check(pins, entries, widths, em4wu):
+    errors = []
+    warnings = []
+    taken = {}
+    wake_pins = set(em4wu.values())
+    for number, name, mode, out, flags in entries:
+        if name not in pins:
+            # Board without this pin, the entry is compiled out
+            continue
+        pin = pins[name]
+        where = "%s (%s, em4_pins.c:%d)" % (pin_name(pin), name, number)
+        if pin[0] >= len(widths) or pin[1] >= widths[pin[0]]:
+            errors.append("range: %s does not exist on the part" % where)
+        if pin in taken:
+            errors.append("conflict: %s already set by %s" % (where, taken[pin]))
+        taken[pin] = name
+        if mode == "gpioModeInput" and "EM4_PIN_EXT_PULL" not in flags:
+            errors.append("floating: %s is an input without pull" % where)
+        if "EM4_PIN_WAKE" in flags:
+            if pin not in wake_pins:
+                errors.append("wake: %s is not an EM4WU pin" % where)
+            if not mode.startswith("gpioModeInput"):
+                errors.append("wake: %s is not an input" % where)
+        if mode not in ("gpioModeDisabled", "gpioModeInput") and "EM4_PIN_RETAIN" not in flags:
+            warnings.append("retention: %s loses its %s state in EM4" % (where, mode))
+    for name, pin in sorted(pins.items(), key=lambda item: item[1]):
+        # Part header definitions and the button instances behind the wake-up pin
+        if name in taken.values() or name.startswith("GPIO_") or name.startswith("SL_SIMPLE_BUTTON_"):
+            continue
+        if pin in taken:
+            warnings.append("shared: %s of %s is also %s" % (pin_name(pin), taken[pin], name))
+        elif ATTENTION_RE.search(name):
+            warnings.append("unlisted: %s (%s) is disabled in EM4 and may float" % (pin_name(pin), name))
+    return errors, warnings
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--family", choices=sorted(PORT_WIDTH), default="xg24")
+    parser.add_argument("--part-header")
+    parser.add_argument("paths", nargs="+")
+    args = parser.parse_args()
+
+    pins = read_pins(args.paths + [EM4_MODE])
+    em4wu = read_em4wu(args.part_header) if args.part_header else EM4WU[args.family]
+    errors, warnings = check(pins, read_table(), PORT_WIDTH[args.family], em4wu)
+    for line in warnings:
+        print("warning: " + line)
+    for line in errors:
+        print("error: " + line)
+    print("%d pins configured, %d errors, %d warnings" % (len(pins), len(errors), len(warnings)))
+    return 1 if errors else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
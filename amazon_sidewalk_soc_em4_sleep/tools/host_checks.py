@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Zlib
+# Copyright 2023 Silicon Laboratories Inc. www.silabs.com
+"""Run the host build (host/) through scenarios and check their outcome.
+
+Each check runs sid_host with its own options and inspects the uplinks that
+reached the cloud (--uplink-log) or the log. Checks print PASS or FAIL with
+the reason, the exit status is 1 if any failed.
+
+Usage: host_checks.py [SID_HOST]   (./sid_host when omitted)
+"""
+
+import os
+import re
+import struct
+import subprocess
+import sys
+import tempfile
+
+from diag_decode import ALARM_MARKER
+from segment_reassembler import HEADER_MARKER
+
+# Trace records, see app_trace.h
+TRACE_BOOT = 1
+TRACE_EVENT_BEGIN = 2
+TRACE_EVENT_END = 3
+TRACE_INPUT = 11
+TRACE_INPUT_SEND = 16
+
+CHECKS = []
+
+
+def check(function):
+    """Register a check, it returns None on success or the failure reason."""
+    CHECKS.append(function)
+    return function
+
+
+def run(host, *options):
+    """Run the host build quietly, return its log."""
+    result = subprocess.run([host] + list(options), stdout=subprocess.PIPE,
+                            stderr=subprocess.STDOUT, universal_newlines=True, check=True)
+    return result.stdout
+
+
+def uplinks(host, *options):
+    """Run the host build, return the delivered uplinks as (link, payload)."""
+    with tempfile.TemporaryDirectory() as directory:
+        path = os.path.join(directory, "uplinks.txt")
+        run(host, "--uplink-log", path, "-q", *options)
+        with open(path) as stream:
+            return [(items[1], bytes.fromhex(items[2]))
+                    for items in (line.split() for line in stream) if len(items) == 3]
+
+
+def trace_records(log):
+    """Return the records of the last trace dump of a log as tuples."""
+    dump = log[log.rindex("trace: begin"):]
+    return [struct.unpack("<IBBH", bytes.fromhex(match))
+            for match in re.findall(r"trace: ([0-9a-f]{16})\b", dump)]
+
+
+@check
+def alarm_single_frame(host):
+    """An alarm fits a 19 byte FSK frame and goes out unsegmented."""
+    frames = uplinks(host, "--duration", "600", "--send-every", "0", "--alarm-every", "120",
+                     "--link", "fsk:mtu=19", "--link", "ble:off")
+    fragments = [payload for _, payload in frames if payload and payload[0] & HEADER_MARKER]
+    alarms = [payload for _, payload in frames if payload and payload[0] == ALARM_MARKER]
+    if fragments:
+        return "%d fragments, first %s" % (len(fragments), fragments[0].hex())
+    if not alarms:
+        return "no alarm delivered"
+    if any(len(payload) > 19 for payload in alarms):
+        return "alarm larger than the MTU"
+    return None
+
+
+@check
+def send_payload_unchanged(host):
+    """A replayed `send` payload that fits the MTU reaches the cloud unchanged."""
+    records = trace_records(run(host, "--duration", "400", "--send-every", "0", "--dump-every", "300"))
+    boot_ms = [record[0] for record in records if record[1] == TRACE_BOOT][-1]
+    records.append((boot_ms + 8000, TRACE_INPUT, TRACE_INPUT_SEND, 12))
+    records.sort(key=lambda record: record[0])
+    with tempfile.TemporaryDirectory() as directory:
+        path = os.path.join(directory, "replay.log")
+        with open(path, "w") as stream:
+            stream.write("trace: begin\n")
+            for record in records:
+                stream.write("trace: %s\n" % struct.pack("<IBBH", *record).hex())
+        frames = uplinks(host, "--replay", path, "--link", "fsk:mtu=19")
+    if bytes(12) not in [payload for _, payload in frames]:
+        return "payload not delivered unchanged, got %s" % [payload.hex() for _, payload in frames]
+    return None
+
+
+@check
+def trace_reach(host):
+    """The trace kept in NVM3 reaches back hours with the events of each
+    wake-up, with one trace write per wake-up."""
+    log = run(host, "--duration", "9100", "--dump-every", "9000")
+    records = trace_records(log)
+    boots = int(re.search(r"^boots: +(\d+)", log, re.M).group(1))
+    writes = int(re.search(r"^nvm3 writes: +(\d+)", log, re.M).group(1))
+    reach_min = (records[-1][0] - records[0][0]) // 60000
+    if reach_min < 110:
+        return "trace reaches back %d min" % reach_min
+    boots_at = [index for index, record in enumerate(records) if record[1] == TRACE_BOOT]
+    oldest_wake = [record[1] for record in records[boots_at[0]:boots_at[1]]]
+    if TRACE_EVENT_BEGIN not in oldest_wake or TRACE_EVENT_END not in oldest_wake:
+        return "events of the oldest wake-up not kept"
+    # The trace and the report batch take one write per wake-up each, the
+    # registration outcome one
+    if writes > 2 * boots + 1:
+        return "%d NVM3 writes for %d boots" % (writes, boots)
+    return None
+
+
+
+@check
+def radio_sleep_warm_only(host):
+    """Without a cold start sleep in the PAL, the radio always sleeps warm."""
+    log = run(host, "--duration", "3600", "--send-every", "600")
+    depths = re.findall(r"radio transceiver put to sleep, (\w+) start", log)
+    if not depths:
+        return "radio never put to sleep, build with -DSL_RADIO_EXTERNAL"
+    if any(depth != "warm" for depth in depths):
+        return "%d of %d sleeps not warm" % (sum(depth != "warm" for depth in depths), len(depths))
+    return None
+
+
+def main():
+    host = sys.argv[1] if len(sys.argv) > 1 else "./sid_host"
+    failed = 0
+    for function in CHECKS:
+        reason = function(host)
+        print("%s %s%s" % ("FAIL" if reason else "PASS", function.__name__,
+                           ": " + reason if reason else ""))
+        failed += reason is not None
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
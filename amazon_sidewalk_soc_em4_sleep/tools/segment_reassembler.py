@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Zlib
+# Copyright 2023 Silicon Laboratories Inc. www.silabs.com
+"""Reassemble uplinks produced by the segmentation layer (app_segment.c).
+
+Each input line holds one uplink payload in hex, optionally prefixed by a
+device identifier and whitespace so several devices can share one stream:
+
+    d2a1c3 80313233
+    d2a1c3 9034
+
+Payloads whose first byte is below 0x80 were sent unsegmented and are
+returned as is. Segmented payloads start with a one byte header:
+
+    bit 7      always set
+    bits 6..5  message sequence number
+    bit 4      last fragment of the message
+    bits 3..0  fragment index
+
+Usage: segment_reassembler.py [FILE]   (stdin when FILE is omitted)
+"""
+
+import sys
+
+HEADER_MARKER = 0x80
+SEQ_SHIFT = 5
+SEQ_MASK = 0x03
+LAST = 0x10
+INDEX_MASK = 0x0F
+
+
+class Reassembler:
+    """Per device reassembly of segmented uplinks."""
+
+    def __init__(self):
+        self._partial = {}
+        self.dropped = 0
+
+    def feed(self, payload, device=""):
+        """Feed one uplink, returns the complete message or None."""
+        if not payload or (payload[0] & HEADER_MARKER) == 0:
+            return bytes(payload)
+
+        header = payload[0]
+        seq = (header >> SEQ_SHIFT) & SEQ_MASK
+        index = header & INDEX_MASK
+        key = (device, seq)
+
+        entry = self._partial.get(key)
+        if entry is not None and index in entry["fragments"]:
+            # Sequence number reused, the previous message never completed
+            self.dropped += 1
+            entry = None
+        if entry is None:
+            entry = {"fragments": {}, "last": None}
+            self._partial[key] = entry
+
+        entry["fragments"][index] = bytes(payload[1:])
+        if header & LAST:
+            entry["last"] = index
+
+        last = entry["last"]
+        if last is None or len(entry["fragments"]) != last + 1:
+            return None
+
+        del self._partial[key]
+        return b"".join(entry["fragments"][i] for i in range(last + 1))
+
+    def pending(self):
+        """Incomplete messages as (device, seq, received fragment indexes)."""
+        return [(dev, seq, sorted(entry["fragments"]))
+                for (dev, seq), entry in self._partial.items()]
+
+
+def main():
+    stream = open(sys.argv[1]) if len(sys.argv) > 1 else sys.stdin
+    reassembler = Reassembler()
+
+    for line in stream:
+        fields = line.split()
+        if not fields:
+            continue
+        device = fields[0] if len(fields) > 1 else ""
+        message = reassembler.feed(bytes.fromhex(fields[-1]), device)
+        if message is not None:
+            prefix = device + " " if device else ""
+            print(prefix + message.hex())
+
+    for device, seq, fragments in reassembler.pending():
+        print("incomplete: device %s seq %d fragments %s" % (device or "-", seq, fragments),
+              file=sys.stderr)
+    if reassembler.dropped:
+        print("dropped: %d" % reassembler.dropped, file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,169 @@
+/***************************************************************************//**
+ * @file
+ * @brief series_codec_bench.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// Host benchmark of the series codec. Build and run from the project folder:
+//   cc -O2 -I. tools/series_codec_bench.c app_series_codec.c -o series_codec_bench
+//   ./series_codec_bench
+
+// -----------------------------------------------------------------------------
+//                                   Includes
+// -----------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "app_series_codec.h"
+
+// -----------------------------------------------------------------------------
+//                              Macros and Typedefs
+// -----------------------------------------------------------------------------
+
+#define SERIES_LEN      (64U)
+#define ITERATIONS      (20000U)
+// Raw encoding: 32-bit timestamp and 32-bit value per sample
+#define RAW_SAMPLE_SIZE (8U)
+
+typedef void (*generator_t)(app_series_sample_t *samples, size_t count);
+
+// -----------------------------------------------------------------------------
+//                          Static Function Definitions
+// -----------------------------------------------------------------------------
+static uint64_t now_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+// Periodic temperature in centi-degrees, mostly flat with slow drift
+static void gen_temperature(app_series_sample_t *samples, size_t count)
+{
+  int32_t value = 2150;
+  for (size_t i = 0; i < count; i++) {
+    samples[i].timestamp = 1000000U + (uint32_t)i * 30000U;
+    if ((rand() % 8) == 0) {
+      value += (rand() % 3) - 1;
+    }
+    samples[i].value = value;
+  }
+}
+
+// Periodic samples with a few ms of timer jitter and a noisy signal
+static void gen_jittered(app_series_sample_t *samples, size_t count)
+{
+  for (size_t i = 0; i < count; i++) {
+    samples[i].timestamp = 5000U + (uint32_t)i * 1000U + (uint32_t)(rand() % 5);
+    samples[i].value = 3000 + (rand() % 200) - 100;
+  }
+}
+
+// Monotonic event counter on irregular triggers
+static void gen_counter(app_series_sample_t *samples, size_t count)
+{
+  uint32_t timestamp = 0;
+  for (size_t i = 0; i < count; i++) {
+    timestamp += 100U + (uint32_t)(rand() % 60000);
+    samples[i].timestamp = timestamp;
+    samples[i].value = (int32_t)i;
+  }
+}
+
+static int run(const char *name, generator_t generator)
+{
+  app_series_sample_t samples[SERIES_LEN];
+  app_series_sample_t decoded[SERIES_LEN];
+  uint8_t encoded[SERIES_LEN * 2U * APP_SERIES_CODEC_VARINT_MAX + 16U];
+  uint64_t encode_cycles = 0;
+  uint64_t decode_cycles = 0;
+  size_t encoded_bytes = 0;
+
+  for (uint32_t iteration = 0; iteration < ITERATIONS; iteration++) {
+    size_t encoded_count;
+    size_t decoded_count;
+
+    generator(samples, SERIES_LEN);
+
+    uint64_t start = now_cycles();
+    size_t size = app_series_encode(samples, SERIES_LEN, encoded, sizeof(encoded), &encoded_count);
+    uint64_t middle = now_cycles();
+    bool ok = app_series_decode(encoded, size, decoded, SERIES_LEN, &decoded_count);
+    uint64_t end = now_cycles();
+
+    if (encoded_count != SERIES_LEN || !ok || decoded_count != SERIES_LEN
+        || memcmp(samples, decoded, sizeof(samples)) != 0) {
+      fprintf(stderr, "%s: round trip mismatch at iteration %u\n", name, iteration);
+      return 1;
+    }
+
+    encode_cycles += middle - start;
+    decode_cycles += end - middle;
+    encoded_bytes += size;
+  }
+
+  double total_samples = (double)SERIES_LEN * ITERATIONS;
+  printf("%-12s ratio %5.2f  bytes/sample %5.2f  encode %6.1f  decode %6.1f %s/sample\n",
+         name,
+         (total_samples * RAW_SAMPLE_SIZE) / (double)encoded_bytes,
+         (double)encoded_bytes / total_samples,
+         (double)encode_cycles / total_samples,
+         (double)decode_cycles / total_samples,
+#if defined(__x86_64__) || defined(__i386__)
+         "cycles"
+#else
+         "ns"
+#endif
+         );
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//                          Public Function Definitions
+// -----------------------------------------------------------------------------
+int main(void)
+{
+  int ret = 0;
+
+  srand(1);
+  printf("%u samples per block, %u blocks, raw size %u bytes/sample\n",
+         SERIES_LEN, ITERATIONS, RAW_SAMPLE_SIZE);
+  ret |= run("temperature", gen_temperature);
+  ret |= run("jittered", gen_jittered);
+  ret |= run("counter", gen_counter);
+
+  return ret;
+}
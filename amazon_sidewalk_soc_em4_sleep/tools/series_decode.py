@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Zlib
+# Copyright 2023 Silicon Laboratories Inc. www.silabs.com
+"""Decode series reports produced by app_series_codec.c.
+
+Each input line holds one (reassembled) report payload in hex, optionally
+prefixed by a device identifier. Samples are printed as CSV:
+
+    device,timestamp,value
+
+Usage: series_decode.py [FILE]   (stdin when FILE is omitted)
+"""
+
+import sys
+
+SERIES_TYPE = 0x01
+VARINT_MAX = 5
+
+
+class _Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+        self.zero_run = 0
+
+    def varint(self):
+        result = 0
+        for shift in range(0, 7 * VARINT_MAX, 7):
+            if self.pos >= len(self.data):
+                raise ValueError("truncated varint")
+            byte = self.data[self.pos]
+            self.pos += 1
+            result |= (byte & 0x7F) << shift
+            if not byte & 0x80:
+                return result
+        raise ValueError("varint too long")
+
+    def token(self):
+        if self.zero_run:
+            self.zero_run -= 1
+            return 0
+        raw = self.varint()
+        if raw & 1:
+            self.zero_run = raw >> 1
+            return 0
+        return _zigzag_decode(raw >> 1)
+
+
+def _zigzag_decode(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def _s32(value):
+    value &= 0xFFFFFFFF
+    return value - (1 << 32) if value & 0x80000000 else value
+
+
+def decode(payload):
+    """Decode one series block into a list of (timestamp, value)."""
+    return decode_block(payload)[0]
+
+
+def decode_block(payload):
+    """Decode one series block, also return the offset right after it."""
+    if not payload or payload[0] != SERIES_TYPE:
+        raise ValueError("not a series block")
+    reader = _Reader(payload)
+    reader.pos = 1
+
+    count = reader.varint()
+    if count == 0:
+        return [], reader.pos
+    timestamps = [reader.varint() & 0xFFFFFFFF]
+    values = [_s32(_zigzag_decode(reader.varint()))]
+
+    delta = 0
+    for i in range(1, count):
+        token = reader.token()
+        delta = token if i == 1 else delta + token
+        timestamps.append((timestamps[-1] + delta) & 0xFFFFFFFF)
+    if reader.zero_run:
+        raise ValueError("zero run crosses sections")
+
+    for _ in range(1, count):
+        values.append(_s32(values[-1] + reader.token()))
+    if reader.zero_run:
+        raise ValueError("zero run past end")
+
+    return list(zip(timestamps, values)), reader.pos
+
+
+def main():
+    stream = open(sys.argv[1]) if len(sys.argv) > 1 else sys.stdin
+    print("device,timestamp,value")
+    for line in stream:
+        fields = line.split()
+        if not fields:
+            continue
+        device = fields[0] if len(fields) > 1 else ""
+        try:
+            samples = decode(bytes.fromhex(fields[-1]))
+        except ValueError as error:
+            print("skipped %s: %s" % (fields[-1], error), file=sys.stderr)
+            continue
+        for timestamp, value in samples:
+            print("%s,%d,%d" % (device, timestamp, value))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Zlib
+# Copyright 2023 Silicon Laboratories Inc. www.silabs.com
+"""Convert a `trace` CLI dump (app_trace.c) into Chrome/Perfetto trace JSON.
+
+Feed the RTT log containing the dump, open the output in chrome://tracing or
+https://ui.perfetto.dev:
+
+    trace_to_chrome.py rtt.log > trace.json
+
+Tracks:
+    power        awake periods and EM4 sleeps
+    main_thread  events dispatched by main_thread()
+    links        periods each link was started
+    sidewalk     status changes and messages (instant events)
+    inputs       requests from buttons, the CLI and timers (instant events)
+"""
+
+import json
+import re
+import struct
+import sys
+
+RECORD_RE = re.compile(r"trace: ([0-9a-fA-F]{16})\s*$")
+LEGEND_RE = re.compile(r"trace: event (\d+) (\S+)")
+
+BOOT, EVENT_BEGIN, EVENT_END, STATUS, LINK_START, LINK_STOP, \
+    MSG_SENT, MSG_ERROR, MSG_RECEIVED, EM4_ENTER, INPUT = range(1, 12)
+
+INPUTS = {1: "connect_and_send", 2: "send_counter_update", 3: "send_report",
+          4: "factory_reset", 5: "link_switch", 6: "connection_request",
+          7: "get_time", 8: "get_mtu", 9: "trace_dump", 10: "airtime_stats",
+          11: "em4_sleep", 12: "awake_lease", 13: "alarm", 14: "outbox_stats",
+          15: "supervisor_stats", 16: "send"}
+
+RADIO_SLEEP = {0: "none", 1: "warm", 2: "cold"}
+STATES = {0: "ready", 1: "not_ready", 2: "error", 3: "secure_channel_ready"}
+LINKS = {1: "BLE", 2: "FSK", 4: "CSS"}
+TRACKS = {"power": 1, "main_thread": 2, "links": 3, "sidewalk": 4, "inputs": 5}
+
+
+def parse(stream):
+    """Return (legend, records) from a log stream."""
+    legend = {}
+    records = []
+    for line in stream:
+        match = LEGEND_RE.search(line)
+        if match:
+            legend[int(match.group(1))] = match.group(2)
+            continue
+        match = RECORD_RE.search(line)
+        if match:
+            records.append(struct.unpack("<IBBH", bytes.fromhex(match.group(1))))
+    return legend, records
+
+
+def link_names(mask):
+    return [name for bit, name in LINKS.items() if mask & bit]
+
+
+def convert(legend, records):
+    events = [{"ph": "M", "name": "thread_name", "pid": 1, "tid": tid,
+               "args": {"name": name}} for name, tid in TRACKS.items()]
+
+    def add(ph, name, track, ts, **extra):
+        event = {"ph": ph, "name": name, "pid": 1, "tid": TRACKS[track], "ts": ts * 1000}
+        event.update(extra)
+        events.append(event)
+
+    awake_since = None
+    sleep_since = None
+    radio_sleep = 0
+    open_event = None
+    started_links = set()
+
+    for timestamp, kind, arg0, arg1 in records:
+        if kind == BOOT:
+            if sleep_since is not None:
+                add("X", "em4", "power", sleep_since, dur=(timestamp - sleep_since) * 1000,
+                    args={"radio": RADIO_SLEEP.get(radio_sleep, radio_sleep)})
+            elif awake_since is not None:
+                # Reset without going through EM4, close what was left open
+                add("E", "awake", "power", timestamp)
+            sleep_since = None
+            awake_since = timestamp
+            open_event = None
+            started_links.clear()
+            add("B", "awake", "power", timestamp, args={"reset_cause": "0x%04x" % arg1})
+        elif kind == EVENT_BEGIN:
+            open_event = legend.get(arg0, "event_%d" % arg0)
+            add("B", open_event, "main_thread", timestamp)
+        elif kind == EVENT_END:
+            if open_event is not None:
+                add("E", open_event, "main_thread", timestamp)
+                open_event = None
+        elif kind == STATUS:
+            add("i", "status " + STATES.get(arg0, str(arg0)), "sidewalk", timestamp, s="t",
+                args={"registered": not arg1 & 1, "time_synced": not (arg1 >> 1) & 1,
+                      "links_up": link_names(arg1 >> 4)})
+        elif kind == LINK_START:
+            for name in link_names(arg1):
+                started_links.add(name)
+                add("B", name, "links", timestamp)
+        elif kind == LINK_STOP:
+            for name in link_names(arg1):
+                if name in started_links:
+                    started_links.discard(name)
+                    add("E", name, "links", timestamp)
+        elif kind == MSG_SENT:
+            add("i", "msg sent", "sidewalk", timestamp, s="t",
+                args={"link": LINKS.get(arg0, arg0), "id": arg1})
+        elif kind == MSG_ERROR:
+            add("i", "msg error", "sidewalk", timestamp, s="t",
+                args={"error": arg0 - 256 if arg0 > 127 else arg0, "id": arg1})
+        elif kind == MSG_RECEIVED:
+            add("i", "msg received", "sidewalk", timestamp, s="t",
+                args={"link": LINKS.get(arg0, arg0), "size": arg1})
+        elif kind == INPUT:
+            add("i", INPUTS.get(arg0, "input_%d" % arg0), "inputs", timestamp, s="t",
+                args={"arg": arg1})
+        elif kind == EM4_ENTER:
+            if open_event is not None:
+                add("E", open_event, "main_thread", timestamp)
+                open_event = None
+            if awake_since is not None:
+                add("E", "awake", "power", timestamp)
+                awake_since = None
+            sleep_since = timestamp
+            radio_sleep = arg0
+
+    return {"traceEvents": events, "displayTimeUnit": "ms"}
+
+
+def main():
+    stream = open(sys.argv[1], errors="replace") if len(sys.argv) > 1 else sys.stdin
+    legend, records = parse(stream)
+    if not records:
+        sys.exit("no trace records found")
+    json.dump(convert(legend, records), sys.stdout, indent=1)
+    print()
+    awake = sum(1 for r in records if r[1] == BOOT)
+    print("%d records, %d boots" % (len(records), awake), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()